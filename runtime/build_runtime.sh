@@ -37,6 +37,7 @@ hidden_usage()
     echo "  -no_make                                Skip final make command for Klocwork"
     echo "  -polling                                Use polling instead of interrupts"
     echo "  -target_a10_pac                         Target the Arria 10 PAC [EOL 2024.1 Release]"
+    echo "  -target_mock_platform                   Target the mock MMD, a software model of the board for testing without an FPGA"
     echo "  -run_tests                              Runs short build tests. For Altera internal usage only."
     echo "  -glibc_header                           Force inclusion of glibc pinning header. "
     echo "                                          Use with caution if runtime binaries must be distributed to machines with differeing GLIBC versions"
@@ -113,6 +114,9 @@ for i in "$@"; do
         -hidden_help | --hidden_help )                  hidden_usage
                                                         exit
                                                         ;;
+        -target_mock_platform | --target_mock_platform ) PLATFORM_NAME="MOCK PLATFORM"
+                                                        BUILD_PLATFORM="-DHW_BUILD_PLATFORM=MOCK_PLATFORM"
+                                                        ;;
         -coredla_dir_cmake=* | --coredla_dir_cmake=* )  COREDLA_DIR_USER_CMAKE="${i#*=}"
                                                         shift
                                                         ;;
@@ -29,6 +29,7 @@
 
 #include <models/model_base.h>
 #include <models/results.h>
+#include <samples/pooled_tensor_allocator.hpp>
 #include <utils/config_factory.h>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
@@ -84,6 +85,17 @@ int64_t AsyncPipeline::submitData(const InputData& inputData, const std::shared_
         return -1;
     }
 
+    // Results of the previous inference of this request may still be waiting in completedInferenceResults and
+    // share the request's output tensors. Give the request new ones from the pool so they are not overwritten,
+    // the old buffers return to the pool once their results are processed.
+    for (const auto& output : compiledModel.outputs()) {
+        if (output.get_partial_shape().is_static()) {
+            const ov::Shape& shape = output.get_shape();
+            const size_t bytes = ov::shape_size(shape) * output.get_element_type().size();
+            request.set_tensor(output, ov::Tensor(output.get_element_type(), shape, PooledTensorAllocator(bytes)));
+        }
+    }
+
     auto startTime = std::chrono::steady_clock::now();
     auto internalModelData = model->preprocess(inputData, request);
     preprocessMetrics.update(startTime);
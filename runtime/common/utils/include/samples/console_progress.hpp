@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <iomanip>
 #include <sstream>
+#include <string>
 
 /**
  * @class ConsoleProgress
@@ -22,6 +23,8 @@ class ConsoleProgress {
     bool stream_output;
     size_t detalization;
     size_t percent_to_update;
+    std::string status;
+    size_t prev_status_size = 0;
 
 public:
     /**
@@ -60,6 +63,9 @@ public:
             strm << " ";
         }
         strm << "] " << std::setw(3) << 100 * cur_progress / total << "% done";
+        if (!status.empty()) {
+            strm << ", " << status;
+        }
         if (stream_output) {
             strm << std::endl;
         }
@@ -94,6 +100,19 @@ public:
         updateProgress();
     }
 
+    /**
+     * @brief Sets a text shown after the progress, e.g. a running metric. It is drawn with the next update.
+     * @param _status - text to show, empty to show nothing
+     */
+    void setStatus(const std::string& _status) {
+        // Pad over the previous text, since the line is redrawn in place
+        status = _status;
+        if (!stream_output && status.size() < prev_status_size) {
+            status.append(prev_status_size - status.size(), ' ');
+        }
+        prev_status_size = status.size();
+    }
+
     /**
      * @brief Output end line.
      * @return
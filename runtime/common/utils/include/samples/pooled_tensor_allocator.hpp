@@ -0,0 +1,92 @@
+// Copyright (C) 2018-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// @brief Recycles page aligned host buffers for tensors, keyed by their rounded up size.
+///
+/// Buffers are handed out as reference counted pointers. When the last reference is dropped the buffer goes back
+/// to the free list of its size, so creating tensors of the same shape over and over does not touch the heap.
+/// The pool is configured once from the environment:
+///   DLA_TENSOR_POOL_HUGE_PAGES   advise the kernel to back buffers of 2 MB or more with transparent huge pages
+///   DLA_TENSOR_POOL_LOCK_PAGES   lock buffers into physical memory (mlock) so they can be used for DMA
+///   DLA_TENSOR_POOL_MAX_CACHE_MB upper bound on the memory kept in the free lists (default 1024)
+class TensorBufferPool : public std::enable_shared_from_this<TensorBufferPool> {
+public:
+    struct Config {
+        bool huge_pages = false;
+        bool lock_pages = false;
+        size_t max_cached_bytes = size_t(1024) << 20;
+
+        static Config from_env();
+    };
+
+    /// @brief Process wide pool, configured from the environment on first use
+    static std::shared_ptr<TensorBufferPool> get_default();
+
+    static std::shared_ptr<TensorBufferPool> create(const Config& config);
+
+    ~TensorBufferPool();
+
+    /// @brief Returns a page aligned buffer of at least bytes bytes. A recycled buffer still holds whatever its
+    /// previous user wrote to it.
+    std::shared_ptr<char> acquire(size_t bytes);
+
+    /// @brief Bytes currently held in the free lists
+    size_t cached_bytes() const;
+
+private:
+    explicit TensorBufferPool(const Config& config);
+
+    size_t slab_size(size_t bytes) const;
+    size_t slab_alignment(size_t slab_bytes) const;
+    char* allocate_slab(size_t slab_bytes);
+    void free_slab(char* slab, size_t slab_bytes);
+    void release(char* slab, size_t slab_bytes);
+
+    Config _config;
+    size_t _page_size;
+
+    mutable std::mutex _mutex;
+    std::map<size_t, std::vector<char*>> _free_lists;  // slab size -> idle slabs of that size
+    size_t _cached_bytes = 0;
+};
+
+/// @brief ov::Tensor allocator handing out one pooled buffer.
+///
+/// Fill the buffer through get_buffer(), then pass the allocator to the ov::Tensor constructor. Copies of the
+/// allocator share the buffer instead of duplicating it, and the buffer returns to the pool once the tensor and
+/// every copy of the allocator are gone.
+class PooledTensorAllocator {
+public:
+    explicit PooledTensorAllocator(size_t size_bytes,
+                                   const std::shared_ptr<TensorBufferPool>& pool = TensorBufferPool::get_default())
+        : buffer(pool->acquire(size_bytes)),
+          size(size_bytes) {}
+
+    char* get_buffer() const {
+        return buffer.get();
+    }
+
+    void* allocate(size_t bytes, size_t) {
+        return bytes <= size ? buffer.get() : nullptr;
+    }
+
+    // The buffer is released together with the last copy of the allocator
+    void deallocate(void*, size_t, size_t) {}
+
+    bool is_equal(const PooledTensorAllocator& other) const noexcept {
+        return buffer == other.buffer;
+    }
+
+private:
+    std::shared_ptr<char> buffer;
+    size_t size;
+};
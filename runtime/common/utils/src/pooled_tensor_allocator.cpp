@@ -0,0 +1,147 @@
+// Copyright (C) 2018-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// clang-format off
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "samples/pooled_tensor_allocator.hpp"
+// clang-format on
+
+namespace {
+constexpr size_t huge_page_size = size_t(2) << 20;
+
+bool env_flag(const char* name) {
+    const char* value = std::getenv(name);
+    return value != nullptr && value[0] != '\0' && value[0] != '0';
+}
+}  // namespace
+
+TensorBufferPool::Config TensorBufferPool::Config::from_env() {
+    Config config;
+    config.huge_pages = env_flag("DLA_TENSOR_POOL_HUGE_PAGES");
+    config.lock_pages = env_flag("DLA_TENSOR_POOL_LOCK_PAGES");
+    if (const char* max_cache_mb = std::getenv("DLA_TENSOR_POOL_MAX_CACHE_MB")) {
+        config.max_cached_bytes = static_cast<size_t>(std::strtoull(max_cache_mb, nullptr, 10)) << 20;
+    }
+    return config;
+}
+
+std::shared_ptr<TensorBufferPool> TensorBufferPool::get_default() {
+    static const std::shared_ptr<TensorBufferPool> pool = create(Config::from_env());
+    return pool;
+}
+
+std::shared_ptr<TensorBufferPool> TensorBufferPool::create(const Config& config) {
+    return std::shared_ptr<TensorBufferPool>(new TensorBufferPool(config));
+}
+
+TensorBufferPool::TensorBufferPool(const Config& config) : _config(config) {
+#ifdef _WIN32
+    _page_size = 4096;
+#else
+    _page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+TensorBufferPool::~TensorBufferPool() {
+    // Buffers still in use hold a reference to the pool, so everything left is idle
+    for (auto& free_list : _free_lists) {
+        for (char* slab : free_list.second) {
+            free_slab(slab, free_list.first);
+        }
+    }
+}
+
+size_t TensorBufferPool::slab_size(size_t bytes) const {
+    const size_t granule = (_config.huge_pages && bytes >= huge_page_size) ? huge_page_size : _page_size;
+    return ((bytes + granule - 1) / granule) * granule;
+}
+
+size_t TensorBufferPool::slab_alignment(size_t slab_bytes) const {
+    return (_config.huge_pages && slab_bytes >= huge_page_size) ? huge_page_size : _page_size;
+}
+
+char* TensorBufferPool::allocate_slab(size_t slab_bytes) {
+    void* slab = nullptr;
+#ifdef _WIN32
+    slab = _aligned_malloc(slab_bytes, slab_alignment(slab_bytes));
+    if (slab == nullptr) {
+        throw std::bad_alloc();
+    }
+#else
+    if (posix_memalign(&slab, slab_alignment(slab_bytes), slab_bytes) != 0) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (_config.huge_pages && slab_bytes >= huge_page_size) {
+        // Only a hint, the kernel may not have transparent huge pages enabled
+        madvise(slab, slab_bytes, MADV_HUGEPAGE);
+    }
+#endif
+    if (_config.lock_pages) {
+        // Best effort, fails when RLIMIT_MEMLOCK is too small
+        mlock(slab, slab_bytes);
+    }
+#endif
+    return static_cast<char*>(slab);
+}
+
+void TensorBufferPool::free_slab(char* slab, size_t slab_bytes) {
+#ifdef _WIN32
+    (void)slab_bytes;
+    _aligned_free(slab);
+#else
+    if (_config.lock_pages) {
+        munlock(slab, slab_bytes);
+    }
+    free(slab);
+#endif
+}
+
+std::shared_ptr<char> TensorBufferPool::acquire(size_t bytes) {
+    const size_t slab_bytes = slab_size(bytes == 0 ? 1 : bytes);
+    char* slab = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _free_lists.find(slab_bytes);
+        if (it != _free_lists.end() && !it->second.empty()) {
+            slab = it->second.back();
+            it->second.pop_back();
+            _cached_bytes -= slab_bytes;
+        }
+    }
+    if (slab == nullptr) {
+        slab = allocate_slab(slab_bytes);
+    }
+    // The deleter keeps the pool alive for as long as any of its buffers is in use
+    std::shared_ptr<TensorBufferPool> self = shared_from_this();
+    return std::shared_ptr<char>(slab, [self, slab_bytes](char* p) {
+        self->release(p, slab_bytes);
+    });
+}
+
+void TensorBufferPool::release(char* slab, size_t slab_bytes) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cached_bytes + slab_bytes <= _config.max_cached_bytes) {
+            _free_lists[slab_bytes].push_back(slab);
+            _cached_bytes += slab_bytes;
+            return;
+        }
+    }
+    free_slab(slab, slab_bytes);
+}
+
+size_t TensorBufferPool::cached_bytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cached_bytes;
+}
@@ -14,6 +14,10 @@
 #ifndef BATCH_JOB_H
 #define BATCH_JOB_H
 
+#include <cstdint>    // uint64_t
+#include <future>     // std::future
+#include <stdexcept>  // std::runtime_error
+
 class BatchJob {
  public:
   // @param inputArray - ptr to CPU array containing input data to be copied to DDR
@@ -23,8 +27,29 @@ class BatchJob {
   // outputArray must be allocated by the caller (size >= output_size_ddr)
   // blocking function
   virtual void ReadOutputFeatureFromDDR(void* outputArray) const = 0;
+  // Non-blocking versions of the above, the future becomes ready once the transfer has completed
+  // and the array must stay valid until then. Unlike LoadInputFeatureToDDR, the async load does
+  // not start DLA, call StartDla once the returned future is ready.
+  virtual std::future<void> LoadInputFeatureToDDRAsync(void* /*inputArray*/) {
+    throw std::runtime_error("Asynchronous input transfer is not supported by this device");
+  }
+  virtual std::future<void> ReadOutputFeatureFromDDRAsync(void* outputArray) const {
+    // Devices without an async path perform the blocking transfer
+    std::promise<void> done;
+    ReadOutputFeatureFromDDR(outputArray);
+    done.set_value();
+    return done.get_future();
+  }
+  // Where the input and output of this batch live in device memory, if the device memory is mapped into the process.
+  // Filling the input buffer in place and passing it to LoadInputFeatureToDDR (or the output buffer to
+  // ReadOutputFeatureFromDDR, or to the async versions) replaces the copy by cache maintenance. nullptr if the device
+  // memory is not mapped, then pass a host buffer as usual and the data is copied.
+  virtual void* GetMappedInputFeature() { return nullptr; }
+  virtual void* GetMappedOutputFeature() { return nullptr; }
   virtual void ScheduleInputFeature() const = 0;
   virtual void StartDla() = 0;
+  // Id of the job most recently started by StartDla, pass it to Device::WaitForDlaJob. 0 if the device has no job ids.
+  virtual uint64_t GetJobId() const { return 0; }
   virtual ~BatchJob() {}
 };
 
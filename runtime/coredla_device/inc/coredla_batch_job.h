@@ -20,7 +20,9 @@
 // #include "dla_types.h"
 // #include "compiled_result_runtime_required_elements.h"
 
+#include <atomic>   // std::atomic
 #include <cstdint>  // uint64_t
+#include <future>   // std::future
 #include <memory>   // std::unique_ptr
 
 class StreamControllerComms;
@@ -43,10 +45,15 @@ class CoreDlaBatchJob : public BatchJob {
   uint64_t outputSizeDDR_;
   const bool enableIstream_;
   const bool enableOstream_;
+  // per-instance count of jobs started, owned by CoreDlaDevice, and the ticket of the last job this object started
+  std::atomic<uint64_t>* jobsSubmitted_;
   uint64_t lastJobQueueNumber_;
 
   std::shared_ptr<StreamControllerComms> spStreamControllerComms_;
 
+  // Where a buffer of this batch is in the mapped device memory, nullptr if the device memory is not mapped
+  void* GetMappedFeature(uint64_t addrDDR, uint64_t sizeDDR) const;
+
   CoreDlaBatchJob(MmdWrapper* mmdWrapper,
                   uint64_t totalConfigWords,
                   uint64_t configBaseAddrDDR,
@@ -57,6 +64,7 @@ class CoreDlaBatchJob : public BatchJob {
                   const bool enableIstream,
                   const bool enableOstream,
                   int instance,
+                  std::atomic<uint64_t>* jobsSubmitted,
                   std::shared_ptr<StreamControllerComms> spStreamControllerComms);
 
  public:
@@ -73,6 +81,7 @@ class CoreDlaBatchJob : public BatchJob {
                                               const bool enableIstream,
                                               const bool enableOstream,
                                               int instance,
+                                              std::atomic<uint64_t>* jobsSubmitted,
                                               std::shared_ptr<StreamControllerComms> spStreamControllerComms);
   // @param inputArray - ptr to CPU array containing input data tp be copied to DDR
   // blocking function
@@ -81,8 +90,24 @@ class CoreDlaBatchJob : public BatchJob {
 
   // Starts DLA by writing to CSR in DLA DMA; the DDR addresses of graph config and input data
   void StartDla() override;
+  // Ticket of the last job started by StartDla, for CoreDlaDevice::WaitForDlaJob
+  uint64_t GetJobId() const override { return lastJobQueueNumber_; }
   // @param outputArray - ptr to CPU array where the output data in DDR is copied into
   // outputArray must be allocated by the caller (size >= output_size_ddr)
   // blocking function
   void ReadOutputFeatureFromDDR(void* outputArray) const override;
+  // Non-blocking versions, see BatchJob
+  std::future<void> LoadInputFeatureToDDRAsync(void* inputArray) override;
+  std::future<void> ReadOutputFeatureFromDDRAsync(void* outputArray) const override;
+  // Addresses of the input/output buffers in the mapped device memory, see BatchJob
+  void* GetMappedInputFeature() override;
+  void* GetMappedOutputFeature() override;
+
+  // Called by CoreDlaGraphJob when the device memory allocator has moved the graph's buffers during compaction
+  // Must be called when there are no active jobs on DLA
+  void RelocateConfigBuffer(uint64_t configBaseAddrDDR) { configBaseAddrDDR_ = configBaseAddrDDR; }
+  void RelocateInputOutputBuffer(uint64_t inputAddrDDR, uint64_t outputAddrDDR) {
+    inputAddrDDR_ = inputAddrDDR;
+    outputAddrDDR_ = outputAddrDDR;
+  }
 };
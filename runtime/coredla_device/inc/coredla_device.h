@@ -19,6 +19,8 @@
 #include "graph_job.h"                //GraphJob
 #include "mmd_wrapper.h"              //MmdWrapper
 
+#include <atomic>              //std::atomic
+#include <chrono>              //std::chrono::nanoseconds
 #include <condition_variable>  //std::condition_variable
 #include <cstdint>             //uint64_t
 #include <map>                 //std::map
@@ -29,20 +31,41 @@
 class StreamControllerComms;
 
 // The interface of the interrupt service routine dictates that all the data the ISR needs must be passed in through
-// one pointer of type void *. Package it up here. WaitForDla() uses jobsWaited and jobsFinished to determine if a job
-// has already finished or it still needs wait. The ISR only updates jobsFinished, so jobsWaited is only a member of
-// CoreDlaDevice. The mutex and condition variable are used to synchronize between InterruptServiceRoutine() and
-// WaitForDla(). All of these are replicated per CoreDLA IP instance, hence the use of vector.
+// one pointer of type void *. Package it up here. Jobs are identified by ticket numbers: StartDla() takes the next
+// ticket from jobsSubmitted, and a job has finished once jobsFinished has reached its ticket. The ISR (or WaitForDla()
+// when polling) is the only writer of jobsFinished, which is atomic so that checking for a finished job takes no lock.
+// A thread that has to sleep registers its own condition variable in waiters under the ticket it waits for, and the
+// ISR only wakes the threads whose job has finished, so any number of threads can wait on the same instance. All of
+// these are replicated per CoreDLA IP instance, hence the use of vector.
 // base_multiplier and prevCount are used to handle the jobsFinished wrap-around that could happen in the hardware CSR
 // as the CSR is only 32-bit wide but the jobsFinished is 64-bit wide
+// isrJobsFinished is the completion count as last seen by the ISR, which uses it to skip instances with no job outstanding
 struct InterruptServiceRoutineData {
   MmdWrapper* mmdWrapper;
-  std::vector<uint64_t> jobsFinished;
+  std::vector<std::atomic<uint64_t>> jobsFinished;
+  std::vector<std::atomic<uint64_t>> jobsSubmitted;
   std::vector<uint32_t> base_multiplier;
   std::vector<uint32_t> prevCount;
-  std::vector<uint32_t> desc_queue_diag;
-  std::vector<std::mutex> isrMutex;
-  std::vector<std::condition_variable> isrCondVar;
+  std::vector<uint64_t> isrJobsFinished;
+  std::vector<std::atomic<uint32_t>> desc_queue_diag;
+  std::vector<std::mutex> waiterMutex;
+  std::vector<std::multimap<uint64_t, std::condition_variable*>> waiters;
+};
+
+// How WaitForDla() learns that a job has finished. The default comes from COREDLA_RUNTIME_POLLING at compile time and
+// can be overridden with the COREDLA_RUNTIME_COMPLETION_MODE environment variable (interrupt, polling or adaptive).
+// Adaptive keeps the interrupt enabled but first spins on the completion count for about the time of one job, which
+// saves the interrupt latency on small graphs without burning a core on large ones.
+enum class CompletionMode { INTERRUPT, POLLING, ADAPTIVE };
+
+// Per instance counters of which path noticed that a job finished, plus the current adaptive spin window
+struct CompletionStats {
+  std::atomic<uint64_t> alreadyFinished{0};         // job had finished before WaitForDla() was called
+  std::atomic<uint64_t> finishedWhilePolling{0};    // found by polling the CSR, including the adaptive spin
+  std::atomic<uint64_t> finishedAfterInterrupt{0};  // had to sleep until the ISR woke us up
+  std::atomic<uint64_t> spinWindowNs{0};  // average time of one job, capped by COREDLA_RUNTIME_MAX_SPIN_US
+  std::atomic<uint64_t> spinWindowUpdatedAtJob{0};
+  std::mutex spinWindowMutex;
 };
 
 /*! DlaDevice class represents a DLA device mapped using the MMD + OPAE SW stack
@@ -66,9 +89,15 @@ class CoreDlaDevice : public Device {
                            // HW runtime does not.
                            const std::string export_dir,
                            const std::string parameter_rom_export_dir);
+  // Destroys the graph job, its config/filter and input/output buffers go back to the free list of the allocator
+  // Must be called when there are no active jobs of this graph on DLA
+  void ReleaseGraphJob(GraphJob* graphJob) override;
+  // Relocates the buffers of the graphs on this instance so that the free DDR becomes one contiguous block
+  // Must be called when there are no active jobs on DLA
+  void CompactDeviceMemory(int instance) override;
   // Return number of DLA jobs completed till now
   // Used for debugging
-  int GetNumInferencesCompleted(int instance) const override { return isrData_.jobsFinished.at(instance); }
+  int GetNumInferencesCompleted(int instance) const override { return isrData_.jobsFinished.at(instance).load(); }
   // Must be called when there are no active jobs on DLA
   // Returns the total time taken by DLA jobs on hardware (in milliseconds)
   double GetActiveHWTimeMs(int instance) const override;
@@ -85,8 +114,18 @@ class CoreDlaDevice : public Device {
   // Must be called when there are no active jobs on DLA
   // Returns the number of memory writes made by the output feature writer
   uint64_t GetNumOutputFeatureMemoryWrites(int instance) const override;
+  // Returns how often each completion path fired on this instance, see CompletionStats
+  DebugNetworkData GetCompletionStats(int instance) const override;
 
  private:
+  // Sleep (interrupts) or poll the CSR until job ticket jobId has finished on this instance, thread safe
+  void WaitForTicket(int instance, uint64_t jobId, size_t threadId, const std::function<bool()>& isCancelled);
+  // Read the completion count from the CSR and advance jobsFinished if it has moved, thread safe
+  void PollCompletionCount(int instance);
+  // How long adaptive mode spins on the completion count for a ticket jobsAhead jobs away before sleeping until the
+  // interrupt
+  std::chrono::nanoseconds GetSpinWindow(int instance, uint64_t jobsAhead);
+
   // Read one 32-bit value from the debug network, return value indicates whether read was successful. A read can fail
   // if the module number and address have not been implemented. The debug network is fault tolerant to both read
   // requests never being accepted as well as read responses never being produced.
@@ -120,6 +159,7 @@ class CoreDlaDevice : public Device {
   double GetCoreDlaClockFreq() const override;
   int GetNumInstances() const override { return numInstances_; }
   void WaitForDla(int instance, size_t threadId = 0, std::function<bool()> isCancelled = nullptr) override;  // threadId is optional and for debugging purpose only
+  void WaitForDlaJob(int instance, uint64_t jobId, size_t threadId = 0, std::function<bool()> isCancelled = nullptr) override;
   std::string SchedulerGetStatus() const override;
   bool InitializeScheduler(uint32_t sourceBufferSize, uint32_t dropSourceBuffers, uint32_t numInferenceRequests,
                            const std::string source_fifo_file="") override;
@@ -130,7 +170,11 @@ class CoreDlaDevice : public Device {
   int numInstances_;
   MmdWrapper mmdWrapper_;
   InterruptServiceRoutineData isrData_;
-  std::vector<uint64_t> jobsWaited_;
+  // Tickets handed out by WaitForDla() to callers that do not say which job they wait for
+  std::vector<std::atomic<uint64_t>> jobsWaited_;
+  // Value of jobsFinished when the device was opened, the hardware counters are relative to the same point
+  std::vector<uint64_t> startJobsFinished_;
+  std::unique_ptr<CompletionStats[]> completionStats_;
 #ifndef USE_OLD_COREDLA_DEVICE
   std::vector<uint64_t> startClocksActive;
   std::vector<uint64_t> startClockAllJobs;
@@ -139,6 +183,10 @@ class CoreDlaDevice : public Device {
   std::vector<uint64_t> startNumFilterMemoryReads;
   std::vector<uint64_t> startNumOutputFeatureMemoryWrites;
   std::shared_ptr<StreamControllerComms> spStreamControllerComms_;
-  bool runtimePolling_;
+  CompletionMode completionMode_;
+  uint32_t maxSpinUs_;
   uint32_t waitForDlaTimeoutSeconds_;
+
+  // The regression tests on the mock board run batch jobs without a compiled graph, which needs the MMD and tickets
+  friend struct CoreDlaDeviceTestAccess;
 };
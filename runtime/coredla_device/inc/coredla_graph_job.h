@@ -24,6 +24,7 @@
 //#include "dla_types.h"
 //#include "compiled_result_runtime_required_elements.h"
 
+#include <atomic>   //std::atomic
 #include <cstdint>  //uint64_t
 #include <memory>   //std::unique_ptr
 #include <mutex>    //std::mutex
@@ -49,18 +50,26 @@ class CoreDlaGraphJob : public GraphJob {
   // placed
   // @param outputSizeDDR - size of one batch output data in DDR
   // @param numPipelines - number of I/O bufffer pairs created for CPU-FPGA pipelining of multiple batch runs
+  // @param jobsSubmitted - per-instance count of jobs started, used to give each batch job a ticket for WaitForDlaJob
   // @param spStreamControllerComms - optional interface to stream controller
   static std::unique_ptr<GraphJob> MakeUnique(DeviceMemoryAllocator* ddrBufferAllocator,
                                               MmdWrapper* mmdWrapper,
                                               const dla::CompiledResult* compiled_result,
                                               uint64_t numPipelines,
                                               int instance,
+                                              std::atomic<uint64_t>* jobsSubmitted,
                                               std::shared_ptr<StreamControllerComms> spStreamControllerComms);
   // Returns an unused batch job object
   // If all batch jobs are used, returns null
   // Increments batchJobsRequested_
   // Thread safe
   BatchJob* GetBatchJob();
+  // Returns the graph's buffers to the device memory allocator
+  ~CoreDlaGraphJob();
+  // Called when the device memory allocator has moved the buffer at oldAddr to newAddr during compaction of the DDR
+  // of the given instance. Does nothing if the buffer does not belong to this graph.
+  // Must be called when there are no active jobs on DLA
+  void RelocateBuffer(int instance, uint64_t oldAddr, uint64_t newAddr);
   CoreDlaGraphJob(const GraphJob&) = delete;
   CoreDlaGraphJob(CoreDlaGraphJob&) = delete;
   CoreDlaGraphJob& operator=(const CoreDlaGraphJob&) = delete;
@@ -68,6 +77,11 @@ class CoreDlaGraphJob : public GraphJob {
  private:
   uint64_t configFilterBiasBufferSizeDDR_;
   uint64_t intermediateBufferSizeDDR_;
+  // where the allocator placed the config/filter buffer and the input/output buffers of all pipelines
+  uint64_t configFilterBufferAddr_;
+  uint64_t inputOutputBufferAddr_;
+  uint64_t inputSizeDDR_;
+  uint64_t outputSizeDDR_;
   DeviceMemoryAllocator* ddrBufferAllocator_;
   MmdWrapper* mmdWrapper_;
   std::vector<std::unique_ptr<BatchJob>> batchJobs_;
@@ -79,5 +93,6 @@ class CoreDlaGraphJob : public GraphJob {
                   const dla::CompiledResult* compiledResult,
                   uint64_t numPipelines,
                   int instance,
+                  std::atomic<uint64_t>* jobsSubmitted,
                   std::shared_ptr<StreamControllerComms> spStreamControllerComms);
 };
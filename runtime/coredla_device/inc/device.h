@@ -50,6 +50,13 @@ class Device {
                                    bool encryption_enabled,
                                    const std::string export_dir,
                                    const std::string parameter_rom_export_dir) = 0;
+  // Unload a graph created by CreateGraphJob and give its device memory back, graphJob must not be used afterwards
+  // Must be called when there are no active jobs of this graph on DLA
+  // Devices that do not manage device memory keep the graph until the device is destroyed
+  virtual void ReleaseGraphJob(GraphJob* graphJob) { (void)graphJob; }
+  // Move the buffers of the loaded graphs together so that the free device memory becomes contiguous
+  // Must be called when there are no active jobs on DLA
+  virtual void CompactDeviceMemory(int instance) { (void)instance; }
   // Return number of DLA jobs completed till now
   // Used for debugging
   virtual int GetNumInferencesCompleted(int instance) const = 0;
@@ -71,6 +78,20 @@ class Device {
   virtual uint64_t GetNumOutputFeatureMemoryWrites(int instance) const = 0;
   // Waits for a job to finish on specified instance
   virtual void WaitForDla(int instance, size_t threadId = 0, std::function<bool()> isCancelled = nullptr) = 0;
+  // Waits for the job with the given id to finish, see BatchJob::GetJobId(). Unlike WaitForDla, several threads can
+  // each wait for their own job on the same instance. Devices without job ids wait for the next job instead.
+  virtual void WaitForDlaJob(int instance,
+                             uint64_t jobId,
+                             size_t threadId = 0,
+                             std::function<bool()> isCancelled = nullptr) {
+    (void)jobId;
+    WaitForDla(instance, threadId, isCancelled);
+  }
+  // Returns counters of how WaitForDla learnt that jobs finished on the specified instance, used for debugging
+  virtual DebugNetworkData GetCompletionStats(int instance) const {
+    (void)instance;
+    return {};
+  }
   virtual int GetNumInstances() const = 0;
   virtual double GetCoreDlaClockFreq() const = 0;
   virtual int GetSizeCsrDescriptorQueue() const = 0;
@@ -11,11 +11,16 @@
 // or implied warranties, other than those that are expressly stated in the
 // License.
 
+
 #pragma once
 
 #include "mmd_wrapper.h"  //MmdWrapper
 
-#include <cstdint>  //uint64_t
+#include <cstdint>     //uint64_t
+#include <functional>  //std::function
+#include <map>         //std::map
+#include <set>         //std::multiset
+#include <tuple>       //std::tuple
 
 /*! DeviceMemoryAllocator class allocates multiple DLA graph buffers in DDR
  * Each graph is expected to have one contigous buffer containing all data (config, filter, bias, I/O)
@@ -23,6 +28,10 @@
  * A scratchpad space is allocated in DDR to be shared across all graphs for intermediate feature data
  * This intermediate buffer space is allocated from left to right (starting address is 0)
  * and is expanded based on graph's requirement
+ * Graph buffers can be freed individually, the freed space is kept in a free list where adjacent blocks are merged,
+ * so that a graph can be unloaded and a new one loaded without clearing the whole DDR
+ * Graph constants (config, filter, bias, scale) that are byte-identical between graphs are stored once and reference
+ * counted, e.g. several copies of the same model or variants that share a backbone
  */
 class DeviceMemoryAllocator {
  public:
@@ -35,6 +44,10 @@ class DeviceMemoryAllocator {
   // @param instance - there can be multiple instances of DLA on FPGA, specify which DLA instance is this buffer for
   void AllocateSharedBuffer(uint64_t bufferSize, int instance);
 
+  // Drop one graph's requirement on the shared buffer, bufferSize must match an earlier call to AllocateSharedBuffer.
+  // The shared buffer shrinks to the largest size still required, which leaves more room for private buffers.
+  void FreeSharedBuffer(uint64_t bufferSize);
+
   // Buffers that are private to one graph will not change in size after allocation. The config/filter buffer is
   // an example of this. We have decided to allocate this at the upper address and allocate downwards from there.
   // Hardware requires the starting address of each buffer to have some alignment, and the allocator will add
@@ -45,17 +58,69 @@ class DeviceMemoryAllocator {
   // @param bufferAddr - the allocator indicates where it placed this buffer
   void AllocatePrivateBuffer(uint64_t bufferSize, uint64_t bufferAlignment, uint64_t &bufferAddr);
 
+  // Return a private buffer to the free list, bufferAddr must have come from AllocatePrivateBuffer.
+  // Buffers of size 0 take no space and do not need to be freed.
+  void FreePrivateBuffer(uint64_t bufferAddr);
+
+  // Same as AllocatePrivateBuffer for a buffer of graph constants, except that if a buffer with identical content,
+  // size and alignment is already allocated then that buffer is shared instead of allocating a new one. Identical
+  // content is detected with a 128-bit hash of the data.
+  // @param bufferData - the host copy of the constants, only used to compute the hash
+  // @return true if a new buffer was allocated and the caller must write the constants to it, false if the buffer is
+  // shared with another graph and already holds the constants
+  bool AllocateConstantBuffer(const void *bufferData, uint64_t bufferSize, uint64_t bufferAlignment, uint64_t &bufferAddr);
+
+  // Drop one reference to a buffer from AllocateConstantBuffer, the buffer is freed once no graph uses it
+  void FreeConstantBuffer(uint64_t bufferAddr);
+
+  // Move all private buffers as high up in DDR as possible so that the free space becomes one contiguous block.
+  // The data is moved with MmdWrapper::CopyDDR, then relocate is called with the old and new address of each buffer
+  // that moved so that the owner can update the addresses it gives to the hardware.
+  // Must be called when there are no active jobs on DLA
+  // @param instance - the DLA instance that owns this DDR
+  // @param relocate - called once for each buffer that moved
+  void Compact(int instance, const std::function<void(uint64_t oldAddr, uint64_t newAddr)> &relocate);
+
+  // Total size of the free blocks above the intermediate buffer, and the size of the largest one. If the largest free
+  // block is much smaller than the total then the DDR is fragmented and Compact() will help.
+  uint64_t GetFreeSize() const;
+  uint64_t GetLargestFreeBlockSize() const;
+
   // Clears whole DDR space including the intermediate buffer
   void Clear();
 
  private:
+  struct PrivateBuffer {
+    uint64_t size;       // requested size
+    uint64_t alignment;  // requested alignment, needed to move the buffer during compaction
+    uint64_t blockSize;  // size taken from the free list, includes the alignment padding above the buffer
+  };
+
+  // Identifies the content of a constant buffer: two 64-bit hashes, size and alignment
+  using ConstantBufferKey = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>;
+  struct ConstantBuffer {
+    ConstantBufferKey key;
+    uint32_t refCount;
+  };
+
+  // Lowest address that private buffers are allowed to use
+  uint64_t PrivateSpaceStart() const { return currentIntermediateMaxBufferSizeAllocated_; }
+  // Add a block to the free list and merge it with its neighbors
+  void InsertFreeBlock(uint64_t addr, uint64_t size);
+
   // total DDR size (BSP parameter)
-  uint64_t totalGlobalMemSize_;
+  uint64_t totalGlobalMemSize_ = 0;
   // For access to MMD
-  MmdWrapper *mmdWrapper_;
-  // current starting address of allocated graph buffer region
-  // graph buffers are allocated right to left
-  uint64_t currentStartAddressGraphBufferSpace_;
+  MmdWrapper *mmdWrapper_ = nullptr;
+  // free blocks of DDR, starting address -> size, adjacent blocks are always merged
+  std::map<uint64_t, uint64_t> freeBlocks_;
+  // allocated graph buffers, starting address -> buffer
+  std::map<uint64_t, PrivateBuffer> privateBuffers_;
+  // private buffers that hold graph constants, starting address -> buffer, and the lookup by content
+  std::map<uint64_t, ConstantBuffer> constantBuffers_;
+  std::map<ConstantBufferKey, uint64_t> constantBufferAddrs_;
+  // sizes requested for the intermediate buffer by each graph
+  std::multiset<uint64_t> sharedBufferSizes_;
   // current maximum allocated size for intermediate data
-  uint64_t currentIntermediateMaxBufferSizeAllocated_;
+  uint64_t currentIntermediateMaxBufferSizeAllocated_ = 0;
 };
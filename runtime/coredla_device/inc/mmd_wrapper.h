@@ -13,8 +13,16 @@
 
 #pragma once
 
-#include <cstdint>  //uint32_t
+#include <condition_variable>  // std::condition_variable
+#include <cstdint>             // uint32_t
+#include <deque>               // std::deque
+#include <functional>          // std::function
+#include <future>              // std::future
+#include <map>                 // std::map
+#include <mutex>               // std::mutex
 #include <string>
+#include <thread>              // std::thread
+#include <utility>             // std::pair
 
 using interrupt_service_routine_signature = void (*)(int handle, void *data);
 
@@ -44,10 +52,44 @@ class MmdWrapper {
   void WriteToCsr(int instance, uint32_t addr, uint32_t data) const;
   uint32_t ReadFromCsr(int instance, uint32_t addr) const;
 
+  // Same as WriteToCsr, but the write is skipped if the last value written to this register through WriteToCsrCached
+  // was data. Only for registers that simply hold their value, never for registers where the write itself has an
+  // effect (INPUT_OUTPUT_BASE_ADDR starts a job, INTERRUPT_CONTROL is write 1 to clear). Do not mix with WriteToCsr
+  // on the same register, WriteToCsr does not update the shadow copy.
+  void WriteToCsrCached(int instance, uint32_t addr, uint32_t data) const;
+  // Forget the shadow copies of an instance. Needed whenever something else may have written the registers: at device
+  // init (the IP may have been reset or reprogrammed) and once the stream controller firmware starts scheduling
+  void InvalidateCsrCache(int instance) const;
+
+  // Several CSR accesses to one instance, performed in the order given. Backends where every access is a round trip
+  // to the board (system console) send the whole batch at once.
+  void WriteToCsrBatch(int instance, const uint32_t *addrs, const uint32_t *data, size_t count) const;
+  void ReadFromCsrBatch(int instance, const uint32_t *addrs, uint32_t *data, size_t count) const;
+
   // Copy data between host and device memory
   void WriteToDDR(int instance, uint64_t addr, uint64_t length, const void *data) const;
   void ReadFromDDR(int instance, uint64_t addr, uint64_t length, void *data) const;
 
+  // Non-blocking versions of WriteToDDR / ReadFromDDR. The returned future becomes ready once the
+  // transfer has completed and get() rethrows any transfer error. The host buffer must stay valid
+  // until then. Writes issued from one thread complete in the order they were issued, and so do reads. A read
+  // and a write may complete in either order (dcp_a10_pac runs them on separate DMA threads), so wait for the
+  // future of a write before reading back the same range.
+  std::future<void> WriteToDDRAsync(int instance, uint64_t addr, uint64_t length, const void *data) const;
+  std::future<void> ReadFromDDRAsync(int instance, uint64_t addr, uint64_t length, void *data) const;
+
+  // Copy data within the device memory of one instance, the source and destination ranges may overlap.
+  // Uses the device DMA if the MMD supports it, otherwise the data makes a round trip through the host.
+  void CopyDDR(int instance, uint64_t dstAddr, uint64_t srcAddr, uint64_t length) const;
+
+  // Device memory of the instance mapped into the process, nullptr if the MMD cannot map it. Address 0 of the
+  // instance is at the returned pointer, length is the size of the mapping from there.
+  void *GetMappedDDR(int instance, uint64_t &length) const;
+  // Cache maintenance of a range of the mapping, replaces WriteToDDR and ReadFromDDR for data that the host reads and
+  // writes in place. toDevice after the host wrote the range and before the FPGA reads it, cleared after the FPGA
+  // wrote the range and before the host reads it.
+  void SyncMappedDDR(int instance, uint64_t addr, uint64_t length, bool toDevice) const;
+
   // If the mmd layer supports accesses to the STREAM CONTROLLER
   bool bIsStreamControllerValid(int instance) const;
 
@@ -66,10 +108,26 @@ class MmdWrapper {
   void disableCSRLogger();
 
  private:
+  // MMDs without an asynchronous DMA path run the async transfers on this worker thread,
+  // which is only started by the first async transfer
+  std::future<void> EnqueueDdrTransfer(std::function<void()> transfer) const;
+  void DdrTransferThread() const;
+
   int handle_;
   int maxInstances_;
   uint64_t ddrSizePerInstance_;
   double coreDlaClockFreq_;
   double ddrClockFreq_;
   MmdLogLevel logLevel_;
+
+  // Last value written by WriteToCsrCached, keyed by (instance, CSR address)
+  mutable std::mutex csrShadowMutex_;
+  mutable std::map<std::pair<int, uint32_t>, uint32_t> csrShadow_;
+
+  mutable std::once_flag ddrTransferThreadStarted_;
+  mutable std::thread ddrTransferThread_;
+  mutable std::mutex ddrTransferMutex_;
+  mutable std::condition_variable ddrTransferCondVar_;
+  mutable std::deque<std::packaged_task<void()>> ddrTransferQueue_;
+  mutable bool ddrTransferStop_ = false;
 };
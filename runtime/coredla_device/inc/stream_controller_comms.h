@@ -12,6 +12,7 @@
 // License.
 
 #pragma once
+#include <deque>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -24,39 +25,25 @@ struct Payload : public T {
   size_t GetSize() { return sizeof(*this); }
 };
 
-class BusyFlag {
- public:
-  bool Lock();
-  void Release();
-
- private:
-  std::recursive_mutex _mutex;
-  bool _busy = false;
-};
-
-class BusyCheck {
- public:
-  BusyCheck(BusyFlag& busyFlag);
-  ~BusyCheck();
-  operator bool();
-
- private:
-  BusyFlag& _busyFlag;
-  bool _haveLocked;
-};
-
 class StreamControllerComms {
  public:
   StreamControllerComms();
   bool IsPresent();
   Payload<StatusMessagePayload> GetStatus();
   std::string GetStatusString(Payload<StatusMessagePayload>& statusPayload);
+  // Queues the items and sends everything queued, in ScheduleItems messages of up to
+  // MaxScheduleItemsPerMessage jobs, waiting for the mailbox if another message is in flight.
+  // If another thread is already sending, the items go out with its next message and this call
+  // returns true right away. Otherwise returns false if any message sent by this call was not
+  // acknowledged by the stream controller, the items of that message are lost.
   bool ScheduleItems(std::vector<Payload<CoreDlaJobPayload>> items);
   bool Ping();
   bool Initialize(uint32_t sourceBufferSize, uint32_t dropSourceBuffers, uint32_t numInferenceRequests);
 
  private:
   bool StatusMessageHandler(uint32_t payloadOffset);
+  bool PongMessageHandler(uint32_t payloadOffset);
+  bool SendScheduleItems(const std::vector<Payload<CoreDlaJobPayload>>& items);
   MessageType ReceiveMessage();
   bool SendMessage(MessageType, void* pPayload = nullptr, size_t size = 0);
   MmdWrapper _mmdWrapper;
@@ -65,5 +52,10 @@ class StreamControllerComms {
   uint32_t _numBadMessages = 0;
   const int _streamControllerInstance = 0;
   Payload<StatusMessagePayload> _receivedStatusMessage;
-  BusyFlag _busyFlag;
+  Payload<PongPayload> _receivedPongMessage;
+  std::mutex _mailboxMutex;  // Held for each message and its reply
+  std::mutex _pendingItemsMutex;
+  std::deque<Payload<CoreDlaJobPayload>> _pendingItems;
+  bool _sendingItems = false;
+  bool _batchSupported = false;  // set from the capabilities in the Pong reply
 };
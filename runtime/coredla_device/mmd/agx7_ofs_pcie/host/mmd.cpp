@@ -799,6 +799,15 @@ AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint
   return aocl_mmd_read(handle, NULL, length, data, AOCL_MMD_MEMORY, dla_get_raw_ddr_address(instance, addr));
 }
 
+AOCL_MMD_CALL int dla_mmd_ddr_copy(int handle, int instance, uint64_t src_addr, uint64_t dst_addr, uint64_t length) {
+  Device *dev = device_manager.device_from_handle(handle);
+  if (!dev) {
+    MMD_DEBUG("DEBUG LOG : Error in dla_mmd_ddr_copy , device not found for handle : %d\n", handle);
+    return -1;
+  }
+  return dev->copy_block(dla_get_raw_ddr_address(instance, src_addr), dla_get_raw_ddr_address(instance, dst_addr), length);
+}
+
 AOCL_MMD_CALL double dla_mmd_get_coredla_clock_freq(int handle) {
   constexpr uint64_t hw_timer_address = 0x37000;
   const uint32_t start_bit = 1;
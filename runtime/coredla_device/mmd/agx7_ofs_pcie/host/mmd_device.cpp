@@ -433,6 +433,15 @@ int Device::write_block(aocl_mmd_op_t op, int mmd_interface, const void *host_ad
   return res;
 }
 
+/** copy_block() is used in dla_mmd_ddr_copy()
+ *  copies within device memory using the DMA engine, returns non-zero if the DMA cannot do it
+ */
+int Device::copy_block(size_t src_dev_addr, size_t dst_dev_addr, size_t size) {
+  MMD_DEBUG("DEBUG LOG : Device::copy_block()\n");
+  std::unique_lock<std::mutex> dma_mutex_lock(m_dma_mutex);
+  return mmd_dma->fpga_to_fpga((uint64_t)src_dev_addr, (uint64_t)dst_dev_addr, size);
+}
+
 /** read_mmio() is used in read_block() function
  *  it uses OPAE APIs fpgaReadMMIO64() and fpgaReadMMIO32()
  */
@@ -109,6 +109,7 @@ class Device final {
 
   int read_block(aocl_mmd_op_t op, int mmd_interface, void *host_addr, size_t dev_addr, size_t size);
   int write_block(aocl_mmd_op_t op, int mmd_interface, const void *host_addr, size_t dev_addr, size_t size);
+  int copy_block(size_t src_dev_addr, size_t dst_dev_addr, size_t size);
 
  private:
   static int next_mmd_handle;
@@ -29,6 +29,7 @@
 
 #include "mmd_device.h"
 #include "mmd_dma.h"
+#include "mmd_dma_split.h"
 #include "mmd_helper.h"
 
 namespace intel_opae_mmd {
@@ -37,16 +38,19 @@ namespace intel_opae_mmd {
  */
 mmd_dma::mmd_dma(fpga_handle fpga_handle_arg, int mmd_handle) : m_initialized(false), m_fpga_handle(fpga_handle_arg) {
   MMD_DEBUG("DEBUG LOG : Constructing DMA \n");
-  // Initialize shared buffer
-  auto res = fpgaPrepareBuffer(m_fpga_handle, DMA_BUFFER_SIZE, (void **)&dma_buf_ptr, &dma_buf_wsid, 0);
+  // Initialize the ring of shared buffers
+  for (dma_buffer_t &buf : m_dma_bufs) {
+    auto res = fpgaPrepareBuffer(m_fpga_handle, DMA_BUFFER_SIZE, (void **)&buf.ptr, &buf.wsid, 0);
 
-  assert(FPGA_OK == res && "Allocating DMA Buffer failed");
+    assert(FPGA_OK == res && "Allocating DMA Buffer failed");
 
-  memset((void *)dma_buf_ptr, 0x0, DMA_BUFFER_SIZE);
+    memset((void *)buf.ptr, 0x0, DMA_BUFFER_SIZE);
 
-  // Store virtual address of IO registers
-  res = fpgaGetIOAddress(m_fpga_handle, dma_buf_wsid, &dma_buf_iova);
-  assert(FPGA_OK == res && "getting dma DMA_BUF_IOVA failed");
+    // Store virtual address of IO registers
+    res = fpgaGetIOAddress(m_fpga_handle, buf.wsid, &buf.iova);
+    assert(FPGA_OK == res && "getting dma DMA_BUF_IOVA failed");
+    (void)res;
+  }
 
   m_initialized = true;
 }
@@ -57,8 +61,11 @@ mmd_dma::mmd_dma(fpga_handle fpga_handle_arg, int mmd_handle) : m_initialized(fa
  */
 mmd_dma::~mmd_dma() {
   MMD_DEBUG("DEBUG LOG : Destructing DMA \n");
-  auto res = fpgaReleaseBuffer(m_fpga_handle, dma_buf_wsid);
-  assert(FPGA_OK == res && "Release DMA Buffer failed");
+  for (dma_buffer_t &buf : m_dma_bufs) {
+    auto res = fpgaReleaseBuffer(m_fpga_handle, buf.wsid);
+    assert(FPGA_OK == res && "Release DMA Buffer failed");
+    (void)res;
+  }
   m_initialized = false;
 }
 
@@ -112,63 +119,52 @@ int mmd_dma::fpga_to_host(void *host_addr, uint64_t dev_src, size_t size) {
     }
   }
 
-  if (count_left) {
-    uint64_t dma_chunks = count_left / DMA_BUFFER_SIZE;
-    for (uint64_t i = 0; i < dma_chunks; i++) {
-      // constant size transfer
-
-      uint64_t dev_dest = dma_buf_iova | DMA_HOST_MASK;
-      int len = ((DMA_BUFFER_SIZE - 1) / DMA_LINE_SIZE) + 1;  // Ceiling of test_buffer_size / DMA_LINE_SIZE
-
-      dma_transfer(curr_dev_src, dev_dest, len, ddr_to_host);
-
-      // Copy data from shared buffer to host addr
-      memcpy(curr_host_addr, (void *)dma_buf_ptr, DMA_BUFFER_SIZE);
-
-      memset((void *)dma_buf_ptr, 0x0, DMA_BUFFER_SIZE);
+  // DMA every whole 64B line through the ring of shared buffers. Chunk k+1 is sent to the DMA
+  // engine before chunk k is copied out of its shared buffer, so the memcpy overlaps the DMA.
+  uint64_t dma_bytes = (count_left / DMA_LINE_SIZE) * DMA_LINE_SIZE;
+  void *prev_host_addr = NULL;
+  uint64_t prev_bytes = 0;
+  int prev_buf = 0;
+  int curr_buf = 0;
+  while (dma_bytes) {
+    uint64_t dma_tx_bytes = (dma_bytes > DMA_BUFFER_SIZE) ? DMA_BUFFER_SIZE : dma_bytes;
+    uint64_t dev_dest = m_dma_bufs[curr_buf].iova | DMA_HOST_MASK;
+    int len = ((dma_tx_bytes - 1) / DMA_LINE_SIZE) + 1;  // Ceiling of dma_tx_bytes / DMA_LINE_SIZE
+
+    if (prev_bytes && dma_wait()) return -1;
+    if (dma_submit(curr_dev_src, dev_dest, len, ddr_to_host)) return -1;
+
+    // Copy the previous chunk from its shared buffer to host addr while this chunk is in flight
+    if (prev_bytes) memcpy(prev_host_addr, (void *)m_dma_bufs[prev_buf].ptr, prev_bytes);
+
+    prev_host_addr = curr_host_addr;
+    prev_bytes = dma_tx_bytes;
+    prev_buf = curr_buf;
+    curr_buf = (curr_buf + 1) % DMA_BUFFER_COUNT;
+
+    // Update the curr source and dest
+    curr_host_addr = (void *)(static_cast<char *>(curr_host_addr) + dma_tx_bytes);
+    curr_dev_src += dma_tx_bytes;
+    count_left -= dma_tx_bytes;
+    dma_bytes -= dma_tx_bytes;
+  }
+  if (prev_bytes) {
+    if (dma_wait()) return -1;
+    memcpy(prev_host_addr, (void *)m_dma_bufs[prev_buf].ptr, prev_bytes);
+  }
 
-      // Update the curr source and dest
-      curr_host_addr = (void *)(static_cast<char *>(curr_host_addr) + DMA_BUFFER_SIZE);
-      curr_dev_src += DMA_BUFFER_SIZE;
+  if (count_left) {
+    MMD_DEBUG("DEBUG LOG : mmd_dma::fpga_to_host count_left after DMA transfer is ");
+    MMD_DEBUG("%" PRIu64 "\n", count_left);
+    // Handle the rest unaligned transfer using ASE
+    res = _ase_fpga_to_host(curr_dev_src, curr_host_addr, count_left);
+    if (FPGA_OK != res) {
+      MMD_DEBUG("DEBUG LOG : mmd_dma::_ase_fpga_to_host failed\n");
+      return -1;
     }
+    count_left = 0;
 
-    // Updated the count_left for the for loop
-    count_left -= (dma_chunks * DMA_BUFFER_SIZE);
-
-    if (count_left) {
-      uint64_t dma_tx_bytes = (count_left / 64) * 64;
-      if (dma_tx_bytes != 0) {
-        assert(dma_tx_bytes <= DMA_BUFFER_SIZE && "Illegal transfer size\n");
-
-        uint64_t dev_dest = dma_buf_iova | DMA_HOST_MASK;
-        int len = ((dma_tx_bytes - 1) / DMA_LINE_SIZE) + 1;  // Ceiling of test_buffer_size / DMA_LINE_SIZE
-
-        dma_transfer(curr_dev_src, dev_dest, len, ddr_to_host);
-
-        // Copy data from shared buffer to host addr
-        memcpy(curr_host_addr, (void *)dma_buf_ptr, dma_tx_bytes);
-
-        memset((void *)dma_buf_ptr, 0x0, DMA_BUFFER_SIZE);
-
-        // Update the address
-        curr_host_addr = (void *)(static_cast<char *>(curr_host_addr) + dma_tx_bytes);
-        curr_dev_src += dma_tx_bytes;
-        count_left -= dma_tx_bytes;
-      }
-      if (count_left) {
-        MMD_DEBUG("DEBUG LOG : mmd_dma::fpga_to_host count_left after DMA transfer is ");
-        MMD_DEBUG("%" PRIu64 "\n", count_left);
-        // Handle the rest unaligned transfer using ASE
-        res = _ase_fpga_to_host(curr_dev_src, curr_host_addr, count_left);
-        if (FPGA_OK != res) {
-          MMD_DEBUG("DEBUG LOG : mmd_dma::_ase_fpga_to_host failed\n");
-          return -1;
-        }
-        count_left = 0;
-
-        // No need to update address as the transaction is done.
-      }
-    }
+    // No need to update address as the transaction is done.
   }
   assert(count_left==0 && "fpga_to_host failed");
   return 0;
@@ -203,62 +199,58 @@ int mmd_dma::host_to_fpga(const void *host_addr, uint64_t dev_dest, size_t size)
     }
   }
 
-  if (count_left) {
-    uint64_t dma_chunks = count_left / DMA_BUFFER_SIZE;
-    for (uint64_t i = 0; i < dma_chunks; i++) {
-      // constant size transfer
-      // Copy host_src value to the shared buffer
-      memcpy((void *)dma_buf_ptr, curr_host_addr, DMA_BUFFER_SIZE);
-      uint64_t dev_src = dma_buf_iova | DMA_HOST_MASK;
-
-      int len = ((DMA_BUFFER_SIZE - 1) / DMA_LINE_SIZE) + 1;  // Ceiling of test_buffer_size / DMA_LINE_SIZE
-
-      dma_transfer(dev_src, curr_dest, len, host_to_ddr);
-
-      memset((void *)dma_buf_ptr, 0x0, DMA_BUFFER_SIZE);
-
-      // Update the curr source and dest
-      curr_host_addr = (const void *)(static_cast<const char *>(curr_host_addr) + DMA_BUFFER_SIZE);
-      curr_dest += DMA_BUFFER_SIZE;
-    }
+  // DMA every whole 64B line through the ring of shared buffers. Chunk k+1 is copied into the next
+  // shared buffer while chunk k is in flight, so the memcpy overlaps the DMA.
+  uint64_t dma_bytes = (count_left / DMA_LINE_SIZE) * DMA_LINE_SIZE;
+  bool in_flight = false;
+  int curr_buf = 0;
+  while (dma_bytes) {
+    uint64_t dma_tx_bytes = (dma_bytes > DMA_BUFFER_SIZE) ? DMA_BUFFER_SIZE : dma_bytes;
+
+    // Copy host_src value to the shared buffer, this buffer is not the one in flight
+    memcpy((void *)m_dma_bufs[curr_buf].ptr, curr_host_addr, dma_tx_bytes);
+    uint64_t dev_src = m_dma_bufs[curr_buf].iova | DMA_HOST_MASK;
+    int len = ((dma_tx_bytes - 1) / DMA_LINE_SIZE) + 1;  // Ceiling of dma_tx_bytes / DMA_LINE_SIZE
+
+    if (in_flight && dma_wait()) return -1;
+    if (dma_submit(dev_src, curr_dest, len, host_to_ddr)) return -1;
+    in_flight = true;
+    curr_buf = (curr_buf + 1) % DMA_BUFFER_COUNT;
+
+    // Update the curr source and dest
+    curr_host_addr = (const void *)(static_cast<const char *>(curr_host_addr) + dma_tx_bytes);
+    curr_dest += dma_tx_bytes;
+    count_left -= dma_tx_bytes;
+    dma_bytes -= dma_tx_bytes;
+  }
+  if (in_flight && dma_wait()) return -1;
 
-    // Updated the count_left for the for loop
-    count_left -= (dma_chunks * DMA_BUFFER_SIZE);
-
-    if (count_left) {
-      uint64_t dma_tx_bytes = (count_left / 64) * 64;
-      if (dma_tx_bytes != 0) {
-        assert(dma_tx_bytes <= DMA_BUFFER_SIZE && "Illegal transfer size\n");
-
-        // Copy host_src value to the shared buffer
-        memcpy((void *)dma_buf_ptr, curr_host_addr, dma_tx_bytes);
-        uint64_t dev_src = dma_buf_iova | DMA_HOST_MASK;
-
-        int len = ((dma_tx_bytes - 1) / DMA_LINE_SIZE) + 1;  // Ceiling of dma_tx_bytes / DMA_LINE_SIZE
-        dma_transfer(dev_src, curr_dest, len, host_to_ddr);
-
-        memset((void *)dma_buf_ptr, 0x0, DMA_BUFFER_SIZE);
-      }
-
-      // Update the address
-      curr_host_addr = (const void *)(static_cast<const char *>(curr_host_addr) + dma_tx_bytes);
-      curr_dest += dma_tx_bytes;
-      count_left -= dma_tx_bytes;
-
-      if (count_left) {
-        MMD_DEBUG("DEBUG LOG : mmd_dma::host_to_fpga count_left after DMA transfer is ");
-        MMD_DEBUG("%" PRIu64 "\n", count_left);
-        // Handle the rest unaligned transfer using ASE
-        res = _ase_host_to_fpga(curr_dest, curr_host_addr, count_left);
-        assert(FPGA_OK == res && "_ase_host_to_fpga failed");
-        count_left = 0;
-      }
-    }
+  if (count_left) {
+    MMD_DEBUG("DEBUG LOG : mmd_dma::host_to_fpga count_left after DMA transfer is ");
+    MMD_DEBUG("%" PRIu64 "\n", count_left);
+    // Handle the rest unaligned transfer using ASE
+    res = _ase_host_to_fpga(curr_dest, curr_host_addr, count_left);
+    assert(FPGA_OK == res && "_ase_host_to_fpga failed");
+    count_left = 0;
   }
   assert(count_left==0 && "host_to_fpga failed");
   return 0;
 }
 
+// Copy within device memory without going through the host. Each descriptor is limited to
+// DMA_BUFFER_SIZE like the host transfers, see split_fpga_to_fpga() for the handling of overlap.
+int mmd_dma::fpga_to_fpga(uint64_t dev_src, uint64_t dev_dest, size_t size) {
+  if ((dev_src % DMA_LINE_SIZE) || (dev_dest % DMA_LINE_SIZE) || (size % DMA_LINE_SIZE)) {
+    MMD_DEBUG("DEBUG LOG : mmd_dma::fpga_to_fpga requires 64B aligned addresses and size\n");
+    return -1;
+  }
+
+  return split_fpga_to_fpga(
+      dev_src, dev_dest, size, DMA_LINE_SIZE, DMA_BUFFER_SIZE, [this](uint64_t src, uint64_t dest, int len) {
+        return dma_transfer(src, dest, len, ddr_to_ddr);
+      });
+}
+
 int mmd_dma::dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode descriptor_mode) {
 
   // Get debug information for thread id
@@ -267,6 +259,16 @@ int mmd_dma::dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode
   uint64_t id = std::stoull(ss.str());
   MMD_DEBUG("dma_transfer start current thread_id is %04lX\n", id);
 
+  if (dma_submit(dev_src, dev_dest, len, descriptor_mode)) return -1;
+  if (dma_wait()) return -1;
+
+  MMD_DEBUG("dma_transfer end current thread_id is %04lX\n", id);
+  return 0;
+}
+
+// Send one descriptor to the DMA engine without waiting for it to complete
+int mmd_dma::dma_submit(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode descriptor_mode) {
+
   // Native DMA transfer requires 64 byte alignment
   assert(dev_src % 64 == 0);
   assert(dev_dest % 64 == 0);
@@ -275,7 +277,7 @@ int mmd_dma::dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode
 
   dma_descriptor_t desc;
 
-  MMD_DEBUG("DEBUG LOG : mmd_dma::dma_transfer starts\n");
+  MMD_DEBUG("DEBUG LOG : mmd_dma::dma_submit starts\n");
   MMD_DEBUG("DEBUG LOG dev_dest = %04lX\n", dev_dest);
 
   desc.src_address = dev_src & MASK_FOR_35BIT_ADDR;
@@ -284,8 +286,6 @@ int mmd_dma::dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode
   desc.control = 0x80000000 | (descriptor_mode << MODE_SHIFT);
 
   const uint64_t DMA_DESC_BASE = 8 * DMA_CSR_IDX_SRC_ADDR;
-  const uint64_t DMA_STATUS_BASE = 8 * DMA_CSR_IDX_STATUS;
-  uint64_t mmio_data = 0;
 
   int desc_size = sizeof(desc);
 
@@ -298,6 +298,13 @@ int mmd_dma::dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode
 
   // send descriptor
   send_descriptor(DMA_DESC_BASE, desc);
+  return 0;
+}
+
+// Poll the DMA engine until the descriptor sent by dma_submit() has completed
+int mmd_dma::dma_wait() {
+  const uint64_t DMA_STATUS_BASE = 8 * DMA_CSR_IDX_STATUS;
+  uint64_t mmio_data = 0;
 
   fpga_result r;
   r = fpgaReadMMIO64(m_fpga_handle, 0, DMA_STATUS_BASE, &mmio_data);
@@ -309,7 +316,6 @@ int mmd_dma::dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode
     r = fpgaReadMMIO64(m_fpga_handle, 0, DMA_STATUS_BASE, &mmio_data);
     assert(FPGA_OK == r);
   }
-  MMD_DEBUG("dma_transfer end current thread_id is %04lX\n", id);
   return 0;
 }
 
@@ -36,6 +36,9 @@
 #define MODE_SHIFT 26
 // For now limits to 16K to avoid DMA transfer hang in hw, further testing required to increase the value.
 #define DMA_BUFFER_SIZE (1024 * 16)
+// Number of pinned staging buffers. The DMA engine only has one descriptor in flight, two buffers
+// are enough to overlap the memcpy of one chunk with the DMA of the next.
+#define DMA_BUFFER_COUNT 2
 #define DMA_LINE_SIZE 64
 #define DMA_HOST_MASK 0x2000000000000
 
@@ -47,6 +50,15 @@ namespace intel_opae_mmd {
 
 enum dma_mode { stand_by = 0x0, host_to_ddr = 0x1, ddr_to_host = 0x2, ddr_to_ddr = 0x3 };
 
+// Pinned host buffer the DMA engine reads from / writes to
+struct dma_buffer_t {
+  uint64_t *ptr = NULL;
+  // Workspace ID used by OPAE to identify buffer
+  uint64_t wsid = 0;
+  // IO virtual address
+  uint64_t iova = 0;
+};
+
 struct dma_descriptor_t {
   uint64_t src_address;
   uint64_t dest_address;
@@ -63,7 +75,14 @@ class mmd_dma final {
 
   int fpga_to_host(void *host_addr, uint64_t dev_src, size_t size);
   int host_to_fpga(const void *host_addr, uint64_t dev_dest, size_t size);
+  // Device to device copy using ddr_to_ddr descriptors, source and destination may overlap.
+  // Returns -1 if the addresses or size are not 64B aligned, the caller must then copy through the host.
+  int fpga_to_fpga(uint64_t dev_src, uint64_t dev_dest, size_t size);
   int dma_transfer(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode descriptor_mode);
+  // Split version of dma_transfer(), dma_submit() returns as soon as the descriptor is sent and
+  // dma_wait() blocks until the DMA engine is idle. Only one descriptor may be in flight.
+  int dma_submit(uint64_t dev_src, uint64_t dev_dest, int len, dma_mode descriptor_mode);
+  int dma_wait();
   fpga_result _ase_host_to_fpga(uint64_t dev_dest, const void *src_ptr, uint64_t count);
   fpga_result _ase_fpga_to_host(uint64_t dev_dest, void *host_ptr, uint64_t count);
   mmd_dma(mmd_dma &other) = delete;
@@ -76,12 +95,8 @@ class mmd_dma final {
   bool m_initialized;
   fpga_handle m_fpga_handle;
 
-  // Shared buffer in host memory
-  uint64_t *dma_buf_ptr = NULL;
-  // Workspace ID used by OPAE to identify buffer
-  uint64_t dma_buf_wsid;
-  // IO virtual address
-  uint64_t dma_buf_iova;
+  // Ring of shared buffers in host memory
+  dma_buffer_t m_dma_bufs[DMA_BUFFER_COUNT];
 };
 
 };  // namespace intel_opae_mmd
@@ -0,0 +1,53 @@
+// (c) 1992-2024 Intel Corporation.
+// Intel, the Intel logo, Intel, MegaCore, NIOS II, Quartus and TalkBack words
+// and logos are trademarks of Intel Corporation or its subsidiaries in the U.S.
+// and/or other countries. Other marks and brands may be claimed as the property
+// of others. See Trademarks on intel.com for full list of Intel trademarks or
+// the Trademarks & Brands Names Database (if Intel) or See www.Intel.com/legal (if Altera)
+// Your use of Intel Corporation's design tools, logic functions and other
+// software and tools, and its AMPP partner logic functions, and any output
+// files any of the foregoing (including device programming or simulation
+// files), and any associated documentation or information are expressly subject
+// to the terms and conditions of the Altera Program License Subscription
+// Agreement, Intel MegaCore Function License Agreement, or other applicable
+// license agreement, including, without limitation, that your use is for the
+// sole purpose of programming logic devices manufactured by Intel and sold by
+// Intel or its authorized distributors.  Please refer to the applicable
+// agreement for further details.
+#ifndef MMD_DMA_SPLIT_H_
+#define MMD_DMA_SPLIT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace intel_opae_mmd {
+
+// Splits a device to device copy of size bytes into descriptors and calls submit(src, dest, len)
+// for each one, len counts line_size lines. Stops at the first descriptor for which submit returns
+// non-zero. Addresses and size must be multiples of line_size.
+//
+// Each descriptor is limited to max_chunk bytes, and to the distance between source and destination
+// so that a descriptor never reads data that it (or a later descriptor) has already overwritten.
+// When the destination is above the source the chunks are copied from the end of the range backwards.
+template <typename Submit>
+int split_fpga_to_fpga(uint64_t dev_src, uint64_t dev_dest, size_t size, uint64_t line_size, uint64_t max_chunk,
+                       Submit submit) {
+  if (size == 0 || dev_src == dev_dest) return 0;
+
+  uint64_t distance = (dev_dest > dev_src) ? (dev_dest - dev_src) : (dev_src - dev_dest);
+  if (distance < max_chunk) max_chunk = distance;
+  max_chunk -= max_chunk % line_size;
+
+  uint64_t done = 0;
+  while (done < size) {
+    uint64_t chunk = (size - done > max_chunk) ? max_chunk : (size - done);
+    uint64_t offset = (dev_dest > dev_src) ? (size - done - chunk) : done;
+    if (submit(dev_src + offset, dev_dest + offset, static_cast<int>(chunk / line_size))) return -1;
+    done += chunk;
+  }
+  return 0;
+}
+
+};  // namespace intel_opae_mmd
+
+#endif  // MMD_DMA_SPLIT_H_
@@ -0,0 +1,94 @@
+// (c) 1992-2024 Intel Corporation.
+// Intel, the Intel logo, Intel, MegaCore, NIOS II, Quartus and TalkBack words
+// and logos are trademarks of Intel Corporation or its subsidiaries in the U.S.
+// and/or other countries. Other marks and brands may be claimed as the property
+// of others. See Trademarks on intel.com for full list of Intel trademarks or
+// the Trademarks & Brands Names Database (if Intel) or See www.Intel.com/legal (if Altera)
+// Your use of Intel Corporation's design tools, logic functions and other
+// software and tools, and its AMPP partner logic functions, and any output
+// files any of the foregoing (including device programming or simulation
+// files), and any associated documentation or information are expressly subject
+// to the terms and conditions of the Altera Program License Subscription
+// Agreement, Intel MegaCore Function License Agreement, or other applicable
+// license agreement, including, without limitation, that your use is for the
+// sole purpose of programming logic devices manufactured by Intel and sold by
+// Intel or its authorized distributors.  Please refer to the applicable
+// agreement for further details.
+
+// Runs split_fpga_to_fpga() against a model of the DDR, where each descriptor copies len lines
+// like a ddr_to_ddr descriptor. Checks that copies between overlapping 64B aligned regions give
+// the source data at the destination and leave every byte outside the destination untouched.
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "mmd_dma_split.h"
+
+using namespace intel_opae_mmd;
+
+static const uint64_t kLineSize = 64;
+static const uint64_t kMemorySize = 256 * 1024;
+
+static bool check_copy(uint64_t src, uint64_t dest, size_t size, uint64_t max_chunk) {
+  std::vector<uint8_t> memory(kMemorySize);
+  for (size_t i = 0; i < memory.size(); i++) memory[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+  const std::vector<uint8_t> original = memory;
+
+  bool ok = true;
+  int status = split_fpga_to_fpga(src, dest, size, kLineSize, max_chunk, [&](uint64_t s, uint64_t d, int len) {
+    uint64_t bytes = static_cast<uint64_t>(len) * kLineSize;
+    uint64_t distance = (d > s) ? (d - s) : (s - d);
+    if (len <= 0 || bytes > max_chunk || (s != d && bytes > distance) || d + bytes > kMemorySize ||
+        s + bytes > kMemorySize) {
+      std::cout << "bad descriptor src 0x" << std::hex << s << " dest 0x" << d << std::dec << " len " << len << "\n";
+      ok = false;
+      return -1;
+    }
+    std::memcpy(&memory[d], &memory[s], bytes);
+    return 0;
+  });
+  if (status != 0) ok = false;
+
+  for (uint64_t i = 0; ok && i < kMemorySize; i++) {
+    bool in_dest = (i >= dest) && (i < dest + size);
+    uint8_t expected = in_dest ? original[src + (i - dest)] : original[i];
+    if (memory[i] != expected) {
+      std::cout << "byte 0x" << std::hex << i << std::dec << (in_dest ? " inside" : " outside")
+                << " the destination is wrong\n";
+      ok = false;
+    }
+  }
+
+  if (!ok) {
+    std::cout << "copy src 0x" << std::hex << src << " dest 0x" << dest << std::dec << " size " << size
+              << " max chunk " << max_chunk << " failed\n";
+  }
+  return ok;
+}
+
+int main() {
+  const uint64_t base = 64 * 1024;
+  const uint64_t distances[] = {64, 128, 192, 4096, 16 * 1024, 20 * 1024, 48 * 1024};
+  const size_t sizes[] = {64, 640, 4096, 16 * 1024, 40 * 1024 + 192};
+  const uint64_t max_chunks[] = {16 * 1024, 1024};
+
+  int failures = 0;
+  for (uint64_t max_chunk : max_chunks) {
+    for (uint64_t distance : distances) {
+      for (size_t size : sizes) {
+        // Compaction moves buffers to higher addresses, also check the other direction
+        if (!check_copy(base, base + distance, size, max_chunk)) failures++;
+        if (!check_copy(base + distance, base, size, max_chunk)) failures++;
+      }
+    }
+  }
+  if (!check_copy(base, base, 4096, 16 * 1024)) failures++;
+
+  if (failures) {
+    std::cout << failures << " copies failed\n";
+    return 1;
+  }
+  std::cout << "All copies passed\n";
+  return 0;
+}
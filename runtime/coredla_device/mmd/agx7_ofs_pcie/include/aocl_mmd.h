@@ -364,6 +364,12 @@ AOCL_MMD_CALL int dla_mmd_csr_read(int handle, int instance, uint64_t addr, uint
 AOCL_MMD_CALL int dla_mmd_ddr_write(int handle, int instance, uint64_t addr, uint64_t length, const void* data) WEAK;
 AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint64_t length, void* data) WEAK;
 
+// Copy within the device memory of one instance without a round trip through the host, the ranges
+// may overlap. Returns non-zero if the DMA engine cannot do the copy (e.g. unaligned addresses), in
+// which case the caller copies through host memory instead.
+#define DDR_COPY_ACCESS
+AOCL_MMD_CALL int dla_mmd_ddr_copy(int handle, int instance, uint64_t src_addr, uint64_t dst_addr, uint64_t length) WEAK;
+
 // Get the clk_dla PLL clock frequency in MHz, returns a negative value if there is an error
 AOCL_MMD_CALL double dla_mmd_get_coredla_clock_freq(int handle) WEAK;
 
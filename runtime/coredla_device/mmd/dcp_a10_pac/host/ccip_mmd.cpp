@@ -622,6 +622,20 @@ AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint
   return aocl_mmd_read(handle, NULL, length, data, AOCL_MMD_MEMORY, dla_get_raw_ddr_address(instance, addr));
 }
 
+#ifdef DDR_ASYNC_ACCESS
+// A non-NULL op makes the CcipDevice hand the transfer to the DMA work thread instead of blocking
+AOCL_MMD_CALL int dla_mmd_ddr_write_async(
+    int handle, int instance, uint64_t addr, uint64_t length, const void* data, aocl_mmd_op_t op) {
+  assert(op);
+  return aocl_mmd_write(handle, op, length, data, AOCL_MMD_MEMORY, dla_get_raw_ddr_address(instance, addr));
+}
+AOCL_MMD_CALL int dla_mmd_ddr_read_async(
+    int handle, int instance, uint64_t addr, uint64_t length, void* data, aocl_mmd_op_t op) {
+  assert(op);
+  return aocl_mmd_read(handle, op, length, data, AOCL_MMD_MEMORY, dla_get_raw_ddr_address(instance, addr));
+}
+#endif
+
 // Get the PLL clock frequency in MHz, returns a negative value if there is an error
 AOCL_MMD_CALL double dla_mmd_get_coredla_clock_freq(int handle) {
   constexpr uint64_t hw_timer_address = 0x37000;
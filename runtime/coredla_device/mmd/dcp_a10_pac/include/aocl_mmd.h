@@ -478,6 +478,14 @@ AOCL_MMD_CALL int dla_mmd_csr_read(int handle, int instance, uint64_t addr, uint
 AOCL_MMD_CALL int dla_mmd_ddr_write(int handle, int instance, uint64_t addr, uint64_t length, const void* data) WEAK;
 AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint64_t length, void* data) WEAK;
 
+// Non-blocking DDR transfers, queued on the DMA work thread. Completion of op is reported through the
+// handler registered with aocl_mmd_set_status_handler, data must stay valid until then.
+#define DDR_ASYNC_ACCESS
+#ifdef DDR_ASYNC_ACCESS
+AOCL_MMD_CALL int dla_mmd_ddr_write_async(int handle, int instance, uint64_t addr, uint64_t length, const void* data, aocl_mmd_op_t op) WEAK;
+AOCL_MMD_CALL int dla_mmd_ddr_read_async(int handle, int instance, uint64_t addr, uint64_t length, void* data, aocl_mmd_op_t op) WEAK;
+#endif
+
 // Get the clk_dla PLL clock frequency in MHz, returns a negative value if there is an error
 AOCL_MMD_CALL double dla_mmd_get_coredla_clock_freq(int handle) WEAK;
 #endif
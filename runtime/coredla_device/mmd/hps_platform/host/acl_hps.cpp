@@ -450,6 +450,39 @@ AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint
   return aocl_mmd_read(handle, NULL, length, data, HPS_MMD_MEMORY_HANDLE, dla_get_raw_ddr_address(instance, addr));
 }
 
+#ifdef DDR_MAP_ACCESS
+// The mapping covers the whole DDR, the window of the instance starts at its raw address 0
+AOCL_MMD_CALL void *dla_mmd_ddr_map(int handle, int instance, uint64_t *length) {
+  if( length ) *length = 0;
+  if( instance < 0 || instance >= dla_mmd_get_max_num_instances() ) {
+    return nullptr;
+  }
+  mmd_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return nullptr;
+  }
+  size_t size = 0;
+  uint8_t *pMapped = static_cast<uint8_t *>(spDevice->get_mapped_ddr(size));
+  uint64_t base = dla_get_raw_ddr_address(instance, 0);
+  if( nullptr == pMapped || base >= size ) {
+    return nullptr;
+  }
+  if( length ) *length = size - base;
+  return pMapped + base;
+}
+
+AOCL_MMD_CALL int dla_mmd_ddr_sync(int handle, int instance, uint64_t addr, uint64_t length, int to_device) {
+  if( instance < 0 || instance >= dla_mmd_get_max_num_instances() ) {
+    return FAILURE;
+  }
+  mmd_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return FAILURE;
+  }
+  return spDevice->sync_mapped_ddr(dla_get_raw_ddr_address(instance, addr), length, to_device != 0);
+}
+#endif
+
 #ifdef STREAM_CONTROLLER_ACCESS
 AOCL_MMD_CALL bool dla_is_stream_controller_valid(int handle, int instance) {
   mmd_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
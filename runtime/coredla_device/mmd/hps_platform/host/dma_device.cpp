@@ -34,6 +34,7 @@
 #include <stdio.h>
 
 #include <memory.h>
+#include <string.h>
 
 // Copied from Linux driver: /drivers/dma/altera-msgdma.c
 #define MSGDMA_DESC_NUM 1024
@@ -47,9 +48,33 @@
 printf("%s:%u() **ERROR** : " format, \
     __func__, __LINE__,  ##__VA_ARGS__)
 
+// u-dma-buf sysfs attributes, the class was renamed from udmabuf in later versions of the driver
+static const char *UDMABUF_SYSFS_CLASSES[] = {"/sys/class/u-dma-buf/", "/sys/class/udmabuf/"};
+
+// Values of sync_direction
+#define UDMABUF_DMA_TO_DEVICE   1
+#define UDMABUF_DMA_FROM_DEVICE 2
+
+static bool read_sysfs_value(const std::string &path, size_t &value)
+{
+    FILE *pFile = fopen(path.c_str(), "r");
+    if( pFile == nullptr ) {
+        return false;
+    }
+    unsigned long long read_value = 0;
+    bool bRead = fscanf(pFile, "%llu", &read_value) == 1;
+    fclose(pFile);
+    value = read_value;
+    return bRead;
+}
+
 //////////////////////////////////////////////////////
-dma_device::dma_device(std::string &name)
+dma_device::dma_device(std::string &name, const std::string &buffer_name)
 {
+    if( map_buffer(buffer_name) ) {
+        return;
+    }
+
     _pFile = fopen(name.c_str(), "r+");
     if( _pFile == nullptr )
     {
@@ -68,10 +93,96 @@ dma_device::~dma_device()
         fclose(_pFile);
         _pFile = NULL;
     }
+    if( _pMapped )
+    {
+        munmap(_pMapped, _mapped_size);
+        _pMapped = nullptr;
+    }
+    if( _buffer_fd >= 0 )
+    {
+        close(_buffer_fd);
+        _buffer_fd = -1;
+    }
+}
+
+// Returns false if the buffer does not exist, in which case the msgdma driver is used instead
+bool dma_device::map_buffer(const std::string &buffer_name)
+{
+    std::string dev_name = "/dev/" + buffer_name;
+    if( buffer_name.empty() || access(dev_name.c_str(), F_OK) != 0 ) {
+        return false;
+    }
+
+    for( const char *sysfs_class : UDMABUF_SYSFS_CLASSES ) {
+        std::string path = std::string(sysfs_class) + buffer_name + "/";
+        if( read_sysfs_value(path + "size", _mapped_size) ) {
+            _sysfs_path = path;
+            break;
+        }
+    }
+    if( _sysfs_path.empty() || _mapped_size == 0 ) {
+        ERR("dma_device::map_buffer cannot read the size of %s\n", dev_name.c_str());
+        return false;
+    }
+    size_t coherent = 0;
+    _coherent = read_sysfs_value(_sysfs_path + "dma_coherent", coherent) && coherent;
+
+    // Without O_SYNC the buffer is mapped cacheable, sync() does the cache maintenance
+    _buffer_fd = open(dev_name.c_str(), O_RDWR);
+    if( _buffer_fd < 0 ) {
+        ERR("dma_device::map_buffer failed to open %s\n", dev_name.c_str());
+        return false;
+    }
+    void *pMapped = mmap(NULL, _mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, _buffer_fd, 0);
+    if( pMapped == MAP_FAILED ) {
+        ERR("dma_device::map_buffer failed to map %zu bytes of %s\n", _mapped_size, dev_name.c_str());
+        close(_buffer_fd);
+        _buffer_fd = -1;
+        return false;
+    }
+    _pMapped = static_cast<uint8_t *>(pMapped);
+    return true;
+}
+
+bool dma_device::write_sync_attr(const char *attr, size_t value)
+{
+    std::string path = _sysfs_path + attr;
+    FILE *pFile = fopen(path.c_str(), "w");
+    if( pFile == nullptr ) {
+        return false;
+    }
+    bool bWritten = fprintf(pFile, "%zu", value) > 0;
+    return (fclose(pFile) == 0) && bWritten;
+}
+
+int dma_device::sync(size_t offset, size_t size, bool for_device)
+{
+    if( _pMapped == nullptr || offset + size > _mapped_size ) {
+        return FAILURE;
+    }
+    if( _coherent || size == 0 ) {
+        return SUCCESS;
+    }
+    bool bSynced = write_sync_attr("sync_offset", offset) &&
+                   write_sync_attr("sync_size", size) &&
+                   write_sync_attr("sync_direction", for_device ? UDMABUF_DMA_TO_DEVICE : UDMABUF_DMA_FROM_DEVICE) &&
+                   write_sync_attr(for_device ? "sync_for_device" : "sync_for_cpu", 1);
+    return bSynced ? SUCCESS : FAILURE;
 }
 
 int  dma_device::read_block(void *host_addr, size_t offset, size_t size)
 {
+    if( _pMapped ) {
+        if( sync(offset, size, false) != SUCCESS ) {
+            return FAILURE;
+        }
+        // The runtime may have placed the tensor in the buffer already, then there is nothing to copy
+        if( host_addr != _pMapped + offset ) {
+            memcpy(host_addr, _pMapped + offset, size);
+        }
+        return SUCCESS;
+    }
+
     // Use 32bit seek as DDR memory current < 32bits
     if( fseek(_pFile, (uint32_t)offset, SEEK_SET) != 0 ) {
         return FAILURE;
@@ -83,6 +194,16 @@ int  dma_device::read_block(void *host_addr, size_t offset, size_t size)
 
 int  dma_device::write_block(const void *host_addr, size_t offset, size_t size)
 {
+    if( _pMapped ) {
+        if( offset + size > _mapped_size ) {
+            return FAILURE;
+        }
+        if( host_addr != _pMapped + offset ) {
+            memcpy(_pMapped + offset, host_addr, size);
+        }
+        return sync(offset, size, true);
+    }
+
     // The MSGDMA driver only supports a maximum of 1024 x 4096 = 4MBytes in the worst case scenario,
     // in the event that the virtual buffer is fully fragmented. As the buffer gets more fragmented it's
     // possible to run out of DMA descriptors. To prevent this, slice the data into 4MB chunks.
@@ -26,6 +26,12 @@
 /*                                                                                 */
 /* This file implements the functions used access the dma device objects           */
 /*                                                                                 */
+/* Device memory is either reached through the msgdma_userio driver (a file that   */
+/* is seeked, read and written) or, if the board reserves the DDR window of the    */
+/* CoreDLA instance in HPS memory, through a u-dma-buf buffer that is mmapped into */
+/* the process. The mapped buffer turns transfers into a memcpy and lets the       */
+/* runtime place tensors directly into device memory.                              */
+/*                                                                                 */
 /* ===-------------------------------------------------------------------------=== */
 #include <vector>
 #include <string>
@@ -36,20 +42,35 @@
 class dma_device
 {
 public:
-  dma_device(std::string &name);
+  // buffer_name is the u-dma-buf device to map, if it does not exist the msgdma device name is used
+  dma_device(std::string &name, const std::string &buffer_name);
   ~dma_device();
 
   int read_block(void *host_addr, size_t offset, size_t size);
   int write_block(const void *host_addr, size_t offset, size_t size);
 
-  bool bValid() { return _pFile != nullptr; };
+  // Mapped buffer only, returns nullptr with the msgdma driver
+  void *get_mapped_address(size_t &size) { size = _mapped_size; return _pMapped; };
+  // Make the CPU caches and device memory agree on a range of the mapped buffer, for_device after the CPU
+  // has written the range and before the FPGA reads it, !for_device after the FPGA wrote it
+  int sync(size_t offset, size_t size, bool for_device);
+
+  bool bValid() { return _pFile != nullptr || _pMapped != nullptr; };
 private:
+  bool map_buffer(const std::string &buffer_name);
+  bool write_sync_attr(const char *attr, size_t value);
 
   dma_device() = delete;
   dma_device(dma_device const&) = delete;
   void operator=(dma_device const &) = delete;
 
   FILE *_pFile = {nullptr}; // File pointer to UIO - Used to indicate the the uio_device is valid
+
+  int _buffer_fd = {-1};          // u-dma-buf device
+  uint8_t *_pMapped = {nullptr};  // Mapping of the whole buffer, offset 0 is DDR address 0 of the instance
+  size_t _mapped_size = {0};
+  bool _coherent = {false};       // no cache maintenance needed if the FPGA accesses are cache coherent
+  std::string _sysfs_path;        // u-dma-buf attributes used for cache maintenance
 };
 typedef std::shared_ptr<dma_device> dma_device_ptr;
 
@@ -33,6 +33,8 @@
 
 // Defined name of the msgdma device
 #define DMA_DEVICE_PREFIX "/dev/msgdma_coredla"
+// Defined name of the u-dma-buf buffer that backs the DDR of an instance, boards without it use the msgdma device
+#define DMA_BUFFER_PREFIX "udmabuf_coredla"
 #define UIO_DEVICE_PREFIX "uio"
 
 board_names mmd_get_devices(const int max_fpga_devices)
@@ -50,7 +52,9 @@ mmd_device::mmd_device(std::string name, const int mmd_handle)
     {
         std::string dma_name(DMA_DEVICE_PREFIX);
         dma_name += std::to_string(index);
-        _spDmaDevice = std::make_shared<dma_device>(dma_name);
+        std::string buffer_name(DMA_BUFFER_PREFIX);
+        buffer_name += std::to_string(index);
+        _spDmaDevice = std::make_shared<dma_device>(dma_name, buffer_name);
 
         if( (_spDmaDevice==nullptr) || (!_spDmaDevice->bValid()) ) {
             _spDmaDevice = nullptr;
@@ -106,6 +110,15 @@ int mmd_device::write_block(aocl_mmd_op_t op, int mmd_interface, const void *hos
     return FAILURE;
 }
 
+void *mmd_device::get_mapped_ddr(size_t &size) {
+    size = 0;
+    return _spDmaDevice ? _spDmaDevice->get_mapped_address(size) : nullptr;
+}
+
+int mmd_device::sync_mapped_ddr(size_t offset, size_t size, bool for_device) {
+    return _spDmaDevice ? _spDmaDevice->sync(offset, size, for_device) : FAILURE;
+}
+
 int mmd_device::set_interrupt_handler(aocl_mmd_interrupt_handler_fn fn, void *user_data) {
     if( _spCoredlaDevice ) {
         return _spCoredlaDevice->set_interrupt_handler(fn, user_data);
@@ -54,6 +54,10 @@ public:
   int read_block(aocl_mmd_op_t op, int mmd_interface, void *host_addr, size_t offset, size_t size);
 
   int set_interrupt_handler(aocl_mmd_interrupt_handler_fn fn, void *user_data);
+
+  // Device memory mapped into the process, nullptr if the board uses the msgdma driver
+  void *get_mapped_ddr(size_t &size);
+  int sync_mapped_ddr(size_t offset, size_t size, bool for_device);
 private:
   int32_t extract_index(const std::string name);
 
@@ -627,6 +627,17 @@ AOCL_MMD_CALL int dla_mmd_csr_read(int handle, int instance, uint64_t addr, uint
 AOCL_MMD_CALL int dla_mmd_ddr_write(int handle, int instance, uint64_t addr, uint64_t length, const void* data) WEAK;
 AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint64_t length, void* data) WEAK;
 
+// Device memory that is mapped into the process. dla_mmd_ddr_map returns where address 0 of the instance is mapped and
+// sets length to the size of the mapping from there, or returns nullptr if the device memory of the instance cannot be
+// mapped. The mapping may be cached: call dla_mmd_ddr_sync with to_device set after writing a range and before the
+// FPGA reads it, and with to_device cleared after the FPGA wrote a range and before reading it.
+// dla_mmd_ddr_write and dla_mmd_ddr_read skip the copy when data already points at the mapped address.
+#define DDR_MAP_ACCESS
+#ifdef DDR_MAP_ACCESS
+AOCL_MMD_CALL void* dla_mmd_ddr_map(int handle, int instance, uint64_t* length) WEAK;
+AOCL_MMD_CALL int dla_mmd_ddr_sync(int handle, int instance, uint64_t addr, uint64_t length, int to_device) WEAK;
+#endif
+
 #define STREAM_CONTROLLER_ACCESS
 #ifdef STREAM_CONTROLLER_ACCESS
 AOCL_MMD_CALL bool dla_is_stream_controller_valid(int handle, int instance) WEAK;
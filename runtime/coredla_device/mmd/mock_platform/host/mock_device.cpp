@@ -0,0 +1,353 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_device.cpp  ---------------------------------------------- C++ -*-=== */
+/*                                                                                 */
+/*                         mock device access functions                            */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+/*                                                                                 */
+/* This file implements the CSR register model and the job scheduler thread        */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+
+#include "mock_device.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "dla_dma_constants.h"
+
+// Read an environment variable as a double, returns default_value if it is not set
+static double get_env_double(const char *name, double default_value) {
+    const char *value = getenv(name);
+    return value ? atof(value) : default_value;
+}
+
+mock_config mock_config::from_env()
+{
+    mock_config config;
+    config.num_instances = static_cast<int>(get_env_double("MOCK_MMD_NUM_INSTANCES", config.num_instances));
+    config.ddr_size = static_cast<uint64_t>(get_env_double("MOCK_MMD_DDR_SIZE_MB", config.ddr_size >> 20)) << 20;
+    config.job_latency_us = get_env_double("MOCK_MMD_JOB_LATENCY_US", config.job_latency_us);
+    config.ddr_bandwidth_mbps = get_env_double("MOCK_MMD_DDR_BANDWIDTH_MBPS", config.ddr_bandwidth_mbps);
+    config.coredla_clock_mhz = get_env_double("MOCK_MMD_COREDLA_CLOCK_MHZ", config.coredla_clock_mhz);
+    const char *stream_controller = getenv("MOCK_MMD_STREAM_CONTROLLER");
+    config.stream_controller = stream_controller != nullptr;
+    config.stream_controller_legacy = stream_controller && (strcmp(stream_controller, "legacy") == 0);
+    config.map_ddr = getenv("MOCK_MMD_MAP_DDR") != nullptr;
+    config.debug = getenv("MOCK_MMD_DEBUG") != nullptr;
+
+    if( (config.num_instances < 1) || (config.num_instances > MOCK_MAX_INSTANCES) ) {
+        MOCK_ERR("MOCK_MMD_NUM_INSTANCES must be between 1 and %d, using 1\n", MOCK_MAX_INSTANCES);
+        config.num_instances = 1;
+    }
+    return config;
+}
+
+/////////////////////////////////////////////////////////
+mock_device::mock_device(const mock_config &config, const int mmd_handle)
+: _config(config), _mmd_handle(mmd_handle), _instances(MOCK_MAX_INSTANCES)
+{
+    for( auto &inst : _instances ) {
+        inst.spMemory = std::make_shared<mock_memory>(_config.ddr_size, _config.map_ddr);
+    }
+    if( _config.stream_controller ) {
+        _spStreamController = std::make_shared<mock_stream_controller>(_config.debug, _config.stream_controller_legacy);
+    }
+    _pThread = new std::thread(work_thread, std::ref(*this));
+}
+
+mock_device::~mock_device()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bShutdown = true;
+    }
+    _cv.notify_all();
+    if( _pThread ) {
+        _pThread->join();
+        delete _pThread;
+        _pThread = nullptr;
+    }
+}
+
+int mock_device::write_block(aocl_mmd_op_t op, int mmd_interface, const void *host_addr, size_t offset, size_t size)
+{
+    if( op ) {
+        MOCK_ERR("op not support : %s\n", __func__ );
+        return FAILURE;
+    }
+    if( mmd_interface == MOCK_MMD_MEMORY_HANDLE ) {
+        size_t instance = offset / _config.ddr_size;
+        if( instance >= _instances.size() ) {
+            return FAILURE;
+        }
+        transfer_delay(size);
+        return _instances[instance].spMemory->write_block(host_addr, offset % _config.ddr_size, size);
+    } else if( mmd_interface == MOCK_MMD_COREDLA_CSR_HANDLE ) {
+        if( (size != sizeof(uint32_t)) || (offset % sizeof(uint32_t)) ) {
+            MOCK_ERR("CSR accesses must be 32-bit aligned words\n");
+            return FAILURE;
+        }
+        int instance = static_cast<int>(offset / MOCK_CSR_WINDOW_SIZE);
+        if( instance >= MOCK_MAX_INSTANCES ) {
+            return FAILURE;
+        }
+        csr_write(instance, static_cast<uint32_t>(offset % MOCK_CSR_WINDOW_SIZE), *static_cast<const uint32_t *>(host_addr));
+        return SUCCESS;
+    } else if( (mmd_interface == MOCK_MMD_STREAM_CONTROLLER_HANDLE) && _spStreamController ) {
+        return _spStreamController->write_block(host_addr, offset, size);
+    }
+    return FAILURE;
+}
+
+int mock_device::read_block(aocl_mmd_op_t op, int mmd_interface, void *host_addr, size_t offset, size_t size)
+{
+    if( op ) {
+        MOCK_ERR("op not support : %s\n", __func__ );
+        return FAILURE;
+    }
+    if( mmd_interface == MOCK_MMD_MEMORY_HANDLE ) {
+        size_t instance = offset / _config.ddr_size;
+        if( instance >= _instances.size() ) {
+            return FAILURE;
+        }
+        transfer_delay(size);
+        return _instances[instance].spMemory->read_block(host_addr, offset % _config.ddr_size, size);
+    } else if( mmd_interface == MOCK_MMD_COREDLA_CSR_HANDLE ) {
+        if( (size != sizeof(uint32_t)) || (offset % sizeof(uint32_t)) ) {
+            MOCK_ERR("CSR accesses must be 32-bit aligned words\n");
+            return FAILURE;
+        }
+        int instance = static_cast<int>(offset / MOCK_CSR_WINDOW_SIZE);
+        if( instance >= MOCK_MAX_INSTANCES ) {
+            return FAILURE;
+        }
+        *static_cast<uint32_t *>(host_addr) = csr_read(instance, static_cast<uint32_t>(offset % MOCK_CSR_WINDOW_SIZE));
+        return SUCCESS;
+    } else if( (mmd_interface == MOCK_MMD_STREAM_CONTROLLER_HANDLE) && _spStreamController ) {
+        return _spStreamController->read_block(host_addr, offset, size);
+    }
+    return FAILURE;
+}
+
+int mock_device::set_interrupt_handler(aocl_mmd_interrupt_handler_fn fn, void *user_data)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _interrupt_fn = fn;
+    _interrupt_fn_user_data = user_data;
+    return SUCCESS;
+}
+
+void *mock_device::get_mapped_ddr(int instance, uint64_t &size)
+{
+    size = 0;
+    if( (instance < 0) || (instance >= _config.num_instances) ) {
+        return nullptr;
+    }
+    void *pMapped = _instances[instance].spMemory->mapped_address();
+    if( pMapped ) {
+        size = _config.ddr_size;
+    }
+    return pMapped;
+}
+
+// The model and the host share the mapping, so there is no cache to maintain. The range is still checked so
+// that the runtime syncs what it transfers.
+int mock_device::sync_mapped_ddr(int instance, uint64_t offset, uint64_t size, bool for_device)
+{
+    if( (instance < 0) || (instance >= _config.num_instances) ||
+        !_instances[instance].spMemory->mapped_address() ||
+        (offset > _config.ddr_size) || (size > _config.ddr_size - offset) ) {
+        MOCK_ERR("Sync of a range that is not mapped\n");
+        return FAILURE;
+    }
+    if( _config.debug ) {
+        MOCK_INFO("Instance %d sync 0x%llx bytes at 0x%llx %s the device\n", instance, (unsigned long long)size,
+                  (unsigned long long)offset, for_device ? "to" : "from");
+    }
+    return SUCCESS;
+}
+
+uint32_t mock_device::csr_read(int instance, uint32_t addr)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    mock_instance &inst = _instances[instance];
+
+    // Instances beyond the configured count are not populated, every register reads as zero. This
+    // is how the runtime discovers the number of instances (interrupt mask write then read back).
+    if( instance >= _config.num_instances ) {
+        return 0;
+    }
+
+    // 64-bit counters, reading the lower half latches the upper half so the pair is consistent
+    auto read_counter = [&inst](uint64_t value) -> uint32_t {
+        inst.latched_hi = static_cast<uint32_t>(value >> 32);
+        return static_cast<uint32_t>(value);
+    };
+
+    if( addr == DLA_DMA_CSR_OFFSET_COMPLETION_COUNT ) {
+        return inst.completion_count;
+    } else if( addr == DLA_DMA_CSR_OFFSET_INTERRUPT_CONTROL ) {
+        return inst.interrupt_pending;
+    } else if( addr == DLA_DMA_CSR_OFFSET_LICENSE_FLAG ) {
+        return 1;
+    } else if( addr == DLA_DMA_CSR_OFFSET_DESC_DIAGNOSTICS ) {
+        return 0;
+    } else if( addr == DLA_DMA_CSR_OFFSET_DEBUG_NETWORK_VALID ) {
+        return 0;  // there is nothing attached to the debug network
+    } else if( addr == DLA_DMA_CSR_OFFSET_CLOCKS_ACTIVE_LO ) {
+        return read_counter(inst.clocks_active);
+    } else if( addr == DLA_DMA_CSR_OFFSET_CLOCKS_ALL_JOBS_LO ) {
+        return read_counter(inst.clocks_all_jobs);
+    } else if( (addr == DLA_DMA_CSR_OFFSET_INPUT_FEATURE_READ_COUNT_LO) ||
+               (addr == DLA_DMA_CSR_OFFSET_INPUT_FILTER_READ_COUNT_LO) ||
+               (addr == DLA_DMA_CSR_OFFSET_OUTPUT_FEATURE_WRITE_COUNT_LO) ) {
+        return read_counter(0);  // memory traffic is not modelled
+    } else if( (addr == DLA_DMA_CSR_OFFSET_CLOCKS_ACTIVE_HI) ||
+               (addr == DLA_DMA_CSR_OFFSET_CLOCKS_ALL_JOBS_HI) ||
+               (addr == DLA_DMA_CSR_OFFSET_INPUT_FEATURE_READ_COUNT_HI) ||
+               (addr == DLA_DMA_CSR_OFFSET_INPUT_FILTER_READ_COUNT_HI) ||
+               (addr == DLA_DMA_CSR_OFFSET_OUTPUT_FEATURE_WRITE_COUNT_HI) ) {
+        return inst.latched_hi;
+    }
+
+    // Everything else, including the bitstream ROM, reads back what was last written
+    return inst.regs[addr / sizeof(uint32_t)];
+}
+
+void mock_device::csr_write(int instance, uint32_t addr, uint32_t value)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( instance >= _config.num_instances ) {
+            return;
+        }
+        mock_instance &inst = _instances[instance];
+
+        if( addr == DLA_DMA_CSR_OFFSET_INTERRUPT_CONTROL ) {
+            inst.interrupt_pending &= ~value;  // write 1 to clear
+            return;
+        }
+        inst.regs[addr / sizeof(uint32_t)] = value;
+        if( addr != DLA_DMA_CSR_OFFSET_INPUT_OUTPUT_BASE_ADDR ) {
+            return;
+        }
+        // Writing the input/output base address is what enqueues the job in hardware
+        submit_job(instance);
+    }
+    _cv.notify_all();
+}
+
+// Caller must hold _mutex
+void mock_device::submit_job(int instance)
+{
+    mock_instance &inst = _instances[instance];
+
+    if( inst.jobs.size() >= static_cast<size_t>(DLA_DMA_CSR_DESCRIPTOR_QUEUE_LOGICAL_SIZE) ) {
+        MOCK_ERR("instance %d descriptor queue overflow, %zu jobs outstanding\n", instance, inst.jobs.size());
+    }
+
+    mock_job job;
+    job.config_base = inst.regs[DLA_DMA_CSR_OFFSET_CONFIG_BASE_ADDR / sizeof(uint32_t)];
+    job.io_base = inst.regs[DLA_DMA_CSR_OFFSET_INPUT_OUTPUT_BASE_ADDR / sizeof(uint32_t)];
+
+    // The config reader streams (CONFIG_RANGE_MINUS_TWO + 2) 64-bit words before the job can run
+    double duration_us = _config.job_latency_us;
+    if( _config.ddr_bandwidth_mbps > 0 ) {
+        uint64_t config_bytes = (static_cast<uint64_t>(inst.regs[DLA_DMA_CSR_OFFSET_CONFIG_RANGE_MINUS_TWO / sizeof(uint32_t)]) + 2) * 8;
+        duration_us += config_bytes / _config.ddr_bandwidth_mbps;
+    }
+
+    // Jobs on one instance run back to back in the order they were submitted
+    clock::time_point now = clock::now();
+    job.start = inst.jobs.empty() ? now : std::max(now, inst.busy_until);
+    job.finish = job.start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::micro>(duration_us));
+    inst.busy_until = job.finish;
+    inst.jobs.push_back(job);
+
+    if( _config.debug ) {
+        MOCK_INFO("instance %d job submitted, config 0x%llx io 0x%llx, %zu outstanding\n", instance,
+                  (unsigned long long)job.config_base, (unsigned long long)job.io_base, inst.jobs.size());
+    }
+}
+
+uint64_t mock_device::us_to_ddr_clocks(double us) const
+{
+    // The DMA CSR counters run on the DDR clock
+    return static_cast<uint64_t>(us * _config.ddr_clock_mhz);
+}
+
+void mock_device::transfer_delay(size_t size) const
+{
+    if( _config.ddr_bandwidth_mbps > 0 ) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(size / _config.ddr_bandwidth_mbps));
+    }
+}
+
+void mock_device::work_thread(mock_device &obj)
+{
+    obj.run_thread();
+}
+
+void mock_device::run_thread()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while( !_bShutdown ) {
+        // Find the earliest job to finish across all instances
+        int next = -1;
+        for( int i = 0; i < _config.num_instances; i++ ) {
+            if( _instances[i].jobs.empty() ) continue;
+            if( (next < 0) || (_instances[i].jobs.front().finish < _instances[next].jobs.front().finish) ) {
+                next = i;
+            }
+        }
+        if( next < 0 ) {
+            _cv.wait(lock);
+            continue;
+        }
+        if( clock::now() < _instances[next].jobs.front().finish ) {
+            // A new submission or shutdown re-evaluates the earliest job
+            _cv.wait_until(lock, _instances[next].jobs.front().finish);
+            continue;
+        }
+
+        mock_instance &inst = _instances[next];
+        mock_job job = inst.jobs.front();
+        inst.jobs.pop_front();
+
+        double run_us = std::chrono::duration<double, std::micro>(job.finish - job.start).count();
+        inst.completion_count++;
+        inst.clocks_active += us_to_ddr_clocks(run_us);
+        inst.clocks_all_jobs += us_to_ddr_clocks(run_us);
+        inst.interrupt_pending |= (1 << DLA_DMA_CSR_INTERRUPT_DONE_BIT);
+
+        if( _config.debug ) {
+            MOCK_INFO("instance %d job done, completion count %u\n", next, inst.completion_count);
+        }
+
+        bool raise = (inst.interrupt_pending & inst.regs[DLA_DMA_CSR_OFFSET_INTERRUPT_MASK / sizeof(uint32_t)]) != 0;
+        aocl_mmd_interrupt_handler_fn fn = _interrupt_fn;
+        void *user_data = _interrupt_fn_user_data;
+        if( raise && fn ) {
+            // The runtime ISR accesses the CSR, so it must be called without holding the lock
+            lock.unlock();
+            fn(_mmd_handle, user_data);
+            lock.lock();
+        }
+    }
+}
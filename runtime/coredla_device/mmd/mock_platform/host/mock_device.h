@@ -0,0 +1,151 @@
+#ifndef MOCK_DEVICE_H_
+#define MOCK_DEVICE_H_
+
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_device.h  ------------------------------------------------ C++ -*-=== */
+/*                                                                                 */
+/*                         mock device access functions                            */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+/*                                                                                 */
+/* Software model of the CoreDLA DMA CSR block. Each instance has a CSR register   */
+/* file, a job queue and a sparse DDR. Writing INPUT_OUTPUT_BASE_ADDR queues one   */
+/* job, a scheduler thread retires the jobs after the configured latency, bumps    */
+/* the completion counter and clock counters, and raises the done interrupt if    */
+/* it is unmasked. Interrupt handlers are only ever called from the scheduler     */
+/* thread, so the runtime ISR is never re-entered, same as on hardware.           */
+/*                                                                                 */
+/* The model is configured through environment variables, read once at open:      */
+/*   MOCK_MMD_NUM_INSTANCES       instances that respond to CSR accesses (1)      */
+/*   MOCK_MMD_DDR_SIZE_MB         DDR size per instance (4096)                    */
+/*   MOCK_MMD_JOB_LATENCY_US      fixed compute time of one job (1000)            */
+/*   MOCK_MMD_DDR_BANDWIDTH_MBPS  host<->DDR and config read bandwidth, 0 means   */
+/*                                transfers are free (0)                          */
+/*   MOCK_MMD_COREDLA_CLOCK_MHZ   reported clk_dla frequency (400)                */
+/*   MOCK_MMD_STREAM_CONTROLLER   add a stream controller mailbox, see            */
+/*                                mock_stream_controller.h. "legacy" models       */
+/*                                firmware that predates ScheduleItems            */
+/*   MOCK_MMD_MAP_DDR             map the DDR into the process, so the runtime    */
+/*                                reads and writes the features in place          */
+/*   MOCK_MMD_DEBUG               print every job submission and completion       */
+/*                                                                                 */
+/* The bitstream ROM reads back as zeros, so the runtime must be run with         */
+/* DLA_DISABLE_ARCH_CHECK=1 and DLA_DISABLE_VERSION_CHECK=1.                      */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "aocl_mmd.h"
+#include "mock_memory.h"
+#include "mock_stream_controller.h"
+#include "mock_types.h"
+
+struct mock_config {
+  int num_instances = 1;
+  uint64_t ddr_size = 4096ULL << 20;
+  double job_latency_us = 1000.0;
+  double ddr_bandwidth_mbps = 0.0;
+  double ddr_clock_mhz = 333.333333;
+  double coredla_clock_mhz = 400.0;
+  bool stream_controller = false;
+  bool stream_controller_legacy = false;
+  bool map_ddr = false;
+  bool debug = false;
+
+  // Build the configuration from the MOCK_MMD_* environment variables
+  static mock_config from_env();
+};
+
+class mock_device
+{
+public:
+  mock_device(const mock_config &config, const int mmd_handle);
+  ~mock_device();
+
+  int write_block(aocl_mmd_op_t op, int mmd_interface, const void *host_addr, size_t offset, size_t size);
+  int read_block(aocl_mmd_op_t op, int mmd_interface, void *host_addr, size_t offset, size_t size);
+
+  int set_interrupt_handler(aocl_mmd_interrupt_handler_fn fn, void *user_data);
+
+  // Address 0 of the DDR of the instance in the process, nullptr unless MOCK_MMD_MAP_DDR is set
+  void *get_mapped_ddr(int instance, uint64_t &size);
+  int sync_mapped_ddr(int instance, uint64_t offset, uint64_t size, bool for_device);
+
+  bool stream_controller_valid() const { return _spStreamController != nullptr; }
+
+  const mock_config &config() const { return _config; }
+
+private:
+  typedef std::chrono::steady_clock clock;
+
+  // CoreDLA CSR spec says the CSR is 2048 bytes of 32-bit registers
+  static constexpr size_t CSR_WORDS = MOCK_CSR_WINDOW_SIZE / sizeof(uint32_t);
+
+  struct mock_job {
+    clock::time_point start;
+    clock::time_point finish;
+    uint64_t config_base;
+    uint64_t io_base;
+  };
+
+  struct mock_instance {
+    std::array<uint32_t, CSR_WORDS> regs = {};
+    std::deque<mock_job> jobs;        // submitted and not yet retired, in hardware order
+    clock::time_point busy_until;     // finish time of the last submitted job
+    uint32_t completion_count = 0;
+    uint32_t interrupt_pending = 0;
+    uint64_t clocks_active = 0;
+    uint64_t clocks_all_jobs = 0;
+    uint32_t latched_hi = 0;          // upper half of the last 64-bit counter whose lower half was read
+    mock_memory_ptr spMemory;
+  };
+
+  uint32_t csr_read(int instance, uint32_t addr);
+  void csr_write(int instance, uint32_t addr, uint32_t value);
+  void submit_job(int instance);
+  uint64_t us_to_ddr_clocks(double us) const;
+  void transfer_delay(size_t size) const;
+
+  static void work_thread(mock_device &obj);
+  void run_thread();  // Retires jobs and delivers interrupts
+
+  mock_device() = delete;
+  mock_device(mock_device const&) = delete;
+  void operator=(mock_device const &) = delete;
+
+  mock_config _config;
+  int _mmd_handle;
+  std::vector<mock_instance> _instances;
+  mock_stream_controller_ptr _spStreamController;  // nullptr unless MOCK_MMD_STREAM_CONTROLLER is set
+
+  std::mutex _mutex;  // Guards _instances, the handler and _bShutdown
+  std::condition_variable _cv;
+  bool _bShutdown = {false};
+  std::thread *_pThread = {nullptr};
+
+  aocl_mmd_interrupt_handler_fn _interrupt_fn = {nullptr};
+  void                          *_interrupt_fn_user_data = {nullptr};
+};
+typedef std::shared_ptr<mock_device> mock_device_ptr;
+
+#endif // MOCK_DEVICE_H_
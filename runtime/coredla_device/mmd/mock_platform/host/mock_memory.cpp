@@ -0,0 +1,115 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#include "mock_memory.h"
+#include "mock_types.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+mock_memory::mock_memory(uint64_t size, bool mapped)
+: _size(size)
+{
+    if( mapped ) {
+        void *pMapped = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if( pMapped == MAP_FAILED ) {
+            MOCK_ERR("Failed to map %llu bytes of device memory, using pages\n", (unsigned long long)_size);
+        } else {
+            _pMapped = static_cast<uint8_t *>(pMapped);
+        }
+    }
+}
+
+mock_memory::~mock_memory()
+{
+    if( _pMapped ) {
+        munmap(_pMapped, _size);
+    }
+}
+
+int mock_memory::read_block(void *host_addr, uint64_t offset, size_t size)
+{
+    if( (offset > _size) || (size > _size - offset) ) {
+        return FAILURE;
+    }
+
+    // Nothing to copy when the host already reads the mapped address, the host buffer may itself be in the mapping
+    if( _pMapped ) {
+        if( host_addr != _pMapped + offset ) {
+            memmove(host_addr, _pMapped + offset, size);
+        }
+        return SUCCESS;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint8_t *dst = static_cast<uint8_t *>(host_addr);
+    while( size ) {
+        uint64_t page = offset / PAGE_SIZE;
+        uint64_t page_offset = offset % PAGE_SIZE;
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size, PAGE_SIZE - page_offset));
+
+        auto it = _pages.find(page);
+        if( it == _pages.end() ) {
+            memset(dst, 0, chunk);  // never written, DDR model reads back as zero
+        } else {
+            memcpy(dst, it->second.get() + page_offset, chunk);
+        }
+
+        dst += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+    return SUCCESS;
+}
+
+int mock_memory::write_block(const void *host_addr, uint64_t offset, size_t size)
+{
+    if( (offset > _size) || (size > _size - offset) ) {
+        return FAILURE;
+    }
+
+    if( _pMapped ) {
+        if( host_addr != _pMapped + offset ) {
+            memmove(_pMapped + offset, host_addr, size);
+        }
+        return SUCCESS;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const uint8_t *src = static_cast<const uint8_t *>(host_addr);
+    while( size ) {
+        uint64_t page = offset / PAGE_SIZE;
+        uint64_t page_offset = offset % PAGE_SIZE;
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size, PAGE_SIZE - page_offset));
+
+        std::unique_ptr<uint8_t[]> &spPage = _pages[page];
+        if( !spPage ) {
+            spPage.reset(new uint8_t[PAGE_SIZE]());
+        }
+        memcpy(spPage.get() + page_offset, src, chunk);
+
+        src += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+    return SUCCESS;
+}
+
+uint64_t mock_memory::resident_bytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pages.size() * PAGE_SIZE;
+}
@@ -0,0 +1,68 @@
+#ifndef MOCK_MEMORY_H_
+#define MOCK_MEMORY_H_
+
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_memory.h  ------------------------------------------------ C++ -*-=== */
+/*                                                                                 */
+/*                         mock device memory                                      */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+/*                                                                                 */
+/* Sparse host-memory model of the FPGA DDR. Pages are only allocated once they    */
+/* are written, reads of pages that were never written return zeros. This lets the */
+/* mock advertise the same multi-GB DDR per instance as the real boards without    */
+/* reserving that much host memory.                                                */
+/*                                                                                 */
+/* A mapped memory is one anonymous mapping of the whole size instead, so the host */
+/* can read and write it in place like the mapped DDR of the HPS board. The kernel */
+/* only backs the pages that are touched.                                          */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class mock_memory
+{
+public:
+  mock_memory(uint64_t size, bool mapped);
+  ~mock_memory();
+
+  int read_block(void *host_addr, uint64_t offset, size_t size);
+  int write_block(const void *host_addr, uint64_t offset, size_t size);
+
+  uint64_t size() const { return _size; }
+  // Host memory currently backing the device memory, in bytes. Not tracked for a mapped memory, returns 0
+  uint64_t resident_bytes() const;
+  // Start of the mapping, nullptr unless the memory is mapped
+  void *mapped_address() const { return _pMapped; }
+
+private:
+  static constexpr uint64_t PAGE_SIZE = 64 * 1024;
+
+  mock_memory() = delete;
+  mock_memory(mock_memory const&) = delete;
+  void operator=(mock_memory const &) = delete;
+
+  uint64_t _size;
+  uint8_t *_pMapped = {nullptr};
+  mutable std::mutex _mutex;
+  std::unordered_map<uint64_t, std::unique_ptr<uint8_t[]>> _pages;
+};
+typedef std::shared_ptr<mock_memory> mock_memory_ptr;
+
+#endif // MOCK_MEMORY_H_
@@ -0,0 +1,299 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_mmd.cpp  ------------------------------------------------- C++ -*-=== */
+/*                                                                                 */
+/*                         Mock MMD Driver                                         */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+/*                                                                                 */
+/* This file implements the functions that are defined in aocl_mmd.h on top of    */
+/* the mock_device software model. No FPGA, driver or board support package is     */
+/* needed, which makes it possible to run the runtime, the plugin and dla_benchmark */
+/* on any host to exercise the host-side code paths.                               */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "aocl_mmd.h"
+#include "mock_device.h"
+
+#define MOCK_MMD_VERSION AOCL_MMD_VERSION_STRING
+#define MAX_NAME_SIZE (1204)
+
+#define RESULT_INT(X)                                  \
+  {                                                    \
+    *((int *)param_value) = X;                         \
+    if (param_size_ret) *param_size_ret = sizeof(int); \
+  }
+#define RESULT_STR(X)                                                                     \
+  do {                                                                                    \
+    size_t Xlen = strnlen(X, MAX_NAME_SIZE) + 1;                                          \
+    memcpy((void *)param_value, X, (param_value_size <= Xlen) ? param_value_size : Xlen); \
+    if (param_size_ret) *param_size_ret = Xlen;                                           \
+  } while (0)
+#define ACL_VENDOR_NAME "Intel"
+int aocl_mmd_get_offline_info(aocl_mmd_offline_info_t requested_info_id,
+                              size_t param_value_size,
+                              void *param_value,
+                              size_t *param_size_ret) {
+  switch (requested_info_id) {
+    case AOCL_MMD_VERSION:
+      RESULT_STR(MOCK_MMD_VERSION);
+      break;
+    case AOCL_MMD_NUM_BOARDS:
+      RESULT_INT(1);
+      break;
+    case AOCL_MMD_BOARD_NAMES:
+      RESULT_STR(MOCK_BOARD_NAME);
+      break;
+    case AOCL_MMD_VENDOR_NAME:
+      RESULT_STR(ACL_VENDOR_NAME);
+      break;
+    case AOCL_MMD_VENDOR_ID:
+      RESULT_INT(0);
+      break;
+    case AOCL_MMD_USES_YIELD:
+      RESULT_INT(0);
+      break;
+    case AOCL_MMD_MEM_TYPES_SUPPORTED:
+      RESULT_INT(AOCL_MMD_PHYSICAL_MEMORY);
+      break;
+  }
+  return 0;
+}
+
+#undef RESULT_INT
+#undef RESULT_STR
+
+// Same idea as the DeviceMapManager of the HPS MMD, the destructor closes any device the runtime
+// left open so the scheduler thread is joined before the process exits.
+class MockDeviceMapManager final {
+public:
+  typedef std::map<int, mock_device_ptr> map_handle_to_dev_t;
+
+  int add_device(const char *name)
+  {
+    if( strcmp(name, MOCK_BOARD_NAME) != 0 ) {
+      MOCK_ERR("Unknown board name '%s'\n", name);
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    int handle = idx++;
+    mock_config config = mock_config::from_env();
+    last_config = config;
+    have_config = true;
+    if( config.debug ) {
+      MOCK_INFO("opening %s, %d instance(s), %.1f us per job, %.1f MB/s DDR bandwidth\n", name,
+                config.num_instances, config.job_latency_us, config.ddr_bandwidth_mbps);
+    }
+    handle_to_dev.insert({handle, std::make_shared<mock_device>(config, handle)});
+    return handle;
+  }
+
+  mock_device_ptr get_device(const int handle)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = handle_to_dev.find(handle);
+    if( it == handle_to_dev.end() ) {
+      MOCK_ERR("Invalid handle %d\n", handle);
+      return nullptr;
+    }
+    return it->second;
+  }
+
+  // The board queries have no handle, they get the configuration read when the last device was opened
+  mock_config get_config()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return have_config ? last_config : mock_config::from_env();
+  }
+
+  bool remove_device(const int handle)
+  {
+    mock_device_ptr spDevice;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = handle_to_dev.find(handle);
+      if( it == handle_to_dev.end() ) {
+        MOCK_ERR("Handle %d does not exist\n", handle);
+        return false;
+      }
+      spDevice = it->second;
+      handle_to_dev.erase(it);
+    }
+    // spDevice is released here, outside the lock, which joins the scheduler thread
+    return true;
+  }
+
+private:
+  std::mutex          mutex;
+  map_handle_to_dev_t handle_to_dev = {};
+  int                 idx = {0};
+  mock_config         last_config;
+  bool                have_config = {false};
+};
+static MockDeviceMapManager _gDeviceMapManager;
+
+int aocl_mmd_get_info(
+  int handle, aocl_mmd_info_t requested_info_id, size_t param_value_size, void *param_value, size_t *param_size_ret) {
+  MOCK_ERR("aocl_mmd_get_info not supported on platform.\n");
+  return FAILURE;
+}
+
+// Open and initialize the named device.
+int AOCL_MMD_CALL aocl_mmd_open(const char *name) {
+  return _gDeviceMapManager.add_device(name);
+}
+
+// Close an opened device, by its handle.
+int AOCL_MMD_CALL aocl_mmd_close(int handle) {
+  if ( _gDeviceMapManager.remove_device(handle) )
+    return SUCCESS;
+  return FAILURE;
+}
+
+// Set the interrupt handler for the opened device.
+int AOCL_MMD_CALL aocl_mmd_set_interrupt_handler(int handle, aocl_mmd_interrupt_handler_fn fn, void *user_data) {
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return FAILURE;
+  }
+  return spDevice->set_interrupt_handler(fn, user_data);
+}
+
+// Read, write and copy operations on a single interface.
+int AOCL_MMD_CALL aocl_mmd_read(int handle, aocl_mmd_op_t op, size_t len, void *dst, int mmd_interface, size_t offset) {
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return FAILURE;
+  }
+  return spDevice->read_block(op, mmd_interface, dst, offset, len);
+}
+
+int AOCL_MMD_CALL
+aocl_mmd_write(int handle, aocl_mmd_op_t op, size_t len, const void *src, int mmd_interface, size_t offset) {
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return FAILURE;
+  }
+  return spDevice->write_block(op, mmd_interface, src, offset, len);
+}
+
+#ifdef DLA_MMD
+// Query functions to get board-specific values
+AOCL_MMD_CALL int dla_mmd_get_max_num_instances() {
+  return MOCK_MAX_INSTANCES;
+}
+
+AOCL_MMD_CALL uint64_t dla_mmd_get_ddr_size_per_instance() {
+  return _gDeviceMapManager.get_config().ddr_size;
+}
+
+// The mock uses the same 333.333333 MHz DDR clock as the AGX7 boards, the clock counters
+// in the CSR model are scaled with this value
+AOCL_MMD_CALL double dla_mmd_get_ddr_clock_freq() {
+  return mock_config().ddr_clock_mhz;
+}  // MHz
+
+// Helper functions for the wrapper functions around CSR and DDR
+uint64_t dla_get_raw_csr_address(int instance, uint64_t addr) {
+  return (MOCK_CSR_WINDOW_SIZE * instance) + addr;
+}
+uint64_t dla_get_raw_ddr_address(int instance, uint64_t addr) {
+  return (dla_mmd_get_ddr_size_per_instance() * instance) + addr;
+}
+
+// Wrappers around CSR and DDR reads and writes to abstract away board-specific offsets
+AOCL_MMD_CALL int dla_mmd_csr_write(int handle, int instance, uint64_t addr, const uint32_t *data) {
+  return aocl_mmd_write(
+      handle, NULL, sizeof(uint32_t), data, MOCK_MMD_COREDLA_CSR_HANDLE, dla_get_raw_csr_address(instance, addr));
+}
+AOCL_MMD_CALL int dla_mmd_csr_read(int handle, int instance, uint64_t addr, uint32_t *data) {
+  return aocl_mmd_read(
+      handle, NULL, sizeof(uint32_t), data, MOCK_MMD_COREDLA_CSR_HANDLE, dla_get_raw_csr_address(instance, addr));
+}
+AOCL_MMD_CALL int dla_mmd_ddr_write(int handle, int instance, uint64_t addr, uint64_t length, const void *data) {
+  return aocl_mmd_write(handle, NULL, length, data, MOCK_MMD_MEMORY_HANDLE, dla_get_raw_ddr_address(instance, addr));
+}
+AOCL_MMD_CALL int dla_mmd_ddr_read(int handle, int instance, uint64_t addr, uint64_t length, void *data) {
+  return aocl_mmd_read(handle, NULL, length, data, MOCK_MMD_MEMORY_HANDLE, dla_get_raw_ddr_address(instance, addr));
+}
+
+// The model has no DMA engine, stage the whole range on the host which also takes care of overlap
+AOCL_MMD_CALL int dla_mmd_ddr_copy(int handle, int instance, uint64_t src_addr, uint64_t dst_addr, uint64_t length) {
+  std::vector<uint8_t> staging(length);
+  int status = dla_mmd_ddr_read(handle, instance, src_addr, length, staging.data());
+  if( status != SUCCESS ) {
+    return status;
+  }
+  return dla_mmd_ddr_write(handle, instance, dst_addr, length, staging.data());
+}
+
+#ifdef DDR_MAP_ACCESS
+AOCL_MMD_CALL void *dla_mmd_ddr_map(int handle, int instance, uint64_t *length) {
+  if( length ) *length = 0;
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return nullptr;
+  }
+  uint64_t size = 0;
+  void *pMapped = spDevice->get_mapped_ddr(instance, size);
+  if( length ) *length = size;
+  return pMapped;
+}
+
+AOCL_MMD_CALL int dla_mmd_ddr_sync(int handle, int instance, uint64_t addr, uint64_t length, int to_device) {
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return FAILURE;
+  }
+  return spDevice->sync_mapped_ddr(instance, addr, length, to_device != 0);
+}
+#endif
+
+#ifdef STREAM_CONTROLLER_ACCESS
+// There is one stream controller per board, same as the HPS platform
+AOCL_MMD_CALL bool dla_is_stream_controller_valid(int handle, int instance) {
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return false;
+  }
+  return spDevice->stream_controller_valid();
+}
+
+AOCL_MMD_CALL int dla_mmd_stream_controller_write(int handle, int instance, uint64_t addr, uint64_t length, const void *data) {
+  return aocl_mmd_write(handle, NULL, length, data, MOCK_MMD_STREAM_CONTROLLER_HANDLE, addr);
+}
+
+AOCL_MMD_CALL int dla_mmd_stream_controller_read(int handle, int instance, uint64_t addr, uint64_t length, void *data) {
+  return aocl_mmd_read(handle, NULL, length, data, MOCK_MMD_STREAM_CONTROLLER_HANDLE, addr);
+}
+#endif
+
+AOCL_MMD_CALL double dla_mmd_get_coredla_clock_freq(int handle) {
+  mock_device_ptr spDevice = _gDeviceMapManager.get_device(handle);
+  if( nullptr == spDevice ) {
+    return 0;
+  }
+  return spDevice->config().coredla_clock_mhz;
+}  // MHz
+#endif
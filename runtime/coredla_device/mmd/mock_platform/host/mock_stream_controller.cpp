@@ -0,0 +1,207 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_stream_controller.cpp  ----------------------------------- C++ -*-=== */
+/*                                                                                 */
+/*                         mock stream controller                                  */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+/*                                                                                 */
+/* This file implements the mailbox RAM and the firmware message handlers          */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+
+#include "mock_stream_controller.h"
+
+#include <string.h>
+
+#include <cstddef>
+#include <cstdio>
+
+#include "mock_types.h"
+
+static const uint32_t messageReadyMagicNumber = 0x55225522;
+
+/////////////////////////////////////////////////////////
+mock_stream_controller::mock_stream_controller(bool debug, bool legacy)
+: _debug(debug)
+, _legacy(legacy)
+{
+    _pThread = new std::thread(work_thread, std::ref(*this));
+}
+
+mock_stream_controller::~mock_stream_controller()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bShutdown = true;
+    }
+    _cv.notify_all();
+    if( _pThread ) {
+        _pThread->join();
+        delete _pThread;
+        _pThread = nullptr;
+    }
+}
+
+int mock_stream_controller::write_block(const void *host_addr, size_t offset, size_t size)
+{
+    if( (offset % sizeof(uint32_t)) || (size % sizeof(uint32_t)) || (offset + size > MAILBOX_SIZE) ) {
+        MOCK_ERR("stream controller accesses must be 32-bit words within the %zu byte mailbox\n", MAILBOX_SIZE);
+        return FAILURE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        memcpy(&_mailbox[offset / sizeof(uint32_t)], host_addr, size);
+    }
+    _cv.notify_all();
+    return SUCCESS;
+}
+
+int mock_stream_controller::read_block(void *host_addr, size_t offset, size_t size)
+{
+    if( (offset % sizeof(uint32_t)) || (size % sizeof(uint32_t)) || (offset + size > MAILBOX_SIZE) ) {
+        MOCK_ERR("stream controller accesses must be 32-bit words within the %zu byte mailbox\n", MAILBOX_SIZE);
+        return FAILURE;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    memcpy(host_addr, &_mailbox[offset / sizeof(uint32_t)], size);
+    return SUCCESS;
+}
+
+// Same as ReceiveMessage in stream_controller.c
+void mock_stream_controller::receive_message()
+{
+    const uint32_t *message = _mailbox.data();
+    uint32_t message_type = message[offsetof(MessageHeader, _messageType) / sizeof(uint32_t)];
+    uint32_t sequence_id = message[offsetof(MessageHeader, _sequenceID) / sizeof(uint32_t)];
+    const uint32_t *payload = message + offsetof(MessageHeader, _payload) / sizeof(uint32_t);
+
+    bool ok = true;
+    if( message_type == MessageType_GetStatus ) {
+        StatusMessagePayload status;
+        status._status = _status;
+        status._statusLineNumber = _status_line_number;
+        status._numReceivedSourceBuffers = 0;
+        status._numScheduledInferences = 0;
+        status._numExecutedJobs = _num_executed_jobs;
+        send_message(MessageType_Status, &status, sizeof(status));
+    } else if( message_type == MessageType_ScheduleItem ) {
+        new_inference_request_received();
+        send_message(MessageType_NoOperation);
+    } else if( (message_type == MessageType_ScheduleItems) && !_legacy ) {
+        ok = schedule_items(payload);
+    } else if( message_type == MessageType_Ping ) {
+        if( _legacy ) {
+            send_message(MessageType_Pong);
+        } else {
+            PongPayload pong;
+            pong._capabilities = StreamControllerCapability_ScheduleItems;
+            send_message(MessageType_Pong, &pong, sizeof(pong));
+        }
+    } else if( message_type == MessageType_InitializeStreamController ) {
+        InitializeStreamControllerPayload initialize;
+        memcpy(&initialize, payload, sizeof(initialize));
+        _total_num_inference_requests = initialize._numInferenceRequests;
+        _status = NiosStatusType_OK;
+        _status_line_number = 0;
+        _num_inference_requests = 0;
+        _num_executed_jobs = 0;
+        _last_receive_sequence_id = 0;
+        _send_sequence_id = 0;
+        _running = false;
+        send_message(MessageType_NoOperation);
+    } else {
+        // The manual DMA and inference messages need the msgdma and DLA, which are not modelled
+        ok = false;
+    }
+
+    if( !ok ) {
+        MOCK_ERR("stream controller rejected message type %u\n", message_type);
+        set_status(NiosStatusType_BadMessage, __LINE__);
+    }
+
+    _mailbox[0] = sequence_id;
+
+    if( (_last_receive_sequence_id != 0) && ((_last_receive_sequence_id + 1) != sequence_id) ) {
+        if( (sequence_id != 0) || (message_type != MessageType_InitializeStreamController) ) {
+            set_status(NiosStatusType_BadMessageSequence, __LINE__);
+        }
+    }
+    _last_receive_sequence_id = sequence_id;
+
+    if( _debug ) {
+        MOCK_INFO("stream controller message type %u sequence %u, %u inference requests\n", message_type,
+                  sequence_id, _num_inference_requests);
+    }
+}
+
+// Same as ScheduleItemsMessageHandler in message_handlers.c
+bool mock_stream_controller::schedule_items(const uint32_t *payload)
+{
+    uint32_t num_items = payload[offsetof(ScheduleItemsPayload, _numItems) / sizeof(uint32_t)];
+    if( num_items > MaxScheduleItemsPerMessage ) {
+        return false;
+    }
+    for( uint32_t i = 0; i < num_items; i++ ) {
+        new_inference_request_received();
+    }
+    send_message(MessageType_NoOperation);
+    return true;
+}
+
+// The counting part of NewInferenceRequestReceived in stream_controller.c
+void mock_stream_controller::new_inference_request_received()
+{
+    bool was_running = _running;
+    _num_inference_requests++;
+    _running = (_num_inference_requests >= _total_num_inference_requests);
+    if( was_running ) {
+        _num_executed_jobs++;
+    }
+}
+
+void mock_stream_controller::send_message(MessageType message_type, const void *payload, size_t payload_size)
+{
+    uint32_t *message = &_mailbox[MAILBOX_WORDS / 2];
+    message[offsetof(MessageHeader, _messageType) / sizeof(uint32_t)] = message_type;
+    message[offsetof(MessageHeader, _sequenceID) / sizeof(uint32_t)] = _send_sequence_id;
+    if( payload_size > 0 ) {
+        memcpy(message + offsetof(MessageHeader, _payload) / sizeof(uint32_t), payload, payload_size);
+    }
+    message[offsetof(MessageHeader, _messageReadyMagicNumber) / sizeof(uint32_t)] = messageReadyMagicNumber;
+    _send_sequence_id++;
+}
+
+void mock_stream_controller::set_status(NiosStatusType status, uint32_t line_number)
+{
+    _status = status;
+    _status_line_number = line_number;
+}
+
+void mock_stream_controller::work_thread(mock_stream_controller &obj)
+{
+    obj.run_thread();
+}
+
+void mock_stream_controller::run_thread()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while( !_bShutdown ) {
+        if( _mailbox[0] == messageReadyMagicNumber ) {
+            receive_message();
+        } else {
+            _cv.wait(lock);
+        }
+    }
+}
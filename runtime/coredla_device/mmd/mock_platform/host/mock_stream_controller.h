@@ -0,0 +1,94 @@
+#ifndef MOCK_STREAM_CONTROLLER_H_
+#define MOCK_STREAM_CONTROLLER_H_
+
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_stream_controller.h  ------------------------------------- C++ -*-=== */
+/*                                                                                 */
+/*                         mock stream controller                                  */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+/*                                                                                 */
+/* Software model of the stream controller mailbox RAM and of the message loop of  */
+/* the NIOS-V firmware in stream_controller/app. A firmware thread is woken by     */
+/* every host write, and handles a message once the ready magic number is written */
+/* at offset 0: it writes the reply to the second half of the mailbox, then the   */
+/* sequence ID over the magic number, in the same order as the firmware.          */
+/*                                                                                 */
+/* Inference requests and the firmware counters are tracked the same way as      */
+/* NewInferenceRequestReceived, there is no msgdma so no source buffer is ever     */
+/* received and no inference is scheduled with the DLA.                           */
+/*                                                                                 */
+/* In legacy mode the firmware predates ScheduleItems: the Pong has no payload and */
+/* a ScheduleItems message is rejected like any unknown message type.             */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "stream_controller_messages.h"
+
+class mock_stream_controller
+{
+public:
+  mock_stream_controller(bool debug, bool legacy);
+  ~mock_stream_controller();
+
+  int write_block(const void *host_addr, size_t offset, size_t size);
+  int read_block(void *host_addr, size_t offset, size_t size);
+
+private:
+  static constexpr size_t MAILBOX_SIZE = 0x1000;
+  static constexpr size_t MAILBOX_WORDS = MAILBOX_SIZE / sizeof(uint32_t);
+
+  // Caller must hold _mutex for all of these
+  void receive_message();
+  bool schedule_items(const uint32_t *payload);
+  void new_inference_request_received();
+  void send_message(MessageType message_type, const void *payload = nullptr, size_t payload_size = 0);
+  void set_status(NiosStatusType status, uint32_t line_number);
+
+  static void work_thread(mock_stream_controller &obj);
+  void run_thread();  // Polls the receive half of the mailbox like the firmware main loop
+
+  mock_stream_controller() = delete;
+  mock_stream_controller(mock_stream_controller const&) = delete;
+  void operator=(mock_stream_controller const &) = delete;
+
+  bool _debug;
+  bool _legacy;
+  std::array<uint32_t, MAILBOX_WORDS> _mailbox = {};
+
+  // Firmware state, reset by InitializeStreamController
+  NiosStatusType _status = NiosStatusType_OK;
+  uint32_t _status_line_number = 0;
+  uint32_t _num_inference_requests = 0;
+  uint32_t _total_num_inference_requests = 0;
+  uint32_t _num_executed_jobs = 0;
+  uint32_t _last_receive_sequence_id = 0;
+  uint32_t _send_sequence_id = 0;
+  bool _running = false;
+
+  std::mutex _mutex;  // Guards the mailbox, the firmware state and _bShutdown
+  std::condition_variable _cv;
+  bool _bShutdown = {false};
+  std::thread *_pThread = {nullptr};
+};
+typedef std::shared_ptr<mock_stream_controller> mock_stream_controller_ptr;
+
+#endif // MOCK_STREAM_CONTROLLER_H_
@@ -0,0 +1,53 @@
+#ifndef MOCK_TYPES_H_
+#define MOCK_TYPES_H_
+
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+/* ===- mock_types.h  ------------------------------------------------- C++ -*-=== */
+/*                                                                                 */
+/*                         Useful mock MMD Types                                   */
+/*                                                                                 */
+/* ===-------------------------------------------------------------------------=== */
+
+#define SUCCESS (0)
+#define FAILURE (1)
+
+typedef enum {
+  MOCK_MMD_COREDLA_CSR_HANDLE = 1, // COREDLA CSR Interface
+  MOCK_MMD_MEMORY_HANDLE = 2,      // Device Memory transfers
+  MOCK_MMD_STREAM_CONTROLLER_HANDLE = 3, // Stream controller mailbox
+} mock_mmd_interface_t;
+
+// Name reported through AOCL_MMD_BOARD_NAMES, there is only ever one mock board
+#define MOCK_BOARD_NAME "mock0"
+
+// Upper bound on the number of CoreDLA instances, same as the AGX7 PCIe boards
+#define MOCK_MAX_INSTANCES (4)
+
+// Spacing between the CSR windows of consecutive instances
+#define MOCK_CSR_WINDOW_SIZE (0x800)
+
+#define MOCK_ERR(...)                                 \
+  do {                                                \
+    fprintf(stderr, "MOCK MMD ERROR: " __VA_ARGS__);  \
+    fflush(stderr);                                   \
+  } while (0)
+
+#define MOCK_INFO(...)                                \
+  do {                                                \
+    printf("MOCK MMD INFO : " __VA_ARGS__);           \
+    fflush(stdout);                                   \
+  } while (0)
+
+#endif // MOCK_TYPES_H_
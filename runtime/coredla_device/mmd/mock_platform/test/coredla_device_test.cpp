@@ -0,0 +1,289 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+// Opens CoreDlaDevice on the mock board and runs jobs to completion on every instance at once. On each instance
+// several threads start jobs and wait for their own ticket with WaitForDlaJob, then a batch of jobs is waited for with
+// WaitForDla. The buffers come from the device memory allocator: the DDR is fragmented by freeing buffers in between
+// and compacted between two rounds of jobs, and the data in the buffers that moved must be preserved. Run with
+// COREDLA_RUNTIME_COMPLETION_MODE set to interrupt, polling or adaptive. With MOCK_MMD_MAP_DDR set the inputs are
+// filled in place in the mapped DDR and the outputs are read from there.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "coredla_batch_job.h"
+#include "coredla_device.h"
+
+struct CoreDlaDeviceTestAccess {
+  static MmdWrapper* GetMmdWrapper(CoreDlaDevice& device) { return &device.mmdWrapper_; }
+  static std::atomic<uint64_t>* GetJobsSubmitted(CoreDlaDevice& device, int instance) {
+    return &device.isrData_.jobsSubmitted[instance];
+  }
+  static DeviceMemoryAllocator& GetAllocator(CoreDlaDevice& device, int instance) {
+    return device.ddrAllocator_[instance];
+  }
+};
+
+static constexpr uint32_t waitForDlaTimeoutSeconds = 10;
+static constexpr uint32_t numThreads = 4;
+static constexpr uint32_t numJobsPerThread = 25;
+static constexpr uint32_t numUntrackedJobs = 8;
+static constexpr uint64_t featureSize = 4096;
+static constexpr uint64_t configSize = 4096;
+static constexpr uint64_t intermediateSize = 1 << 20;
+static constexpr uint64_t spacerSize = 1 << 16;
+
+// Buffers in DDR are aligned as CoreDlaGraphJob does
+static constexpr uint64_t featureWordSize = 32;
+static constexpr uint64_t filterWordSize = 64;
+
+static std::mutex outputMutex;
+
+static void Fail(int instance, const std::string& msg) {
+  std::lock_guard<std::mutex> lock(outputMutex);
+  std::cout << "Instance " << instance << ": " << msg << "\n";
+}
+
+static std::vector<uint32_t> MakePattern(int instance, uint32_t thread, uint32_t job, uint64_t size) {
+  std::vector<uint32_t> data(size / sizeof(uint32_t));
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = ((instance << 24) | (thread << 16) | job) ^ static_cast<uint32_t>(i * 2654435761u);
+  }
+  return data;
+}
+
+static bool CheckDDR(MmdWrapper* mmdWrapper, int instance, uint64_t addr, const std::vector<uint32_t>& expected) {
+  std::vector<uint32_t> data(expected.size());
+  mmdWrapper->ReadFromDDR(instance, addr, data.size() * sizeof(uint32_t), data.data());
+  return std::memcmp(data.data(), expected.data(), data.size() * sizeof(uint32_t)) == 0;
+}
+
+struct TestJob {
+  uint64_t inputOutputAddr;
+  std::unique_ptr<BatchJob> batchJob;
+};
+
+// Every thread has its own batch job, loads a new input and waits for the job it started
+static bool RunJobs(CoreDlaDevice& device, int instance, std::vector<TestJob>& jobs) {
+  std::atomic<bool> ok{true};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      try {
+        for (uint32_t j = 0; j < numJobsPerThread; j++) {
+          std::vector<uint32_t> input = MakePattern(instance, t, j, featureSize);
+          void* mappedInput = jobs[t].batchJob->GetMappedInputFeature();
+          if (mappedInput) {
+            std::memcpy(mappedInput, input.data(), featureSize);
+            jobs[t].batchJob->LoadInputFeatureToDDR(mappedInput);
+          } else {
+            jobs[t].batchJob->LoadInputFeatureToDDR(input.data());
+          }
+          device.WaitForDlaJob(instance, jobs[t].batchJob->GetJobId(), t);
+        }
+      } catch (const std::exception& e) {
+        Fail(instance, e.what());
+        ok = false;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  return ok;
+}
+
+static bool TestInstance(CoreDlaDevice& device, int instance) {
+  MmdWrapper* mmdWrapper = CoreDlaDeviceTestAccess::GetMmdWrapper(device);
+  DeviceMemoryAllocator& allocator = CoreDlaDeviceTestAccess::GetAllocator(device, instance);
+  std::atomic<uint64_t>* jobsSubmitted = CoreDlaDeviceTestAccess::GetJobsSubmitted(device, instance);
+
+  allocator.AllocateSharedBuffer(intermediateSize, instance);
+  std::vector<uint32_t> config = MakePattern(instance, 0xff, 0, configSize);
+  uint64_t configAddr;
+  if (allocator.AllocateConstantBuffer(config.data(), configSize, filterWordSize, configAddr)) {
+    mmdWrapper->WriteToDDR(instance, configAddr, configSize, config.data());
+  }
+
+  // A spacer below every input/output buffer, freeing them leaves the free space in pieces
+  std::vector<TestJob> jobs(numThreads);
+  std::vector<uint64_t> spacerAddrs(numThreads);
+  for (uint32_t t = 0; t < numThreads; t++) {
+    uint64_t addr;
+    allocator.AllocatePrivateBuffer(2 * featureSize, featureWordSize, addr);
+    jobs[t].inputOutputAddr = addr;
+    jobs[t].batchJob = CoreDlaBatchJob::MakeUnique(mmdWrapper, configSize, configAddr, addr, addr + featureSize,
+                                                   featureSize, featureSize, false, false, instance, jobsSubmitted,
+                                                   nullptr);
+    allocator.AllocatePrivateBuffer(spacerSize, featureWordSize, spacerAddrs[t]);
+  }
+
+  bool ok = true;
+  const bool mapDDR = std::getenv("MOCK_MMD_MAP_DDR") != nullptr;
+  for (auto& job : jobs) {
+    if ((job.batchJob->GetMappedInputFeature() != nullptr) != mapDDR ||
+        (job.batchJob->GetMappedOutputFeature() != nullptr) != mapDDR) {
+      Fail(instance, mapDDR ? "the features are not mapped" : "the features are mapped without MOCK_MMD_MAP_DDR");
+      ok = false;
+    }
+  }
+
+  ok = RunJobs(device, instance, jobs) && ok;
+
+  for (uint64_t addr : spacerAddrs) allocator.FreePrivateBuffer(addr);
+  if (allocator.GetLargestFreeBlockSize() == allocator.GetFreeSize()) {
+    Fail(instance, "freeing the spacers did not fragment the DDR");
+    ok = false;
+  }
+
+  // Follow the buffers as CoreDlaGraphJob::RelocateBuffer does
+  uint32_t numMoved = 0;
+  allocator.Compact(instance, [&](uint64_t oldAddr, uint64_t newAddr) {
+    numMoved++;
+    if (oldAddr == configAddr) {
+      configAddr = newAddr;
+      for (auto& job : jobs) static_cast<CoreDlaBatchJob*>(job.batchJob.get())->RelocateConfigBuffer(newAddr);
+      return;
+    }
+    for (auto& job : jobs) {
+      if (job.inputOutputAddr == oldAddr) {
+        job.inputOutputAddr = newAddr;
+        static_cast<CoreDlaBatchJob*>(job.batchJob.get())->RelocateInputOutputBuffer(newAddr, newAddr + featureSize);
+      }
+    }
+  });
+  if (numMoved != numThreads - 1) {
+    Fail(instance, "compaction moved " + std::to_string(numMoved) + " buffers, expected " +
+                       std::to_string(numThreads - 1));
+    ok = false;
+  }
+  if (allocator.GetLargestFreeBlockSize() != allocator.GetFreeSize()) {
+    Fail(instance, "the free DDR is not contiguous after compaction");
+    ok = false;
+  }
+  if (!CheckDDR(mmdWrapper, instance, configAddr, config)) {
+    Fail(instance, "the config buffer changed");
+    ok = false;
+  }
+  for (uint32_t t = 0; t < numThreads; t++) {
+    if (!CheckDDR(mmdWrapper, instance, jobs[t].inputOutputAddr,
+                  MakePattern(instance, t, numJobsPerThread - 1, featureSize))) {
+      Fail(instance, "the input of thread " + std::to_string(t) + " was not preserved by compaction");
+      ok = false;
+    }
+  }
+
+  ok = RunJobs(device, instance, jobs) && ok;
+
+  // The mock does not compute, so the output is what was written to DDR. It reads back the same from the mapping and
+  // through a copy into a host buffer.
+  for (uint32_t t = 0; t < numThreads; t++) {
+    std::vector<uint32_t> expected = MakePattern(instance, t, 0xffff, featureSize);
+    mmdWrapper->WriteToDDR(instance, jobs[t].inputOutputAddr + featureSize, featureSize, expected.data());
+    std::vector<uint32_t> output(expected.size());
+    jobs[t].batchJob->ReadOutputFeatureFromDDR(output.data());
+    bool same = output == expected;
+    void* mappedOutput = jobs[t].batchJob->GetMappedOutputFeature();
+    if (mappedOutput) {
+      jobs[t].batchJob->ReadOutputFeatureFromDDRAsync(mappedOutput).get();
+      same = same && std::memcmp(mappedOutput, expected.data(), featureSize) == 0;
+    }
+    if (!same) {
+      Fail(instance, "the output of thread " + std::to_string(t) + " does not read back");
+      ok = false;
+    }
+  }
+
+  // Callers that do not track tickets
+  for (uint32_t j = 0; j < numUntrackedJobs; j++) jobs[0].batchJob->StartDla();
+  try {
+    for (uint32_t j = 0; j < numUntrackedJobs; j++) device.WaitForDla(instance);
+  } catch (const std::exception& e) {
+    Fail(instance, e.what());
+    ok = false;
+  }
+
+  const int numJobs = 2 * numThreads * numJobsPerThread + numUntrackedJobs;
+  if (device.GetNumInferencesCompleted(instance) != numJobs) {
+    Fail(instance, std::to_string(device.GetNumInferencesCompleted(instance)) + " jobs completed, expected " +
+                       std::to_string(numJobs));
+    ok = false;
+  }
+
+  for (auto& job : jobs) {
+    job.batchJob.reset();
+    allocator.FreePrivateBuffer(job.inputOutputAddr);
+  }
+  allocator.FreeConstantBuffer(configAddr);
+  allocator.FreeSharedBuffer(intermediateSize);
+  if (allocator.GetFreeSize() != mmdWrapper->GetDDRSizePerInstance()) {
+    Fail(instance, "DDR is still allocated after freeing all buffers");
+    ok = false;
+  }
+
+  // Every wait is counted by exactly one completion path
+  DebugNetworkData stats = device.GetCompletionStats(instance);
+  const uint64_t numWaits = numJobs;
+  const uint64_t polled = stats["Completions found by polling"];
+  const uint64_t afterInterrupt = stats["Completions after interrupt"];
+  if (stats["Completions already finished"] + polled + afterInterrupt != numWaits) {
+    Fail(instance, "the completion stats do not add up to " + std::to_string(numWaits) + " waits");
+    ok = false;
+  }
+  const char* completionMode = std::getenv("COREDLA_RUNTIME_COMPLETION_MODE");
+  std::string mode = completionMode ? completionMode : "";
+  if ((mode == "interrupt" && polled != 0) || (mode == "polling" && afterInterrupt != 0)) {
+    Fail(instance, "a job completion was seen by the wrong path for " + mode + " mode");
+    ok = false;
+  }
+  if (mode == "adaptive" && polled == 0) {
+    Fail(instance, "the adaptive spin never saw a job finish");
+    ok = false;
+  }
+
+  return ok;
+}
+
+int main() {
+  std::unique_ptr<CoreDlaDevice> device;
+  try {
+    device.reset(new CoreDlaDevice(waitForDlaTimeoutSeconds));
+  } catch (const std::exception& e) {
+    std::cout << "Failed to open the device: " << e.what() << "\n";
+    return 1;
+  }
+
+  std::atomic<bool> ok{true};
+  std::vector<std::thread> instanceThreads;
+  for (int instance = 0; instance < device->GetNumInstances(); instance++) {
+    instanceThreads.emplace_back([&, instance]() {
+      try {
+        if (!TestInstance(*device, instance)) ok = false;
+      } catch (const std::exception& e) {
+        Fail(instance, e.what());
+        ok = false;
+      }
+    });
+  }
+  for (auto& thread : instanceThreads) thread.join();
+
+  std::cout << device->GetNumInstances() << " instance(s), " << (ok ? "Passed\n" : "Failed\n");
+  return ok ? 0 : 1;
+}
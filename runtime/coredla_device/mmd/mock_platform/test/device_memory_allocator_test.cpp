@@ -0,0 +1,207 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+// Allocates, frees and compacts buffers with DeviceMemoryAllocator in the DDR of the mock board. Checks where the
+// buffers are placed, that freed neighbors are merged into one block, that constant buffers are shared by content, and
+// that Compact moves the data of every buffer along with it and reports each move.
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "device_memory_allocator.h"
+
+static constexpr uint64_t totalSize = 1 << 20;
+static constexpr uint64_t alignment = 64;
+static constexpr uint64_t bufferSize = 4096;
+
+static int numFailures = 0;
+
+static void Check(bool condition, const std::string& what) {
+  if (!condition) {
+    std::cout << "Failed: " << what << "\n";
+    numFailures++;
+  }
+}
+
+static std::vector<uint8_t> MakePattern(uint64_t seed, uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint8_t>(seed * 37 + i * 7 + (i >> 8));
+  return data;
+}
+
+static bool CheckDDR(MmdWrapper& mmdWrapper, uint64_t addr, const std::vector<uint8_t>& expected) {
+  std::vector<uint8_t> data(expected.size());
+  mmdWrapper.ReadFromDDR(0, addr, data.size(), data.data());
+  return data == expected;
+}
+
+static bool Throws(const std::function<void()>& function) {
+  try {
+    function();
+  } catch (const std::runtime_error&) {
+    return true;
+  }
+  return false;
+}
+
+static void TestAllocateAndFree(MmdWrapper& mmdWrapper) {
+  DeviceMemoryAllocator allocator;
+  allocator.Initialize(totalSize, &mmdWrapper);
+
+  // Private buffers are stacked from the top of DDR down
+  uint64_t addrs[4];
+  for (uint64_t& addr : addrs) allocator.AllocatePrivateBuffer(bufferSize, alignment, addr);
+  for (int i = 0; i < 4; i++) {
+    Check(addrs[i] == totalSize - (i + 1) * bufferSize, "buffer " + std::to_string(i) + " is stacked below the last");
+  }
+  Check(allocator.GetFreeSize() == totalSize - 4 * bufferSize, "free size after allocating");
+
+  // The padding for the alignment stays with the buffer
+  uint64_t alignedAddr;
+  allocator.AllocatePrivateBuffer(bufferSize + 100, bufferSize, alignedAddr);
+  Check(alignedAddr == totalSize - 6 * bufferSize, "the address is rounded down to the alignment");
+  allocator.FreePrivateBuffer(alignedAddr);
+  Check(allocator.GetFreeSize() == totalSize - 4 * bufferSize, "freeing an aligned buffer frees its padding");
+
+  // Freeing two neighbors leaves one hole that fits both, and the new buffer goes to the top of the hole
+  allocator.FreePrivateBuffer(addrs[1]);
+  allocator.FreePrivateBuffer(addrs[2]);
+  uint64_t mergedAddr;
+  allocator.AllocatePrivateBuffer(2 * bufferSize, alignment, mergedAddr);
+  Check(mergedAddr == addrs[2], "the freed neighbors are merged");
+  Check(allocator.GetLargestFreeBlockSize() == allocator.GetFreeSize(), "no hole is left after refilling it");
+
+  // Freeing in any order merges back into the whole DDR
+  allocator.FreePrivateBuffer(addrs[0]);
+  allocator.FreePrivateBuffer(addrs[3]);
+  allocator.FreePrivateBuffer(mergedAddr);
+  Check(allocator.GetFreeSize() == totalSize && allocator.GetLargestFreeBlockSize() == totalSize,
+        "everything is free again");
+  Check(Throws([&]() { allocator.FreePrivateBuffer(mergedAddr); }), "a buffer cannot be freed twice");
+
+  // The shared buffer grows from address 0 and shrinks to the largest size still needed
+  allocator.AllocateSharedBuffer(8 * bufferSize, 0);
+  allocator.AllocateSharedBuffer(2 * bufferSize, 0);
+  Check(allocator.GetFreeSize() == totalSize - 8 * bufferSize, "the shared buffer takes the largest size");
+  allocator.FreeSharedBuffer(8 * bufferSize);
+  Check(allocator.GetFreeSize() == totalSize - 2 * bufferSize, "the shared buffer shrinks");
+  Check(Throws([&]() { allocator.FreeSharedBuffer(8 * bufferSize); }), "a shared buffer size cannot be freed twice");
+  allocator.FreeSharedBuffer(2 * bufferSize);
+
+  // A buffer larger than the largest free block fails even if the total would fit
+  uint64_t bigAddrs[3];
+  allocator.AllocatePrivateBuffer(totalSize / 4, alignment, bigAddrs[0]);
+  allocator.AllocatePrivateBuffer(totalSize / 4, alignment, bigAddrs[1]);
+  allocator.AllocatePrivateBuffer(totalSize / 4, alignment, bigAddrs[2]);
+  allocator.FreePrivateBuffer(bigAddrs[1]);
+  uint64_t tooBigAddr;
+  Check(Throws([&]() { allocator.AllocatePrivateBuffer(totalSize / 2, alignment, tooBigAddr); }),
+        "a fragmented DDR refuses a buffer larger than any hole");
+  Check(Throws([&]() { allocator.AllocateSharedBuffer(totalSize / 2, 0); }),
+        "the shared buffer cannot grow into a private buffer");
+}
+
+static void TestConstantBuffers(MmdWrapper& mmdWrapper) {
+  DeviceMemoryAllocator allocator;
+  allocator.Initialize(totalSize, &mmdWrapper);
+
+  std::vector<uint8_t> constants = MakePattern(1, bufferSize);
+  std::vector<uint8_t> otherConstants = MakePattern(2, bufferSize);
+  uint64_t addr1, addr2, addr3;
+  Check(allocator.AllocateConstantBuffer(constants.data(), bufferSize, alignment, addr1), "first copy is uploaded");
+  Check(!allocator.AllocateConstantBuffer(constants.data(), bufferSize, alignment, addr2), "second copy is shared");
+  Check(addr1 == addr2, "identical constants share the address");
+  Check(allocator.AllocateConstantBuffer(otherConstants.data(), bufferSize, alignment, addr3),
+        "different constants are uploaded");
+  Check(addr3 != addr1, "different constants get their own buffer");
+
+  allocator.FreeConstantBuffer(addr1);
+  Check(allocator.GetFreeSize() == totalSize - 2 * bufferSize, "a shared buffer stays while it is referenced");
+  allocator.FreeConstantBuffer(addr2);
+  allocator.FreeConstantBuffer(addr3);
+  Check(allocator.GetFreeSize() == totalSize, "constant buffers are freed with the last reference");
+}
+
+static void TestCompact(MmdWrapper& mmdWrapper) {
+  DeviceMemoryAllocator allocator;
+  allocator.Initialize(totalSize, &mmdWrapper);
+  allocator.AllocateSharedBuffer(bufferSize, 0);
+
+  // Buffers of different sizes and alignments, with data, every other one is freed again
+  struct Buffer {
+    uint64_t addr;
+    uint64_t size;
+    std::vector<uint8_t> data;
+    bool kept;
+  };
+  std::vector<Buffer> buffers;
+  std::vector<uint8_t> constants = MakePattern(100, bufferSize);
+  uint64_t constantAddr;
+  allocator.AllocateConstantBuffer(constants.data(), bufferSize, alignment, constantAddr);
+  mmdWrapper.WriteToDDR(0, constantAddr, bufferSize, constants.data());
+  for (uint64_t i = 0; i < 12; i++) {
+    Buffer buffer;
+    buffer.size = bufferSize * (1 + i % 3) + 64 * i;
+    buffer.data = MakePattern(i, buffer.size);
+    buffer.kept = (i % 2) == 1;
+    allocator.AllocatePrivateBuffer(buffer.size, (i % 4 == 1) ? 4096 : alignment, buffer.addr);
+    mmdWrapper.WriteToDDR(0, buffer.addr, buffer.size, buffer.data.data());
+    buffers.push_back(buffer);
+  }
+  for (const Buffer& buffer : buffers) {
+    if (!buffer.kept) allocator.FreePrivateBuffer(buffer.addr);
+  }
+  Check(allocator.GetLargestFreeBlockSize() < allocator.GetFreeSize(), "freeing every other buffer fragments the DDR");
+
+  std::map<uint64_t, uint64_t> moves;
+  allocator.Compact(0, [&](uint64_t oldAddr, uint64_t newAddr) {
+    Check(newAddr > oldAddr, "buffers only move up");
+    Check(moves.emplace(oldAddr, newAddr).second, "each buffer is reported once");
+  });
+  for (Buffer& buffer : buffers) {
+    if (!buffer.kept) continue;
+    auto move = moves.find(buffer.addr);
+    if (move != moves.end()) buffer.addr = move->second;
+    Check(CheckDDR(mmdWrapper, buffer.addr, buffer.data), "the data moves with the buffer");
+  }
+  Check(moves.find(constantAddr) == moves.end(), "the buffer at the top does not move");
+  Check(CheckDDR(mmdWrapper, constantAddr, constants), "the constants are untouched");
+  Check(allocator.GetLargestFreeBlockSize() == allocator.GetFreeSize(), "the free DDR is contiguous");
+
+  // The allocator follows the moved buffers, so they can still be shared and freed at their new address
+  uint64_t sharedAddr;
+  Check(!allocator.AllocateConstantBuffer(constants.data(), bufferSize, alignment, sharedAddr) &&
+            sharedAddr == constantAddr,
+        "the constants are still found by content");
+  allocator.FreeConstantBuffer(sharedAddr);
+  allocator.FreeConstantBuffer(constantAddr);
+  for (const Buffer& buffer : buffers) {
+    if (buffer.kept) allocator.FreePrivateBuffer(buffer.addr);
+  }
+  allocator.FreeSharedBuffer(bufferSize);
+  Check(allocator.GetFreeSize() == totalSize, "all buffers are freed at their new address");
+}
+
+int main() {
+  MmdWrapper mmdWrapper;
+  TestAllocateAndFree(mmdWrapper);
+  TestConstantBuffers(mmdWrapper);
+  TestCompact(mmdWrapper);
+
+  std::cout << (numFailures == 0 ? "Passed\n" : "Failed\n");
+  return numFailures == 0 ? 0 : 1;
+}
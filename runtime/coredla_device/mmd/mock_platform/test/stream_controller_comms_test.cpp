@@ -0,0 +1,89 @@
+// Copyright 2024 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+// Schedules inference requests with StreamControllerComms against the mock stream controller, from several
+// threads at once while another thread keeps polling the status, as the plugin does at startup. Every request
+// must reach the firmware and the firmware must not report an error. Run with MOCK_MMD_STREAM_CONTROLLER=1 for
+// ScheduleItems batches, or =legacy for firmware that only knows ScheduleItem.
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "stream_controller_comms.h"
+
+static constexpr uint32_t numInferenceRequests = 4;
+static constexpr uint32_t numThreads = 4;
+static constexpr uint32_t numItemsPerThread = 250;
+static constexpr uint32_t numBulkItems = 300;
+
+int main() {
+  StreamControllerComms comms;
+  if (!comms.IsPresent()) {
+    std::cout << "No stream controller, set MOCK_MMD_STREAM_CONTROLLER\n";
+    return 1;
+  }
+  if (!comms.Initialize(1024, 0, numInferenceRequests)) {
+    std::cout << "Initialize failed\n";
+    return 1;
+  }
+
+  std::atomic<bool> stop{false};
+  std::thread statusThread([&]() {
+    while (!stop) comms.GetStatus();
+  });
+
+  // One item per call like CoreDlaBatchJob, so the calls overlap and get merged into batches
+  std::atomic<uint32_t> numFailedCalls{0};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (uint32_t i = 0; i < numItemsPerThread; i++) {
+        Payload<CoreDlaJobPayload> item{};
+        item._inputAddressDDR = t * numItemsPerThread + i;
+        if (!comms.ScheduleItems({item})) numFailedCalls++;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  // More than one message worth in a single call
+  std::vector<Payload<CoreDlaJobPayload>> bulkItems(numBulkItems);
+  if (!comms.ScheduleItems(bulkItems)) numFailedCalls++;
+
+  stop = true;
+  statusThread.join();
+
+  Payload<StatusMessagePayload> status = comms.GetStatus();
+  std::cout << "Status " << comms.GetStatusString(status) << "\n";
+
+  // The firmware starts once it holds numInferenceRequests requests, every later one retires a job
+  uint32_t numItems = numThreads * numItemsPerThread + numBulkItems;
+  uint32_t expectedExecutedJobs = numItems - numInferenceRequests;
+  bool ok = true;
+  if (numFailedCalls != 0) {
+    std::cout << numFailedCalls << " ScheduleItems calls failed\n";
+    ok = false;
+  }
+  if (status._status != NiosStatusType_OK) {
+    std::cout << "The stream controller reports an error\n";
+    ok = false;
+  }
+  if (status._numExecutedJobs != expectedExecutedJobs) {
+    std::cout << "Expected " << expectedExecutedJobs << " executed jobs, got " << status._numExecutedJobs << "\n";
+    ok = false;
+  }
+
+  std::cout << (ok ? "Passed\n" : "Failed\n");
+  return ok ? 0 : 1;
+}
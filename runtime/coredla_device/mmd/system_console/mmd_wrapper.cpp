@@ -19,11 +19,13 @@
 #include "mmd_wrapper.h"
 #include "dla_dma_constants.h"  // DLA_DMA_CSR_OFFSET_***
 
+#include <algorithm>  // std::min
 #include <cassert>    // assert
 #include <cstddef>    // size_t
 #include <iostream>   // std::cerr
 #include <stdexcept>  // std::runtime_error
 #include <string>     // std::string
+#include <vector>     // std::vector
 
 #include <boost/process.hpp>
 #include <boost/filesystem.hpp>
@@ -41,10 +43,20 @@
 #include <mutex>
 #include <fstream> // std::ofstream
 
+#ifndef _WIN32
+#include <cerrno>      // errno
+#include <fcntl.h>     // open
+#include <poll.h>      // poll
+#include <sys/stat.h>  // mkfifo
+#include <unistd.h>    // read, write, close
+#endif
+
 #define xstr(s) _str(s)
 #define _str(s)  #s
 
 #define DLA_SYSTEM_CONSOLE_TIMEOUT_MS 80000
+// CSR writes queued before they are sent to system console as one command line
+#define DLA_SYSCON_MAX_QUEUED_CSR_WRITES 64
 
 // All board variants must obey the CoreDLA CSR spec, which says that all access must be
 // - 32 bits in size
@@ -80,6 +92,19 @@ static std::ofstream loggerFile;
 static const std::string loggerFileName = "csr_log.txt";
 static MmdLogLevel csrLogLevel;
 
+// CSR writes don't return anything, so they are queued and put in front of the next command that does (a CSR read or
+// a DDR transfer) on the same Tcl command line, which then costs one prompt wait. System console runs the commands in
+// order, so this does not change what the IP sees.
+static bool batch_csr_writes;
+static std::string queued_csr_writes;
+static size_t num_queued_csr_writes;
+
+// Named pipes for DDR transfers, see dla_open_streams in system_console_script.tcl. -1 when the temporary files are used
+static int stream_to_host_fd = -1;
+static int stream_from_host_fd = -1;
+static boost::filesystem::path stream_to_host_path;
+static boost::filesystem::path stream_from_host_path;
+
 static int capture_till_prompt(bp::ipstream& out, std::ostream& capture)
 {
   std::array<char, 4096> line_buffer;
@@ -148,21 +173,46 @@ static void send_command(bp::opstream& in, std::string command)
   }
 }
 
-static void write_to_csr(bp::opstream& in, bp::ipstream& out, uint32_t addr, uint32_t data) {
-  std::lock_guard<std::mutex> lock{syscon_mutex};
-  addr += DLA_CSR_BASE_ADDRESS;
-  send_command(in, "master_write_32 $::g_dla_csr_service " + str( boost::format("0x%|08x| 0x%|08x|") % addr % data));
+// Returns the queued CSR writes as a prefix for the next command line and clears the queue, the caller must hold
+// syscon_mutex. Only the result of the last command on a line is printed, so the reply parsing is not affected.
+static std::string take_csr_writes() {
+  std::string writes;
+  writes.swap(queued_csr_writes);
+  num_queued_csr_writes = 0;
+  return writes;
+}
+
+// Send the queued CSR writes on their own, the caller must hold syscon_mutex
+static void flush_csr_writes(bp::opstream& in, bp::ipstream& out) {
+  if (num_queued_csr_writes == 0) return;
+  send_command(in, queued_csr_writes);
+  queued_csr_writes.clear();
+  num_queued_csr_writes = 0;
   if (0 != wait_for_prompt(out))
   {
     throw std::runtime_error("Unexpected EOF");
   }
 }
 
+// Queue one CSR write, the caller must hold syscon_mutex
+static void queue_csr_write(bp::opstream& in, bp::ipstream& out, uint32_t addr, uint32_t data) {
+  addr += DLA_CSR_BASE_ADDRESS;
+  queued_csr_writes += "master_write_32 $::g_dla_csr_service " + str( boost::format("0x%|08x| 0x%|08x|; ") % addr % data);
+  if (++num_queued_csr_writes >= DLA_SYSCON_MAX_QUEUED_CSR_WRITES || !batch_csr_writes) {
+    flush_csr_writes(in, out);
+  }
+}
+
+static void write_to_csr(bp::opstream& in, bp::ipstream& out, uint32_t addr, uint32_t data) {
+  std::lock_guard<std::mutex> lock{syscon_mutex};
+  queue_csr_write(in, out, addr, data);
+}
+
 static uint32_t read_from_csr(bp::opstream& in, bp::ipstream& out, uint32_t addr) {
   std::lock_guard<std::mutex> lock{syscon_mutex};
   uint32_t data;
   addr += DLA_CSR_BASE_ADDRESS;
-  send_command(in, "master_read_32 $::g_dla_csr_service " + str( boost::format("0x%|08x|") % addr ) + " 1");
+  send_command(in, take_csr_writes() + "master_read_32 $::g_dla_csr_service " + str( boost::format("0x%|08x|") % addr ) + " 1");
   std::basic_stringstream<char> s1;
   std::string captured;
   do {
@@ -181,6 +231,104 @@ static uint32_t read_from_csr(bp::opstream& in, bp::ipstream& out, uint32_t addr
   return data;
 }
 
+// Every system console command is a round trip over JTAG, so a batch is sent as one Tcl command line
+static void write_to_csr_batch(bp::opstream& in, bp::ipstream& out, const uint32_t* addrs, const uint32_t* data, size_t count) {
+  std::lock_guard<std::mutex> lock{syscon_mutex};
+  for (size_t i = 0; i < count; i++) {
+    queue_csr_write(in, out, addrs[i], data[i]);
+  }
+  flush_csr_writes(in, out);
+}
+
+// The values come back as one line of space separated hex numbers
+static void read_from_csr_batch(bp::opstream& in, bp::ipstream& out, const uint32_t* addrs, uint32_t* data, size_t count) {
+  std::lock_guard<std::mutex> lock{syscon_mutex};
+  std::string command = take_csr_writes() + "concat";
+  for (size_t i = 0; i < count; i++) {
+    uint32_t addr = addrs[i] + DLA_CSR_BASE_ADDRESS;
+    command += " [master_read_32 $::g_dla_csr_service " + str( boost::format("0x%|08x|") % addr ) + " 1]";
+  }
+  send_command(in, command);
+  std::basic_stringstream<char> s1;
+  std::string captured;
+  do {
+    if (0 != capture_till_prompt(out, s1))
+    {
+      throw std::runtime_error("Unexpected EOF");
+    }
+    captured = s1.str();
+  } while (std::all_of(captured.begin(), captured.end(), [](unsigned char c){return (std::isspace(c) || std::iscntrl(c));}));
+  std::istringstream values(captured);
+  std::string value;
+  for (size_t i = 0; i < count; i++) {
+    if (!(values >> value)) {
+      throw std::runtime_error("Expected " + std::to_string(count) + " CSR values from system console, got: " + captured);
+    }
+    data[i] = std::stoul(remove_non_alphanumeric(value), nullptr, 16);
+    if (loggerFile.is_open() && csrLogLevel > MmdLogLevel::DISABLE) {
+      loggerFile << "Read back: " << data[i] << std::endl;
+    }
+  }
+}
+
+#ifndef _WIN32
+// Move length bytes through one of the DDR stream pipes. System console produces or consumes the data while it runs
+// the command, if it fails part way the pipe goes quiet and the transfer times out instead of hanging.
+static void stream_transfer(int fd, char* read_data, const char* write_data, uint64_t length)
+{
+  const bool to_fpga = write_data != nullptr;
+  struct pollfd pfd = {fd, static_cast<short>(to_fpga ? POLLOUT : POLLIN), 0};
+  for (uint64_t done = 0; done < length;) {
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) {
+      throw std::runtime_error("Timeout while streaming DDR data to/from system console");
+    }
+    ssize_t count = to_fpga ? write(fd, write_data + done, length - done) : read(fd, read_data + done, length - done);
+    if (count < 0) {
+      if (errno == EINTR || errno == EAGAIN) continue;
+      throw std::runtime_error("Failed to stream DDR data to/from system console");
+    }
+    done += count;
+  }
+}
+
+static void open_ddr_streams(bp::opstream& in, bp::ipstream& out)
+{
+  boost::filesystem::path unique_name = boost::filesystem::unique_path();
+  stream_to_host_path = temp_file_path / (unique_name.generic_string() + "_to_host.fifo");
+  stream_from_host_path = temp_file_path / (unique_name.generic_string() + "_from_host.fifo");
+  if (mkfifo(stream_to_host_path.c_str(), 0600) != 0 || mkfifo(stream_from_host_path.c_str(), 0600) != 0) {
+    throw std::runtime_error("Failed to create the DDR stream pipes in " + temp_file_path.generic_string());
+  }
+  send_command(in, "dla_open_streams " + stream_to_host_path.generic_string() + " " + stream_from_host_path.generic_string());
+  if (0 != wait_for_prompt(out)) {
+    throw std::runtime_error("Unexpected EOF");
+  }
+  // system console holds both ends open, so neither open blocks
+  stream_to_host_fd = open(stream_to_host_path.c_str(), O_RDONLY | O_NONBLOCK);
+  stream_from_host_fd = open(stream_from_host_path.c_str(), O_WRONLY | O_NONBLOCK);
+  if (stream_to_host_fd < 0 || stream_from_host_fd < 0) {
+    throw std::runtime_error("Failed to open the DDR stream pipes");
+  }
+  std::cout << "Streaming DDR transfers through " << stream_to_host_path.generic_string() << " and "
+            << stream_from_host_path.generic_string() << std::endl;
+}
+
+static void close_ddr_streams(bp::opstream& in, bp::ipstream& out)
+{
+  if (stream_to_host_fd < 0) return;
+  send_command(in, "dla_close_streams");
+  wait_for_prompt(out);
+  close(stream_to_host_fd);
+  close(stream_from_host_fd);
+  stream_to_host_fd = -1;
+  stream_from_host_fd = -1;
+  boost::system::error_code ec;
+  boost::filesystem::remove(stream_to_host_path, ec);
+  boost::filesystem::remove(stream_from_host_path, ec);
+}
+#endif
+
 static void read_from_ddr(bp::opstream& in, bp::ipstream& out, uint64_t addr, uint64_t length, void* data)
 {
   std::lock_guard<std::mutex> lock{syscon_mutex};
@@ -188,9 +336,19 @@ static void read_from_ddr(bp::opstream& in, bp::ipstream& out, uint64_t addr, ui
   {
     throw std::runtime_error("null data");
   }
+#ifndef _WIN32
+  if (stream_to_host_fd >= 0) {
+    send_command(in, take_csr_writes() + "dla_stream_read_ddr " + str( boost::format("0x%|08x| 0x%|08x|") % addr % length ));
+    stream_transfer(stream_to_host_fd, static_cast<char *>(data), nullptr, length);
+    if (0 != wait_for_prompt(out)) {
+      throw std::runtime_error("Unexpected EOF");
+    }
+    return;
+  }
+#endif
   boost::filesystem::path temp_file_name = boost::filesystem::unique_path();
   boost::filesystem::path temppath = temp_file_path / temp_file_name;
-  send_command(in, "master_read_to_file $::g_emif_ddr_service " + temppath.generic_string() + str( boost::format(" 0x%|08x| 0x%|08x|") % addr % length ) );
+  send_command(in, take_csr_writes() + "master_read_to_file $::g_emif_ddr_service " + temppath.generic_string() + str( boost::format(" 0x%|08x| 0x%|08x|") % addr % length ) );
   if (0 != wait_for_prompt(out)) {
     throw std::runtime_error("Unexpected EOF");
   }
@@ -210,6 +368,16 @@ static void read_from_ddr(bp::opstream& in, bp::ipstream& out, uint64_t addr, ui
 static void write_to_ddr(bp::opstream& in, bp::ipstream& out, uint64_t addr, uint64_t length, const void* data)
 {
   std::lock_guard<std::mutex> lock{syscon_mutex};
+#ifndef _WIN32
+  if (stream_from_host_fd >= 0) {
+    send_command(in, take_csr_writes() + "dla_stream_write_ddr " + str( boost::format("0x%|08x| 0x%|08x|") % addr % length ));
+    stream_transfer(stream_from_host_fd, nullptr, static_cast<const char *>(data), length);
+    if (0 != wait_for_prompt(out)) {
+      throw std::runtime_error("Unexpected EOF");
+    }
+    return;
+  }
+#endif
   boost::filesystem::path temp_file_name = boost::filesystem::unique_path();
   boost::filesystem::path temppath = temp_file_path / temp_file_name;
   boost::filesystem::ofstream ofs(temppath, std::ios::out | std::ios::binary);
@@ -218,7 +386,7 @@ static void write_to_ddr(bp::opstream& in, bp::ipstream& out, uint64_t addr, uin
   }
   ofs.write(static_cast<const char *>(data), length);
   ofs.close();
-  send_command(in, "master_write_from_file $::g_emif_ddr_service " + temppath.generic_string() + str( boost::format(" 0x%|08x|") % addr ) );
+  send_command(in, take_csr_writes() + "master_write_from_file $::g_emif_ddr_service " + temppath.generic_string() + str( boost::format(" 0x%|08x|") % addr ) );
   if (0 != wait_for_prompt(out))
   {
     throw std::runtime_error("Unexpected EOF");
@@ -354,9 +522,28 @@ MmdWrapper::MmdWrapper(bool enableLog) {
 
   // Initialize the handle_ object to a dummy value. It is not relevant to this MMD
   handle_ = 0;
+
+  // From here on CSR writes may be queued, the clock measurement above needed them to take effect right away
+  batch_csr_writes = env.find("DLA_SYSCON_DISABLE_BATCHING") == env.end();
+
+  // The temporary files are kept for debugging, so stream DDR transfers only when they would be deleted anyway
+#ifndef _WIN32
+  if (env.find("DLA_SYSCON_STREAM_DDR") != env.end() && !preserve_temp_files) {
+    open_ddr_streams(in, out);
+  }
+#endif
 }
 
 MmdWrapper::~MmdWrapper() {
+  try {
+    std::lock_guard<std::mutex> lock{syscon_mutex};
+    flush_csr_writes(in, out);
+#ifndef _WIN32
+    close_ddr_streams(in, out);
+#endif
+  } catch (const std::runtime_error& e) {
+    std::cerr << "Failed to flush system console commands: " << e.what() << std::endl;
+  }
   send_command(in, "close_services");
   if (wait_for_prompt(out))
   {
@@ -404,6 +591,30 @@ uint32_t MmdWrapper::ReadFromCsr(int instance, uint32_t addr) const {
   return read_from_csr(in, out, addr);
 }
 
+void MmdWrapper::WriteToCsrCached(int instance, uint32_t addr, uint32_t data) const {
+  {
+    std::lock_guard<std::mutex> lock(csrShadowMutex_);
+    auto it = csrShadow_.find(std::make_pair(instance, addr));
+    if (it != csrShadow_.end() && it->second == data) return;
+  }
+  write_to_csr(in, out, addr, data);
+  std::lock_guard<std::mutex> lock(csrShadowMutex_);
+  csrShadow_[std::make_pair(instance, addr)] = data;
+}
+
+void MmdWrapper::InvalidateCsrCache(int instance) const {
+  std::lock_guard<std::mutex> lock(csrShadowMutex_);
+  csrShadow_.clear();
+}
+
+void MmdWrapper::WriteToCsrBatch(int instance, const uint32_t *addrs, const uint32_t *data, size_t count) const {
+  write_to_csr_batch(in, out, addrs, data, count);
+}
+
+void MmdWrapper::ReadFromCsrBatch(int instance, const uint32_t *addrs, uint32_t *data, size_t count) const {
+  read_from_csr_batch(in, out, addrs, data, count);
+}
+
 void MmdWrapper::WriteToDDR(int instance, uint64_t addr, uint64_t length, const void *data) const {
   write_to_ddr(in, out, addr, length, data);
 }
@@ -412,6 +623,45 @@ void MmdWrapper::ReadFromDDR(int instance, uint64_t addr, uint64_t length, void
   read_from_ddr(in, out, addr, length, data);
 }
 
+// There is no DMA behind system console, the transfer has completed by the time the future is returned
+std::future<void> MmdWrapper::WriteToDDRAsync(int instance, uint64_t addr, uint64_t length, const void *data) const {
+  std::promise<void> done;
+  write_to_ddr(in, out, addr, length, data);
+  done.set_value();
+  return done.get_future();
+}
+
+std::future<void> MmdWrapper::ReadFromDDRAsync(int instance, uint64_t addr, uint64_t length, void *data) const {
+  std::promise<void> done;
+  read_from_ddr(in, out, addr, length, data);
+  done.set_value();
+  return done.get_future();
+}
+
+// System console has no device side copy, bounce the data through the host. When moving data upwards the
+// chunks are copied starting from the end of the range so that overlapping ranges are handled.
+void MmdWrapper::CopyDDR(int instance, uint64_t dstAddr, uint64_t srcAddr, uint64_t length) const {
+  if (length == 0 || dstAddr == srcAddr) return;
+  constexpr uint64_t chunkSize = 1ULL << 20;
+  std::vector<uint8_t> staging(std::min(chunkSize, length));
+  for (uint64_t copied = 0; copied < length;) {
+    uint64_t count = std::min(chunkSize, length - copied);
+    uint64_t offset = (dstAddr > srcAddr) ? (length - copied - count) : copied;
+    read_from_ddr(in, out, srcAddr + offset, count, staging.data());
+    write_to_ddr(in, out, dstAddr + offset, count, staging.data());
+    copied += count;
+  }
+}
+
+// Device memory is behind JTAG, it cannot be mapped
+void *MmdWrapper::GetMappedDDR(int instance, uint64_t &length) const {
+  length = 0;
+  return nullptr;
+}
+
+// GetMappedDDR never returns a mapping, so there is nothing to sync
+void MmdWrapper::SyncMappedDDR(int instance, uint64_t addr, uint64_t length, bool toDevice) const {}
+
 #ifndef STREAM_CONTROLLER_ACCESS
 // Stream controller access is not supported by the platform abstraction
 bool MmdWrapper::bIsStreamControllerValid(int instance) const { return false; }
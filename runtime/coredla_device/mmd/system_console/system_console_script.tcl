@@ -81,6 +81,49 @@ proc initialization {} {
     }
 }
 
+#{{{ DDR streams
+# Bulk DDR transfers through two named pipes created by the host runtime, instead of a temporary file per transfer.
+# The host reads what dla_stream_read_ddr produces from the first pipe and writes the data for dla_stream_write_ddr
+# to the second one. Both sides always know the length so nobody waits for an EOF, and both ends are opened
+# read-write so that opening them never blocks.
+set ::g_const_stream_chunk 0x10000
+set ::g_stream_to_host ""
+set ::g_stream_from_host ""
+
+proc dla_open_streams {to_host from_host} {
+    set ::g_stream_to_host   [open $to_host {RDWR}]
+    set ::g_stream_from_host [open $from_host {RDWR}]
+    fconfigure $::g_stream_to_host   -translation binary -buffering full
+    fconfigure $::g_stream_from_host -translation binary -buffering full
+}
+
+proc dla_stream_read_ddr {addr length} {
+    for {set offset 0} {$offset < $length} {incr offset $::g_const_stream_chunk} {
+        set size [expr {min($::g_const_stream_chunk, $length - $offset)}]
+        set bytes [master_read_memory $::g_emif_ddr_service [expr {$addr + $offset}] $size]
+        puts -nonewline $::g_stream_to_host [binary format c* $bytes]
+    }
+    flush $::g_stream_to_host
+}
+
+proc dla_stream_write_ddr {addr length} {
+    for {set offset 0} {$offset < $length} {incr offset $::g_const_stream_chunk} {
+        set size [expr {min($::g_const_stream_chunk, $length - $offset)}]
+        binary scan [read $::g_stream_from_host $size] cu* bytes
+        master_write_memory $::g_emif_ddr_service [expr {$addr + $offset}] $bytes
+    }
+}
+
+proc dla_close_streams {} {
+    if {$::g_stream_to_host ne ""} {
+        close $::g_stream_to_host
+        close $::g_stream_from_host
+        set ::g_stream_to_host ""
+        set ::g_stream_from_host ""
+    }
+}
+#}}}
+
 proc close_services {} {
     close_service master $::g_dla_csr_service
     if {$::cl(enable_pmon) == 1} {
@@ -15,8 +15,15 @@
 #include "dla_dma_constants.h"  //DLA_DMA_CSR_OFFSET_***
 #include "stream_controller_comms.h"
 
+#include <iostream>  //std::cerr
+#include <mutex>     //std::mutex
+
 static constexpr int CONFIG_READER_DATA_BYTES = 8;
 
+// Held from taking a ticket until the job has been handed to the hardware, so that jobs started from different threads
+// reach the hardware in ticket order
+static std::mutex startDlaMutex;
+
 std::unique_ptr<BatchJob> CoreDlaBatchJob::MakeUnique(MmdWrapper* mmdWrapper,
                                                       uint64_t totalConfigWords,
                                                       uint64_t configBaseAddrDDR,
@@ -27,6 +34,7 @@ std::unique_ptr<BatchJob> CoreDlaBatchJob::MakeUnique(MmdWrapper* mmdWrapper,
                                                       const bool enableIstream,
                                                       const bool enableOstream,
                                                       int instance,
+                                                      std::atomic<uint64_t>* jobsSubmitted,
                                                       std::shared_ptr<StreamControllerComms> spStreamControllerComms) {
   return std::unique_ptr<BatchJob>(new CoreDlaBatchJob(mmdWrapper,
                                                        totalConfigWords,
@@ -38,6 +46,7 @@ std::unique_ptr<BatchJob> CoreDlaBatchJob::MakeUnique(MmdWrapper* mmdWrapper,
                                                        enableIstream,
                                                        enableOstream,
                                                        instance,
+                                                       jobsSubmitted,
                                                        spStreamControllerComms));
 }
 CoreDlaBatchJob::CoreDlaBatchJob(MmdWrapper* mmdWrapper,
@@ -50,6 +59,7 @@ CoreDlaBatchJob::CoreDlaBatchJob(MmdWrapper* mmdWrapper,
                                  const bool enableIstream,
                                  const bool enableOstream,
                                  int instance,
+                                 std::atomic<uint64_t>* jobsSubmitted,
                                  std::shared_ptr<StreamControllerComms> spStreamControllerComms)
 : mmdWrapper_(mmdWrapper)
 , instance_(instance)
@@ -61,15 +71,22 @@ CoreDlaBatchJob::CoreDlaBatchJob(MmdWrapper* mmdWrapper,
 , outputSizeDDR_(outputSizeDDR)
 , enableIstream_(enableIstream)
 , enableOstream_(enableOstream)
+, jobsSubmitted_(jobsSubmitted)
 , lastJobQueueNumber_(0)
 , spStreamControllerComms_(spStreamControllerComms) {
 }
 
 // This function must be called by a single thread
 // It can be called on a different thread than StartDla or WaitForDla
+// An input that was filled in place in the mapped device memory only needs the cache maintenance, anything else is
+// copied
 void CoreDlaBatchJob::LoadInputFeatureToDDR(void* inputArray) {
   mmdWrapper_->enableCSRLogger();
-  mmdWrapper_->WriteToDDR(instance_, inputAddrDDR_, inputSizeDDR_, inputArray);
+  if (inputArray == GetMappedFeature(inputAddrDDR_, inputSizeDDR_)) {
+    mmdWrapper_->SyncMappedDDR(instance_, inputAddrDDR_, inputSizeDDR_, true);
+  } else {
+    mmdWrapper_->WriteToDDR(instance_, inputAddrDDR_, inputSizeDDR_, inputArray);
+  }
   mmdWrapper_->disableCSRLogger();
   StartDla();
 }
@@ -89,7 +106,9 @@ void CoreDlaBatchJob::ScheduleInputFeature() const {
     item._inputAddressDDR = inputAddressDDR;
     item._outputAddressDDR = outputAddressDDR;
 
-    spStreamControllerComms_->ScheduleItems( { item } );
+    if (!spStreamControllerComms_->ScheduleItems( { item } )) {
+      std::cerr << "Failed to schedule an inference request with the stream controller" << std::endl;
+    }
   }
 }
 
@@ -105,13 +124,22 @@ void CoreDlaBatchJob::StartDla() {
 
   // intermediate buffer address was already set when the graph was loaded
 
-  // base address for config reader
-  mmdWrapper_->WriteToCsr(instance_, DLA_DMA_CSR_OFFSET_CONFIG_BASE_ADDR, configBaseAddrDDR_);
-
   // how many words for config reader to read
   // hardware wants the number of words minus 2 since the implementation is a down counter which ends at -1, the sign
   // bit is used to denote the end of the counter range
-  mmdWrapper_->WriteToCsr(instance_, DLA_DMA_CSR_OFFSET_CONFIG_RANGE_MINUS_TWO, (totalConfigWords_ / CONFIG_READER_DATA_BYTES) - 2);
+  const uint32_t configRangeMinusTwo = (totalConfigWords_ / CONFIG_READER_DATA_BYTES) - 2;
+
+  // base address and size for config reader
+  // these two only change when a different graph runs on this instance, so the writes are skipped when the registers
+  // already hold the values of this graph. The stream controller firmware also writes both registers when it schedules
+  // an inference, so the shadow copies cannot be trusted once it is in use.
+  if (spStreamControllerComms_) {
+    mmdWrapper_->WriteToCsr(instance_, DLA_DMA_CSR_OFFSET_CONFIG_BASE_ADDR, configBaseAddrDDR_);
+    mmdWrapper_->WriteToCsr(instance_, DLA_DMA_CSR_OFFSET_CONFIG_RANGE_MINUS_TWO, configRangeMinusTwo);
+  } else {
+    mmdWrapper_->WriteToCsrCached(instance_, DLA_DMA_CSR_OFFSET_CONFIG_BASE_ADDR, configBaseAddrDDR_);
+    mmdWrapper_->WriteToCsrCached(instance_, DLA_DMA_CSR_OFFSET_CONFIG_RANGE_MINUS_TWO, configRangeMinusTwo);
+  }
 
   if (enableIstream_ && enableOstream_) {
     // Arm the streaming interface. Will continuously load configs.
@@ -119,13 +147,58 @@ void CoreDlaBatchJob::StartDla() {
     mmdWrapper_->WriteToCsr(instance_, DLA_CSR_OFFSET_READY_STREAMING_IFACE, enable);
   } else {
     // base address for feature reader -- this will trigger one run of DLA
+    // hardware finishes the jobs of one instance in the order they were started, so the ticket of this job is the
+    // value the completion count will have once it has finished. The ticket is taken before the job starts so the
+    // ISR already sees a job outstanding on this instance when the job's interrupt arrives.
+    std::lock_guard<std::mutex> lock(startDlaMutex);
+    if (jobsSubmitted_) lastJobQueueNumber_ = ++(*jobsSubmitted_);
     mmdWrapper_->WriteToCsr(instance_, DLA_DMA_CSR_OFFSET_INPUT_OUTPUT_BASE_ADDR, inputAddrDDR_);
   }
   mmdWrapper_->disableCSRLogger();
 }
 
+// Called once the job has finished, an output that is read in place in the mapped device memory only needs the cache
+// maintenance
 void CoreDlaBatchJob::ReadOutputFeatureFromDDR(void* outputArray) const {
   mmdWrapper_->enableCSRLogger();
-  mmdWrapper_->ReadFromDDR(instance_, outputAddrDDR_, outputSizeDDR_, outputArray);
+  if (outputArray == GetMappedFeature(outputAddrDDR_, outputSizeDDR_)) {
+    mmdWrapper_->SyncMappedDDR(instance_, outputAddrDDR_, outputSizeDDR_, false);
+  } else {
+    mmdWrapper_->ReadFromDDR(instance_, outputAddrDDR_, outputSizeDDR_, outputArray);
+  }
   mmdWrapper_->disableCSRLogger();
 }
+
+// The transfer is queued and this returns immediately, so the calling thread can read the output of
+// a previous job while the input is uploaded. StartDla must be called once the future is ready.
+// There is nothing to queue for data in the mapped device memory, the cache maintenance is done right away.
+std::future<void> CoreDlaBatchJob::LoadInputFeatureToDDRAsync(void* inputArray) {
+  if (inputArray == GetMappedFeature(inputAddrDDR_, inputSizeDDR_)) {
+    std::promise<void> done;
+    mmdWrapper_->SyncMappedDDR(instance_, inputAddrDDR_, inputSizeDDR_, true);
+    done.set_value();
+    return done.get_future();
+  }
+  return mmdWrapper_->WriteToDDRAsync(instance_, inputAddrDDR_, inputSizeDDR_, inputArray);
+}
+
+std::future<void> CoreDlaBatchJob::ReadOutputFeatureFromDDRAsync(void* outputArray) const {
+  if (outputArray == GetMappedFeature(outputAddrDDR_, outputSizeDDR_)) {
+    std::promise<void> done;
+    mmdWrapper_->SyncMappedDDR(instance_, outputAddrDDR_, outputSizeDDR_, false);
+    done.set_value();
+    return done.get_future();
+  }
+  return mmdWrapper_->ReadFromDDRAsync(instance_, outputAddrDDR_, outputSizeDDR_, outputArray);
+}
+
+void* CoreDlaBatchJob::GetMappedFeature(uint64_t addrDDR, uint64_t sizeDDR) const {
+  uint64_t length = 0;
+  uint8_t* mappedDDR = static_cast<uint8_t*>(mmdWrapper_->GetMappedDDR(instance_, length));
+  if (mappedDDR == nullptr || addrDDR + sizeDDR > length) return nullptr;
+  return mappedDDR + addrDDR;
+}
+
+void* CoreDlaBatchJob::GetMappedInputFeature() { return GetMappedFeature(inputAddrDDR_, inputSizeDDR_); }
+
+void* CoreDlaBatchJob::GetMappedOutputFeature() { return GetMappedFeature(outputAddrDDR_, outputSizeDDR_); }
@@ -17,7 +17,8 @@
 #include "dla_dma_constants.h"  //DLA_DMA_CSR_OFFSET_***
 #include "stream_controller_comms.h"
 
-#include <algorithm>  //std::count
+#include <algorithm>  //std::count, std::find_if
+#include <atomic>     //std::atomic
 #include <cassert>    //assert
 #include <chrono>     //std::chrono::seconds
 #include <cstddef>    //size_t
@@ -47,36 +48,82 @@ std::unique_ptr<Device> Device::MakeUnique(const arch_params*,
   return nullptr;
 }
 
+// Wake the threads waiting for a job with a ticket up to jobsFinished
+static void NotifyFinishedWaiters(InterruptServiceRoutineData* isrData, int instance) {
+  const uint64_t jobsFinished = isrData->jobsFinished[instance].load();
+  std::lock_guard<std::mutex> waiterLock(isrData->waiterMutex[instance]);
+  auto& waiters = isrData->waiters[instance];
+  for (auto it = waiters.begin(); it != waiters.end() && it->first <= jobsFinished; ++it) {
+    it->second->notify_one();
+  }
+}
+
 void InterruptServiceRoutine(int handle, void* data) {
   InterruptServiceRoutineData* isrData = static_cast<InterruptServiceRoutineData*>(data);
   // clear interrupt status -- write 1 to clear that bit
   constexpr int writeDataToClearInterruptStatus = 3;
   const int numInstances = static_cast<int>(isrData->jobsFinished.size());
+  // Clear the status of every instance, so that an error or stale interrupt on an idle instance does not stay asserted
   for (int i = 0; i < numInstances; i++) {
     isrData->mmdWrapper->WriteToCsr(i, DLA_DMA_CSR_OFFSET_INTERRUPT_CONTROL, writeDataToClearInterruptStatus);
   }
+  // Every CSR read is a round trip to the board, so only read the completion count of the instances that have a job
+  // outstanding. This is judged by the completion count the ISR itself saw last time, since in adaptive mode a polling
+  // thread may have already advanced jobsFinished without the interrupt being cleared. An interrupt while no job is
+  // outstanding (an error, or streaming mode where jobs do not take tickets) reads all instances.
+  uint64_t activeInstances = 0;
+  for (int i = 0; i < numInstances; i++) {
+    if (isrData->jobsSubmitted[i].load() > isrData->isrJobsFinished[i]) activeInstances |= 1ULL << i;
+  }
+  if (activeInstances == 0) activeInstances = ~0ULL;
   for (int i = 0; i < numInstances; i++) {
-    isrData->desc_queue_diag[i] = isrData->mmdWrapper->ReadFromCsr(i, DLA_DMA_CSR_OFFSET_DESC_DIAGNOSTICS);
+    if (!((activeInstances >> i) & 1)) continue;
     // ask the csr how many jobs have finished
-    uint32_t completionCount =  isrData->mmdWrapper->ReadFromCsr(i, DLA_DMA_CSR_OFFSET_COMPLETION_COUNT);
+    constexpr uint32_t statusAddrs[] = {DLA_DMA_CSR_OFFSET_DESC_DIAGNOSTICS, DLA_DMA_CSR_OFFSET_COMPLETION_COUNT};
+    uint32_t status[2];
+    isrData->mmdWrapper->ReadFromCsrBatch(i, statusAddrs, status, 2);
+    isrData->desc_queue_diag[i] = status[0];
+    uint32_t completionCount = status[1];
     // check if the completionCount wraps around (overflow detection) and save this information
     if (isrData->prevCount[i] > completionCount)
       isrData->base_multiplier[i] ++;
     isrData->prevCount[i] = completionCount;
     // we add base_multiplier to account for the fact that a wrap around is actually an increment of 1
-    std::unique_lock<std::mutex> isrMutexLock(isrData->isrMutex[i]);
-    isrData->jobsFinished[i] = (uint64_t) isrData->base_multiplier[i] * UINT32_MAX + completionCount + isrData->base_multiplier[i];
-    isrData->isrCondVar[i].notify_all();
+    uint64_t jobsFinished = (uint64_t) isrData->base_multiplier[i] * UINT32_MAX + completionCount + isrData->base_multiplier[i];
+    // in adaptive mode a spinning thread may have already seen a newer completion count, never move backwards
+    isrData->isrJobsFinished[i] = jobsFinished;
+    uint64_t known = isrData->jobsFinished[i].load();
+    while (known < jobsFinished && !isrData->jobsFinished[i].compare_exchange_weak(known, jobsFinished)) {
+    }
+    NotifyFinishedWaiters(isrData, i);
   }
 }
 
 CoreDlaDevice::CoreDlaDevice(uint32_t waitForDlaTimeoutSeconds, bool enableLogging)
 : mmdWrapper_(enableLogging), waitForDlaTimeoutSeconds_(waitForDlaTimeoutSeconds) {
 #ifdef COREDLA_RUNTIME_POLLING
-  runtimePolling_ = true;
+  completionMode_ = CompletionMode::POLLING;
 #else
-  runtimePolling_ = false;
+  completionMode_ = CompletionMode::INTERRUPT;
 #endif
+  const char* completionModeEnv = getenv("COREDLA_RUNTIME_COMPLETION_MODE");
+  if (completionModeEnv) {
+    std::string completionMode(completionModeEnv);
+    if (completionMode == "interrupt") {
+      completionMode_ = CompletionMode::INTERRUPT;
+    } else if (completionMode == "polling") {
+      completionMode_ = CompletionMode::POLLING;
+    } else if (completionMode == "adaptive") {
+      completionMode_ = CompletionMode::ADAPTIVE;
+    } else {
+      throw std::runtime_error("COREDLA_RUNTIME_COMPLETION_MODE must be interrupt, polling or adaptive, got " +
+                               completionMode);
+    }
+  }
+  // Upper bound of the adaptive spin window, a job that takes longer than this is waited for with the interrupt
+  constexpr uint32_t defaultMaxSpinUs = 500;
+  const char* maxSpinUsEnv = getenv("COREDLA_RUNTIME_MAX_SPIN_US");
+  maxSpinUs_ = maxSpinUsEnv ? static_cast<uint32_t>(std::stoul(maxSpinUsEnv)) : defaultMaxSpinUs;
   // mmdWrapper_ ctor runs first, which will open a handle to the MMD. Now determine the number of hardware instances
   // by writing a nonzero value to some offset and then reading it back. While trying to enable the interrupt
   // mask, test for this.
@@ -92,7 +139,16 @@ CoreDlaDevice::CoreDlaDevice(uint32_t waitForDlaTimeoutSeconds, bool enableLoggi
   }
   LOG_AND_PRINT(Logger::INFO, "numInstances_: %d\n", numInstances_);
   assert(numInstances_ >= 1);
-  jobsWaited_.resize(numInstances_, 0);
+  // The IP may have been reset or reprogrammed since the shadow copies of the CSR were taken
+  for (int i = 0; i < numInstances_; i++) {
+    mmdWrapper_.InvalidateCsrCache(i);
+  }
+  jobsWaited_ = std::vector<std::atomic<uint64_t>>(numInstances_);
+  startJobsFinished_.resize(numInstances_, 0);
+  completionStats_ = std::unique_ptr<CompletionStats[]>(new CompletionStats[numInstances_]);
+  for (int i = 0; i < numInstances_; i++) {
+    completionStats_[i].spinWindowNs = static_cast<uint64_t>(maxSpinUs_) * 1000;
+  }
   mmdWrapper_.disableCSRLogger();
 
   uint32_t license = mmdWrapper_.ReadFromCsr(0, DLA_DMA_CSR_OFFSET_LICENSE_FLAG);
@@ -115,15 +171,23 @@ CoreDlaDevice::CoreDlaDevice(uint32_t waitForDlaTimeoutSeconds, bool enableLoggi
 
   // Package up the data that interrupt service routine needs
   isrData_.mmdWrapper = &mmdWrapper_;
-  isrData_.jobsFinished = std::vector<uint64_t>(numInstances_, 0);
+  isrData_.jobsFinished = std::vector<std::atomic<uint64_t>>(numInstances_);
+  isrData_.jobsSubmitted = std::vector<std::atomic<uint64_t>>(numInstances_);
   isrData_.base_multiplier = std::vector<uint32_t>(numInstances_, 0);
   isrData_.prevCount = std::vector<uint32_t>(numInstances_, 0);
-  isrData_.desc_queue_diag = std::vector<uint32_t>(numInstances_, 0);
-  isrData_.isrMutex = std::vector<std::mutex>(numInstances_);
-  isrData_.isrCondVar = std::vector<std::condition_variable>(numInstances_);
+  isrData_.isrJobsFinished = std::vector<uint64_t>(numInstances_, 0);
+  isrData_.desc_queue_diag = std::vector<std::atomic<uint32_t>>(numInstances_);
+  isrData_.waiterMutex = std::vector<std::mutex>(numInstances_);
+  isrData_.waiters = std::vector<std::multimap<uint64_t, std::condition_variable*>>(numInstances_);
+  for (int i = 0; i < numInstances_; i++) {
+    jobsWaited_[i] = 0;
+    isrData_.jobsFinished[i] = 0;
+    isrData_.jobsSubmitted[i] = 0;
+    isrData_.desc_queue_diag[i] = 0;
+  }
 
   mmdWrapper_.enableCSRLogger();
-  if (runtimePolling_) {
+  if (completionMode_ == CompletionMode::POLLING) {
     // disable the interrupt mask -- it was originally enabled to determine how many instances were present
     for (int i = 0; i < mmdWrapper_.GetMaxInstances(); i++) {
       constexpr uint32_t disableInterruptMaskValue = 0;
@@ -140,7 +204,10 @@ CoreDlaDevice::CoreDlaDevice(uint32_t waitForDlaTimeoutSeconds, bool enableLoggi
   for(int i=0; i < numInstances_; i++) {
 #ifndef USE_OLD_COREDLA_DEVICE
     jobsWaited_[i] = mmdWrapper_.ReadFromCsr(i, DLA_DMA_CSR_OFFSET_COMPLETION_COUNT);
-    isrData_.jobsFinished[i] = jobsWaited_[i];
+    isrData_.jobsFinished[i] = jobsWaited_[i].load();
+    isrData_.jobsSubmitted[i] = jobsWaited_[i].load();
+    startJobsFinished_[i] = jobsWaited_[i].load();
+    isrData_.isrJobsFinished[i] = jobsWaited_[i].load();
 
     startClocksActive[i] = GetClocksActive(i);
     startClockAllJobs[i] = GetClocksAllJobs(i);
@@ -231,6 +298,29 @@ CoreDlaDevice::~CoreDlaDevice() {
     }
   }
   mmdWrapper_.disableCSRLogger();
+
+  if (getenv("COREDLA_RUNTIME_DEBUG") != nullptr) {
+    for (int instance = 0; instance < numInstances_; instance++) {
+      const CompletionStats& stats = completionStats_[instance];
+      DLA_LOG("instance %d completions: %" PRIu64 " already finished, %" PRIu64 " polled, %" PRIu64
+              " after interrupt, spin window %" PRIu64 " ns\n",
+              instance,
+              stats.alreadyFinished.load(),
+              stats.finishedWhilePolling.load(),
+              stats.finishedAfterInterrupt.load(),
+              stats.spinWindowNs.load());
+    }
+  }
+}
+
+DebugNetworkData CoreDlaDevice::GetCompletionStats(int instance) const {
+  const CompletionStats& stats = completionStats_[instance];
+  DebugNetworkData result;
+  result["Completions already finished"] = stats.alreadyFinished.load();
+  result["Completions found by polling"] = stats.finishedWhilePolling.load();
+  result["Completions after interrupt"] = stats.finishedAfterInterrupt.load();
+  result["Adaptive spin window (ns)"] = stats.spinWindowNs.load();
+  return result;
 }
 
 GraphJob* CoreDlaDevice::CreateGraphJob(const dla::CompiledResult* compiledResult,
@@ -248,55 +338,155 @@ GraphJob* CoreDlaDevice::CreateGraphJob(const dla::CompiledResult* compiledResul
   assert(instance < numInstances_);
   (void) export_dir;  // unused in HW runtime. CoreDLA utilizes base pointers, which the SW emulator utilizes this variable. We void it here.
   allGraphJobs_.push_back(move(
-      CoreDlaGraphJob::MakeUnique(&ddrAllocator_[instance], &mmdWrapper_, compiledResult, numPipelines, instance, spStreamControllerComms_)));
+      CoreDlaGraphJob::MakeUnique(&ddrAllocator_[instance], &mmdWrapper_, compiledResult, numPipelines, instance,
+                                  &isrData_.jobsSubmitted[instance], spStreamControllerComms_)));
   return (allGraphJobs_.back()).get();
 }
 
-// This function must be called by a single thread
+void CoreDlaDevice::ReleaseGraphJob(GraphJob* graphJob) {
+  auto it = std::find_if(allGraphJobs_.begin(), allGraphJobs_.end(),
+                         [graphJob](const std::unique_ptr<GraphJob>& job) { return job.get() == graphJob; });
+  if (it == allGraphJobs_.end()) {
+    throw std::runtime_error("ReleaseGraphJob called with a graph job that was not created by this device");
+  }
+  allGraphJobs_.erase(it);  // ~CoreDlaGraphJob frees the DDR buffers
+}
+
+void CoreDlaDevice::CompactDeviceMemory(int instance) {
+  assert(instance < numInstances_);
+  mmdWrapper_.enableCSRLogger();
+  ddrAllocator_[instance].Compact(instance, [this, instance](uint64_t oldAddr, uint64_t newAddr) {
+    for (auto& graphJob : allGraphJobs_) {
+      static_cast<CoreDlaGraphJob*>(graphJob.get())->RelocateBuffer(instance, oldAddr, newAddr);
+    }
+  });
+  mmdWrapper_.disableCSRLogger();
+}
+
+// Callers that don't track job ids claim the next ticket, so every call waits for one more job to finish. This is
+// thread safe, but each thread only knows that some job finished, use WaitForDlaJob to wait for a particular job.
 void CoreDlaDevice::WaitForDla(int instance, size_t threadId, std::function<bool()> isCancelledPredicate) {
-  // ISR updates jobsFinished, if not enough jobs have finished then sleep until ISR runs again
-  // it is possible that several hardware jobs could finish around the same time
-  // by the time software handles the first interrupt, hardware could report that 2 jobs have
-  // finished, for example the second time that waitForInterrupt runs, software already tracks
-  // that the second job has finished and therefore don't need to sleep waiting for ISR
-  std::unique_lock<std::mutex> isrMutexLock(isrData_.isrMutex[instance]);
-  uint32_t completionCount = 0;
+  WaitForTicket(instance, ++jobsWaited_[instance], threadId, isCancelledPredicate);
+}
+
+void CoreDlaDevice::WaitForDlaJob(int instance,
+                                  uint64_t jobId,
+                                  size_t threadId,
+                                  std::function<bool()> isCancelledPredicate) {
+  if (jobId == 0) {
+    // the batch job did not get a ticket, e.g. streaming mode where the hardware loads the jobs by itself
+    WaitForDla(instance, threadId, isCancelledPredicate);
+  } else {
+    WaitForTicket(instance, jobId, threadId, isCancelledPredicate);
+    // keep WaitForDla from handing out tickets of jobs that have already been waited for
+    uint64_t waited = jobsWaited_[instance].load();
+    while (waited < jobId && !jobsWaited_[instance].compare_exchange_weak(waited, jobId)) {
+    }
+  }
+}
+
+// Extend the 32-bit hardware count to 64 bits relative to what is already known. Several threads may poll at once and
+// another thread (or the ISR) may already have stored a newer count than the one read here, so the difference is
+// signed and jobsFinished only ever moves forwards.
+void CoreDlaDevice::PollCompletionCount(int instance) {
+  std::atomic<uint64_t>& jobsFinished = isrData_.jobsFinished[instance];
+  uint32_t completionCount = mmdWrapper_.ReadFromCsr(instance, DLA_DMA_CSR_OFFSET_COMPLETION_COUNT);
+  uint64_t known = jobsFinished.load();
+  int32_t newlyFinished = static_cast<int32_t>(completionCount - static_cast<uint32_t>(known));
+  uint64_t polled = known + newlyFinished;
+  while (newlyFinished > 0 && polled > known && !jobsFinished.compare_exchange_weak(known, polled)) {
+  }
+}
+
+// The spin window is the average hardware time of one job times the number of jobs still ahead of the ticket, so a job
+// that is about to run is likely to finish while spinning, capped by COREDLA_RUNTIME_MAX_SPIN_US. The average is refreshed every spinWindowUpdateInterval jobs by
+// whichever thread gets there first. GetAvgHWTimePerJobMs is normally read with DLA idle, here jobs may be running
+// which makes the average slightly off, good enough for a heuristic.
+std::chrono::nanoseconds CoreDlaDevice::GetSpinWindow(int instance, uint64_t jobsAhead) {
+  constexpr uint64_t spinWindowUpdateInterval = 256;
+  constexpr uint64_t spinWindowFirstUpdate = 16;
+  CompletionStats& stats = completionStats_[instance];
+  const uint64_t jobsFinished = isrData_.jobsFinished[instance].load() - startJobsFinished_[instance];
+  const uint64_t lastUpdate = stats.spinWindowUpdatedAtJob.load();
+  const bool firstUpdate = lastUpdate == 0 && jobsFinished >= spinWindowFirstUpdate;
+  if ((firstUpdate || jobsFinished >= lastUpdate + spinWindowUpdateInterval) && stats.spinWindowMutex.try_lock()) {
+    std::lock_guard<std::mutex> spinWindowLock(stats.spinWindowMutex, std::adopt_lock);
+    double avgJobNs = GetAvgHWTimePerJobMs(jobsFinished, instance) * 1e6;
+    uint64_t maxSpinNs = static_cast<uint64_t>(maxSpinUs_) * 1000;
+    stats.spinWindowNs = (avgJobNs > 0 && avgJobNs < maxSpinNs) ? static_cast<uint64_t>(avgJobNs) : maxSpinNs;
+    stats.spinWindowUpdatedAtJob = jobsFinished;
+  }
+  const uint64_t maxSpinNs = static_cast<uint64_t>(maxSpinUs_) * 1000;
+  return std::chrono::nanoseconds(std::min(maxSpinNs, stats.spinWindowNs.load() * jobsAhead));
+}
+
+void CoreDlaDevice::WaitForTicket(int instance,
+                                  uint64_t jobId,
+                                  size_t threadId,
+                                  const std::function<bool()>& isCancelledPredicate) {
+  // jobsFinished is updated by the ISR (or right here when polling). Several jobs can finish around the same time,
+  // so by the time software handles the first interrupt the hardware could report that two jobs have finished, in
+  // which case the waiter of the second job returns without sleeping.
+  std::atomic<uint64_t>& jobsFinished = isrData_.jobsFinished[instance];
+  CompletionStats& stats = completionStats_[instance];
   bool timedOut = false;
   auto timeoutDuration = std::chrono::seconds(waitForDlaTimeoutSeconds_);
 
-  mmdWrapper_.enableCSRLogger();
-  if (runtimePolling_) {
-    std::chrono::time_point<std::chrono::system_clock> pollingEndingTime =
-        std::chrono::system_clock::now() + timeoutDuration;
-
-    while (isrData_.jobsFinished[instance] == jobsWaited_[instance]) {
-      // Update isrData_.jobsFinished[instance] here (polling)
-      if (isCancelledPredicate and isCancelledPredicate()) {
-        break;
-      }
-
-      completionCount = mmdWrapper_.ReadFromCsr(instance, DLA_DMA_CSR_OFFSET_COMPLETION_COUNT);
-      isrData_.jobsFinished[instance] = completionCount;
-      if (std::chrono::system_clock::now() > pollingEndingTime) {
-        timedOut = true;
-        break;
+  if (jobsFinished.load() >= jobId) {
+    stats.alreadyFinished++;
+  } else {
+    mmdWrapper_.enableCSRLogger();
+    if (completionMode_ == CompletionMode::ADAPTIVE) {
+      // Spin on the completion count for a short while, small graphs finish before an interrupt could wake us up
+      std::chrono::time_point<std::chrono::steady_clock> spinEndingTime =
+          std::chrono::steady_clock::now() + GetSpinWindow(instance, jobId - jobsFinished.load());
+      while (jobsFinished.load() < jobId && std::chrono::steady_clock::now() < spinEndingTime) {
+        PollCompletionCount(instance);
       }
     }
-  } else {
-    while (isrData_.jobsFinished[instance] == jobsWaited_[instance]) {
-      // isrData_.jobsFinished[instance] is updated in the ISR
-      if (std::cv_status::timeout == isrData_.isrCondVar[instance].wait_for(isrMutexLock, timeoutDuration)) {
-        timedOut = true;
-        break;
+    if (jobsFinished.load() >= jobId) {
+      stats.finishedWhilePolling++;
+    } else if (completionMode_ == CompletionMode::POLLING) {
+      std::chrono::time_point<std::chrono::system_clock> pollingEndingTime =
+          std::chrono::system_clock::now() + timeoutDuration;
+
+      while (jobsFinished.load() < jobId) {
+        if (isCancelledPredicate and isCancelledPredicate()) {
+          break;
+        }
+        PollCompletionCount(instance);
+        if (std::chrono::system_clock::now() > pollingEndingTime) {
+          timedOut = true;
+          break;
+        }
       }
+      stats.finishedWhilePolling++;
+    } else {
+      // Register a condition variable for this ticket only, so the ISR does not wake threads whose job is still
+      // running. jobsFinished is checked with waiterMutex held, which the ISR takes before notifying.
+      std::condition_variable condVar;
+      std::unique_lock<std::mutex> waiterLock(isrData_.waiterMutex[instance]);
+      auto waiter = isrData_.waiters[instance].emplace(jobId, &condVar);
+      std::chrono::time_point<std::chrono::steady_clock> waitEndingTime =
+          std::chrono::steady_clock::now() + timeoutDuration;
+      while (jobsFinished.load() < jobId) {
+        if (std::cv_status::timeout == condVar.wait_until(waiterLock, waitEndingTime)) {
+          timedOut = jobsFinished.load() < jobId;
+          break;
+        }
+      }
+      isrData_.waiters[instance].erase(waiter);
+      stats.finishedAfterInterrupt++;
     }
+    mmdWrapper_.disableCSRLogger();
   }
-  mmdWrapper_.disableCSRLogger();
 
   if (timedOut) {
     std::string str_poll_vs_int = "interrupt";
-    if (runtimePolling_) {
+    if (completionMode_ == CompletionMode::POLLING) {
       str_poll_vs_int = "polling";
+    } else if (completionMode_ == CompletionMode::ADAPTIVE) {
+      str_poll_vs_int = "adaptive";
     }
     std::string timeoutMsg = "WaitForDla " + str_poll_vs_int + " timeout with threadId_" + std::to_string(threadId) + "\n";
 
@@ -309,22 +499,20 @@ void CoreDlaDevice::WaitForDla(int instance, size_t threadId, std::function<bool
                                         // verbosity is too low
     LOG(Logger::WARNING, "%s", timeoutMsg.c_str());
     std::string exceptionMsg = "FATAL ERROR: inference on FPGA did not complete";
-    exceptionMsg += ", jobs finished " + std::to_string(isrData_.jobsFinished[instance]);
-    exceptionMsg += ", jobs waited " + std::to_string(jobsWaited_[instance]);
+    exceptionMsg += ", jobs finished " + std::to_string(jobsFinished.load());
+    exceptionMsg += ", waiting for job " + std::to_string(jobId);
     throw std::runtime_error(exceptionMsg);
   }
 
-  if ((isrData_.desc_queue_diag[instance] >> DLA_DMA_CSR_DESC_DIAGNOSTICS_OUT_OF_INFERENCES_BIT) & 0x01) {
+  if ((isrData_.desc_queue_diag[instance].load() >> DLA_DMA_CSR_DESC_DIAGNOSTICS_OUT_OF_INFERENCES_BIT) & 0x01) {
     std::cerr << "ERROR: Out of free inferences on this IP. " <<
                  "The Intel FPGA AI suite cannot continue without a license!" << std::endl;
     std::string exceptionMsg = "Inference on FPGA exited with a license error";
-    exceptionMsg += ", jobs finished " + std::to_string(isrData_.jobsFinished[instance]);
-    exceptionMsg += ", jobs waited " + std::to_string(jobsWaited_[instance]);
+    exceptionMsg += ", jobs finished " + std::to_string(jobsFinished.load());
+    exceptionMsg += ", waiting for job " + std::to_string(jobId);
     exceptionMsg += "\nPlease check your license. The Intel FPGA AI suite cannot continue without a license!";
     throw std::runtime_error(exceptionMsg);
   }
-
-  jobsWaited_[instance]++;
 }
 
 #ifndef USE_OLD_COREDLA_DEVICE
@@ -582,6 +770,10 @@ bool CoreDlaDevice::InitializeScheduler(uint32_t sourceBufferSize,
                                         const std::string source_fifo_file) {
   spStreamControllerComms_ = std::make_shared<StreamControllerComms>();
   if (spStreamControllerComms_->IsPresent()) {
+    // From here on the stream controller firmware writes the config registers too
+    for (int i = 0; i < numInstances_; i++) {
+      mmdWrapper_.InvalidateCsrCache(i);
+    }
     bool initOK = spStreamControllerComms_->Initialize(sourceBufferSize, dropSourceBuffers, numInferenceRequests);
     return initOK;
   } else {
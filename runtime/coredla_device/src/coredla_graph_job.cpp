@@ -18,6 +18,7 @@
 #include <iomanip>   //std::hex
 #include <iostream>  //std::cerr
 #include <sstream>   //std::stringstream
+#include <stdexcept> //std::runtime_error
 #include <string>    //std::string
 
 #define BUILD_VERSION_CSR_OFFSET (ARCH_HASH_SIZE)
@@ -31,9 +32,10 @@ std::unique_ptr<GraphJob> CoreDlaGraphJob::MakeUnique(DeviceMemoryAllocator *ddr
                                                       const dla::CompiledResult *compiledResult,
                                                       uint64_t numPipelines,
                                                       int instance,
+                                                      std::atomic<uint64_t> *jobsSubmitted,
                                                       std::shared_ptr<StreamControllerComms> spStreamControllerComms) {
   return std::unique_ptr<GraphJob>(new CoreDlaGraphJob(
-      ddrBufferAllocator, mmdWrapper, compiledResult, numPipelines, instance, spStreamControllerComms));
+      ddrBufferAllocator, mmdWrapper, compiledResult, numPipelines, instance, jobsSubmitted, spStreamControllerComms));
 }
 
 std::string get_env_var_wrapper(const std::string &env_var) {
@@ -81,9 +83,14 @@ CoreDlaGraphJob::CoreDlaGraphJob(DeviceMemoryAllocator *ddrBufferAllocator,
                                  const dla::CompiledResult *compiledResult,
                                  uint64_t numPipelines,
                                  int instance,
+                                 std::atomic<uint64_t> *jobsSubmitted,
                                  std::shared_ptr<StreamControllerComms> spStreamControllerComms)
     : configFilterBiasBufferSizeDDR_(0),
       intermediateBufferSizeDDR_(0),
+      configFilterBufferAddr_(0),
+      inputOutputBufferAddr_(0),
+      inputSizeDDR_(0),
+      outputSizeDDR_(0),
       ddrBufferAllocator_(ddrBufferAllocator),
       mmdWrapper_(mmdWrapper),
       batchJobsRequested_(0),
@@ -181,6 +188,8 @@ CoreDlaGraphJob::CoreDlaGraphJob(DeviceMemoryAllocator *ddrBufferAllocator,
   // Allocate graph buffer (config, filter, bias, io) in DDR
   uint64_t inputSizeDDR = compiledResult->get_conv_input_size_in_bytes();
   uint64_t outputSizeDDR = compiledResult->get_conv_output_size_in_bytes();
+  inputSizeDDR_ = inputSizeDDR;
+  outputSizeDDR_ = outputSizeDDR;
 
   // DMA data path width in bytes for feature and filter data
   // TODO: move this into the arch
@@ -209,63 +218,122 @@ CoreDlaGraphJob::CoreDlaGraphJob(DeviceMemoryAllocator *ddrBufferAllocator,
   uint64_t inputOutputBufferSize = numPipelines * (inputSizeDDR + outputSizeDDR);  // how much space to allocate
   uint64_t inputOutputBufferAlignment = featureWordSize;  // starting address must be aligned to this
   uint64_t inputOutputBufferAddr;                         // where did the allocator place this buffer
-  ddrBufferAllocator_->AllocatePrivateBuffer(inputOutputBufferSize, inputOutputBufferAlignment, inputOutputBufferAddr);
+  try {
+    ddrBufferAllocator_->AllocatePrivateBuffer(inputOutputBufferSize, inputOutputBufferAlignment, inputOutputBufferAddr);
+  } catch (...) {
+    // The destructor does not run if the constructor throws, give back what was already allocated
+    ddrBufferAllocator_->FreeSharedBuffer(intermediateBufferSizeDDR_);
+    throw;
+  }
+  inputOutputBufferAddr_ = inputOutputBufferAddr;
 
   // Allocate the config/filter buffer.
   // Filter buffer must come immediately after the config buffer, so from an allocation perspective this is one buffer.
+  // If another graph on this instance already loaded identical constants, share its buffer instead of uploading again.
   uint64_t configFilterBufferSize = configFilterBiasBufferSizeDDR_;
   uint64_t configFilterBufferAlignment = filterWordSize;
   uint64_t configFilterBufferAddr;
-  ddrBufferAllocator_->AllocatePrivateBuffer(
-      configFilterBufferSize, configFilterBufferAlignment, configFilterBufferAddr);
+  bool configFilterBufferNeedsUpload;
+  try {
+    configFilterBufferNeedsUpload = ddrBufferAllocator_->AllocateConstantBuffer(
+        config_fbs_raw_array, configFilterBufferSize, configFilterBufferAlignment, configFilterBufferAddr);
+  } catch (...) {
+    if (inputOutputBufferSize != 0) ddrBufferAllocator_->FreePrivateBuffer(inputOutputBufferAddr);
+    ddrBufferAllocator_->FreeSharedBuffer(intermediateBufferSizeDDR_);
+    throw;
+  }
+  configFilterBufferAddr_ = configFilterBufferAddr;
 
   // Print the allocation results
   bool print_allocation_result = getenv("COREDLA_RUNTIME_DEBUG") != nullptr;
   ios_base::fmtflags coutFlags = cout.flags();  // printing in both decimal and hex, save cout state to undo it later
-  if (print_allocation_result) {
-    DLA_LOG("FPGA DDR allocation results\n");
-    // Intermediate buffer address is hardcoded to 0 in device_memory_allocator.cpp, don't bother printing this
-    DLA_LOG("  Config buffer is at address %" PRIu64, configFilterBufferAddr);
-    DLA_LOG(" (%#" PRIx64 ")\n", configFilterBufferAddr);
-    const uint64_t filter_buffer_address = configFilterBufferAddr + totalConfigBytes;
-    DLA_LOG("  Filter/bias/scale buffer is at address %" PRIu64, filter_buffer_address);
-    DLA_LOG(" (%#" PRIx64 ")\n", filter_buffer_address);
-  }
+  // The destructor does not run if the constructor throws, e.g. the upload of the constants fails, so from here on
+  // give back all three buffers before passing the exception on
+  try {
+    if (print_allocation_result) {
+      DLA_LOG("FPGA DDR allocation results\n");
+      // Intermediate buffer address is hardcoded to 0 in device_memory_allocator.cpp, don't bother printing this
+      DLA_LOG("  Config buffer is at address %" PRIu64, configFilterBufferAddr);
+      DLA_LOG(" (%#" PRIx64 ")\n", configFilterBufferAddr);
+      const uint64_t filter_buffer_address = configFilterBufferAddr + totalConfigBytes;
+      DLA_LOG("  Filter/bias/scale buffer is at address %" PRIu64, filter_buffer_address);
+      DLA_LOG(" (%#" PRIx64 ")\n", filter_buffer_address);
+      if (configFilterBiasBufferSizeDDR_ != 0 && !configFilterBufferNeedsUpload) {
+        DLA_LOG("  Config/filter buffer is shared with a graph loaded earlier\n");
+      }
+    }
 
-  const bool enable_istream = compiledResult->get_input_configuration().begin()->second.enable_input_streaming;
-  const bool enable_ostream = compiledResult->get_output_configuration().output_streaming_enabled;
+    const bool enable_istream = compiledResult->get_input_configuration().begin()->second.enable_input_streaming;
+    const bool enable_ostream = compiledResult->get_output_configuration().output_streaming_enabled;
 
-  // Write graph buffer to DDR
-  mmdWrapper_->enableCSRLogger();
-  if (!compiledResult->get_ddrfree_header().enable_parameter_rom) {
-    mmdWrapper_->WriteToDDR(instance_, configFilterBufferAddr, configFilterBiasBufferSizeDDR_, config_fbs_raw_array);
-  } else {
-    DLA_LOG("  Ddrfree graph constants are not written to DDR.\n");
+    // Write graph buffer to DDR
+    mmdWrapper_->enableCSRLogger();
+    if (compiledResult->get_ddrfree_header().enable_parameter_rom) {
+      DLA_LOG("  Ddrfree graph constants are not written to DDR.\n");
+    } else if (configFilterBufferNeedsUpload) {
+      mmdWrapper_->WriteToDDR(instance_, configFilterBufferAddr, configFilterBiasBufferSizeDDR_, config_fbs_raw_array);
+    }
+    mmdWrapper_->disableCSRLogger();
+
+    for (uint64_t i = 0; i < numPipelines; i++) {
+      uint64_t inputAddrDDR = inputOutputBufferAddr + i * (inputSizeDDR + outputSizeDDR);
+      uint64_t outputAddrDDR = inputAddrDDR + inputSizeDDR;
+      if (print_allocation_result) {
+        DLA_LOG("  Input buffer %" PRIu64 " is at address %" PRIu64, i, inputAddrDDR);
+        DLA_LOG(" (%#" PRIx64 ")\n", inputAddrDDR);
+        DLA_LOG("  Output buffer %" PRIu64 " is at address %" PRIu64, i, outputAddrDDR);
+        DLA_LOG(" (%#" PRIx64 ")\n", outputAddrDDR);
+      }
+      batchJobs_.push_back(move(CoreDlaBatchJob::MakeUnique(mmdWrapper_,
+                                                            totalConfigBytes,
+                                                            configFilterBufferAddr,
+                                                            inputAddrDDR,
+                                                            outputAddrDDR,
+                                                            inputSizeDDR,
+                                                            outputSizeDDR,
+                                                            enable_istream,
+                                                            enable_ostream,
+                                                            instance_,
+                                                            jobsSubmitted,
+                                                            spStreamControllerComms)));
+    }
+  } catch (...) {
+    cout.flags(coutFlags);
+    if (configFilterBufferSize != 0) ddrBufferAllocator_->FreeConstantBuffer(configFilterBufferAddr);
+    if (inputOutputBufferSize != 0) ddrBufferAllocator_->FreePrivateBuffer(inputOutputBufferAddr);
+    ddrBufferAllocator_->FreeSharedBuffer(intermediateBufferSizeDDR_);
+    throw;
   }
-  mmdWrapper_->disableCSRLogger();
+  cout.flags(coutFlags);  // restore the state of cout
+}
 
-  for (uint64_t i = 0; i < numPipelines; i++) {
-    uint64_t inputAddrDDR = inputOutputBufferAddr + i * (inputSizeDDR + outputSizeDDR);
-    uint64_t outputAddrDDR = inputAddrDDR + inputSizeDDR;
-    if (print_allocation_result) {
-      DLA_LOG("  Input buffer %" PRIu64 " is at address %" PRIu64, i, inputAddrDDR);
-      DLA_LOG(" (%#" PRIx64 ")\n", inputAddrDDR);
-      DLA_LOG("  Output buffer %" PRIu64 " is at address %" PRIu64, i, outputAddrDDR);
-      DLA_LOG(" (%#" PRIx64 ")\n", outputAddrDDR);
+// Buffers of size 0 were never tracked by the allocator and are not freed. The intermediate buffer is shared with
+// other graphs and only shrinks once no remaining graph needs it to be this large.
+CoreDlaGraphJob::~CoreDlaGraphJob() {
+  if (configFilterBiasBufferSizeDDR_ != 0) {
+    ddrBufferAllocator_->FreeConstantBuffer(configFilterBufferAddr_);
+  }
+  if (batchJobs_.size() * (inputSizeDDR_ + outputSizeDDR_) != 0) {
+    ddrBufferAllocator_->FreePrivateBuffer(inputOutputBufferAddr_);
+  }
+  ddrBufferAllocator_->FreeSharedBuffer(intermediateBufferSizeDDR_);
+}
+
+void CoreDlaGraphJob::RelocateBuffer(int instance, uint64_t oldAddr, uint64_t newAddr) {
+  if (instance != static_cast<int>(instance_)) return;
+  if (configFilterBiasBufferSizeDDR_ != 0 && oldAddr == configFilterBufferAddr_) {
+    configFilterBufferAddr_ = newAddr;
+    for (auto &batchJob : batchJobs_) {
+      static_cast<CoreDlaBatchJob *>(batchJob.get())->RelocateConfigBuffer(configFilterBufferAddr_);
+    }
+  } else if (!batchJobs_.empty() && oldAddr == inputOutputBufferAddr_) {
+    inputOutputBufferAddr_ = newAddr;
+    for (size_t i = 0; i < batchJobs_.size(); i++) {
+      uint64_t inputAddrDDR = inputOutputBufferAddr_ + i * (inputSizeDDR_ + outputSizeDDR_);
+      uint64_t outputAddrDDR = inputAddrDDR + inputSizeDDR_;
+      static_cast<CoreDlaBatchJob *>(batchJobs_[i].get())->RelocateInputOutputBuffer(inputAddrDDR, outputAddrDDR);
     }
-    batchJobs_.push_back(move(CoreDlaBatchJob::MakeUnique(mmdWrapper_,
-                                                          totalConfigBytes,
-                                                          configFilterBufferAddr,
-                                                          inputAddrDDR,
-                                                          outputAddrDDR,
-                                                          inputSizeDDR,
-                                                          outputSizeDDR,
-                                                          enable_istream,
-                                                          enable_ostream,
-                                                          instance_,
-                                                          spStreamControllerComms)));
   }
-  cout.flags(coutFlags);  // restore the state of cout
 }
 
 BatchJob *CoreDlaGraphJob::GetBatchJob() {
@@ -11,70 +11,269 @@
 // or implied warranties, other than those that are expressly stated in the
 // License.
 
+
 #include "device_memory_allocator.h"  //DeviceMemoryAllocator
 #include "dla_dma_constants.h"        //DLA_DMA_CSR_OFFSET_***
 
+#include <algorithm>  //std::max
+#include <cstring>    //std::memcpy
+#include <iterator>   //std::prev
 #include <stdexcept>  //std::runtime_error
 #include <string>     //std::string
 
+namespace {
+uint64_t RotateLeft(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+uint64_t Finalize(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Non-cryptographic 128-bit hash of the graph constants, used to find graphs with identical constants. This only has
+// to guard against accidental collisions, and reads 8 bytes per step so it stays well below the cost of the upload.
+void HashBuffer(const void *data, uint64_t size, uint64_t &hash1, uint64_t &hash2) {
+  constexpr uint64_t k1 = 0x87c37b91114253d5ULL;
+  constexpr uint64_t k2 = 0x4cf5ad432745937fULL;
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  uint64_t h1 = 0x9e3779b97f4a7c15ULL ^ size;
+  uint64_t h2 = 0x6a09e667f3bcc909ULL ^ size;
+  uint64_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    uint64_t w1, w2;
+    std::memcpy(&w1, bytes + i, sizeof(w1));
+    std::memcpy(&w2, bytes + i + 8, sizeof(w2));
+    h1 = RotateLeft(h1 ^ (RotateLeft(w1 * k1, 31) * k2), 27) * 5 + 0x52dce729;
+    h2 = RotateLeft(h2 ^ (RotateLeft(w2 * k2, 33) * k1), 31) * 5 + 0x38495ab5;
+  }
+  uint8_t tail[16] = {0};
+  std::memcpy(tail, bytes + i, size - i);
+  uint64_t w1, w2;
+  std::memcpy(&w1, tail, sizeof(w1));
+  std::memcpy(&w2, tail + 8, sizeof(w2));
+  h1 ^= RotateLeft(w1 * k1, 31) * k2;
+  h2 ^= RotateLeft(w2 * k2, 33) * k1;
+  h1 += h2;
+  h2 += h1;
+  hash1 = Finalize(h1);
+  hash2 = Finalize(h2 ^ hash1);
+}
+}  // namespace
+
 void DeviceMemoryAllocator::Initialize(uint64_t totalSize, MmdWrapper* mmdWrapper) {
   totalGlobalMemSize_ = totalSize;
   mmdWrapper_ = mmdWrapper;
-  currentIntermediateMaxBufferSizeAllocated_ = 0;
-  currentStartAddressGraphBufferSpace_ = totalSize;
+  Clear();
 }
 
 // The intermediate buffer is shared among all graphs. It gets placed at the lowest address
 // and grows upwards (if a new graph is added which needs a bigger intermediate buffer).
 void DeviceMemoryAllocator::AllocateSharedBuffer(uint64_t bufferSize, int instance) {
   if (bufferSize > currentIntermediateMaxBufferSizeAllocated_) {
-    currentIntermediateMaxBufferSizeAllocated_ = bufferSize;
-
     // error intermediate buffer grows into the region of memory used for private buffers
-    if (currentIntermediateMaxBufferSizeAllocated_ > currentStartAddressGraphBufferSpace_) {
+    uint64_t lowestPrivateBufferAddr = privateBuffers_.empty() ? totalGlobalMemSize_ : privateBuffers_.begin()->first;
+    if (bufferSize > lowestPrivateBufferAddr) {
       std::string msg = "FPGA DDR allocation failed, intermediate buffer grew upwards to " +
-                        std::to_string(currentIntermediateMaxBufferSizeAllocated_) +
+                        std::to_string(bufferSize) +
                         ", remaining unallocated space is limited to " +
-                        std::to_string(currentStartAddressGraphBufferSpace_);
+                        std::to_string(lowestPrivateBufferAddr);
       throw std::runtime_error(msg);
     }
+    currentIntermediateMaxBufferSizeAllocated_ = bufferSize;
 
     // tell the fpga where the intermediate buffer is located. At address 0 now. Will change in future with multiple
     // pe_arrays
     mmdWrapper_->WriteToCsr(instance, DLA_DMA_CSR_OFFSET_INTERMEDIATE_BASE_ADDR, 0);
   }
+  sharedBufferSizes_.insert(bufferSize);
+}
+
+// The intermediate buffer only needs to be as large as the largest graph that is still loaded. It stays at address 0
+// so there is nothing to tell the fpga.
+void DeviceMemoryAllocator::FreeSharedBuffer(uint64_t bufferSize) {
+  auto it = sharedBufferSizes_.find(bufferSize);
+  if (it == sharedBufferSizes_.end()) {
+    throw std::runtime_error("FPGA DDR free failed, no intermediate buffer of size " + std::to_string(bufferSize) +
+                             " was allocated");
+  }
+  sharedBufferSizes_.erase(it);
+  currentIntermediateMaxBufferSizeAllocated_ = sharedBufferSizes_.empty() ? 0 : *sharedBufferSizes_.rbegin();
 }
 
 // The config, filter, input, and output buffers are specific to a graph and therefore require
 // their own space in device memory. Note that filter must come immediately after config, so the
 // allocator allocates both of these together as one buffer. Likewise output must come immediately
-// after input. Private buffers are allocated from the highest to lowest address since the size is
-// known at allocation time. Hardware requires the address to have some alignment, which is
-// specified by the bufferAlignment argument.
+// after input. Private buffers are placed at the top of the highest free block that fits, so with
+// nothing freed the layout is the same as allocating from the highest to lowest address. Hardware
+// requires the address to have some alignment, which is specified by the bufferAlignment argument.
 void DeviceMemoryAllocator::AllocatePrivateBuffer(uint64_t bufferSize, uint64_t bufferAlignment, uint64_t& bufferAddr) {
-  uint64_t maxInflatedBufferSize = bufferSize + bufferAlignment;  // be conservative for how much space buffer may take
+  // Nothing to allocate (e.g. graph constants are in the parameter ROM), give out an aligned address below the
+  // lowest graph buffer and don't track it
+  if (bufferSize == 0) {
+    bufferAddr = privateBuffers_.empty() ? totalGlobalMemSize_ : privateBuffers_.begin()->first;
+    bufferAddr -= (bufferAddr % bufferAlignment);
+    return;
+  }
+
+  for (auto it = freeBlocks_.rbegin(); it != freeBlocks_.rend(); ++it) {
+    uint64_t blockEnd = it->first + it->second;
+    uint64_t lowestUsableAddr = std::max(it->first, PrivateSpaceStart());
+    if (blockEnd <= lowestUsableAddr) break;  // this block and all blocks below are in the intermediate buffer
+    if (blockEnd - lowestUsableAddr < bufferSize) continue;
+    uint64_t addr = blockEnd - bufferSize;
+    addr -= (addr % bufferAlignment);  // correct for alignment
+    if (addr < lowestUsableAddr) continue;
+
+    // take [addr, blockEnd) out of the free block, the alignment padding above the buffer goes with it
+    uint64_t blockStart = it->first;
+    freeBlocks_.erase(blockStart);
+    if (addr > blockStart) freeBlocks_[blockStart] = addr - blockStart;
+    privateBuffers_[addr] = PrivateBuffer{bufferSize, bufferAlignment, blockEnd - addr};
+    bufferAddr = addr;
+    return;
+  }
 
   // error if the graph does not fit in fpga ddr
-  if (currentIntermediateMaxBufferSizeAllocated_ + maxInflatedBufferSize > currentStartAddressGraphBufferSpace_) {
-    std::string msg =
-      "FPGA DDR allocation failed, allocating buffer of size " + std::to_string(maxInflatedBufferSize) +
-      " exceeds the remaining space available of size " +
-      std::to_string(currentStartAddressGraphBufferSpace_ - currentIntermediateMaxBufferSizeAllocated_) +
-      ". This could be caused by the graph being too large or splitting the graph into too many subgraphs. " +
-      "Memory requirements for large graphs can be reduced by selecting different folding options, " +
-      "reducing batch size or selecting architectures with less padding.";
-    throw std::runtime_error(msg);
-  }
-
-  currentStartAddressGraphBufferSpace_ -= bufferSize;  // allocate from highest to lowest address
-  currentStartAddressGraphBufferSpace_ -=
-      (currentStartAddressGraphBufferSpace_ % bufferAlignment);  // correct for alignment
-  bufferAddr = currentStartAddressGraphBufferSpace_;
+  std::string msg =
+    "FPGA DDR allocation failed, allocating buffer of size " + std::to_string(bufferSize) +
+    " exceeds the remaining space available of size " + std::to_string(GetLargestFreeBlockSize()) + ". ";
+  if (GetFreeSize() >= bufferSize + bufferAlignment) {
+    msg += "There are " + std::to_string(GetFreeSize()) + " bytes free in total, but not in one contiguous block. " +
+           "Compacting the device memory will make the free space contiguous. ";
+  }
+  msg += "This could be caused by the graph being too large or splitting the graph into too many subgraphs. "
+         "Memory requirements for large graphs can be reduced by selecting different folding options, "
+         "reducing batch size or selecting architectures with less padding.";
+  throw std::runtime_error(msg);
+}
+
+void DeviceMemoryAllocator::FreePrivateBuffer(uint64_t bufferAddr) {
+  auto it = privateBuffers_.find(bufferAddr);
+  if (it == privateBuffers_.end()) {
+    throw std::runtime_error("FPGA DDR free failed, no buffer was allocated at address " +
+                             std::to_string(bufferAddr));
+  }
+  InsertFreeBlock(bufferAddr, it->second.blockSize);
+  privateBuffers_.erase(it);
+}
+
+bool DeviceMemoryAllocator::AllocateConstantBuffer(const void* bufferData,
+                                                   uint64_t bufferSize,
+                                                   uint64_t bufferAlignment,
+                                                   uint64_t& bufferAddr) {
+  if (bufferSize == 0) {
+    AllocatePrivateBuffer(bufferSize, bufferAlignment, bufferAddr);
+    return false;
+  }
+
+  uint64_t hash1, hash2;
+  HashBuffer(bufferData, bufferSize, hash1, hash2);
+  ConstantBufferKey key(hash1, hash2, bufferSize, bufferAlignment);
+  auto it = constantBufferAddrs_.find(key);
+  if (it != constantBufferAddrs_.end()) {
+    bufferAddr = it->second;
+    constantBuffers_[bufferAddr].refCount++;
+    return false;
+  }
+
+  AllocatePrivateBuffer(bufferSize, bufferAlignment, bufferAddr);
+  constantBuffers_[bufferAddr] = ConstantBuffer{key, 1};
+  constantBufferAddrs_[key] = bufferAddr;
+  return true;
+}
+
+void DeviceMemoryAllocator::FreeConstantBuffer(uint64_t bufferAddr) {
+  auto it = constantBuffers_.find(bufferAddr);
+  if (it == constantBuffers_.end()) {
+    throw std::runtime_error("FPGA DDR free failed, no constant buffer was allocated at address " +
+                             std::to_string(bufferAddr));
+  }
+  if (--it->second.refCount == 0) {
+    constantBufferAddrs_.erase(it->second.key);
+    constantBuffers_.erase(it);
+    FreePrivateBuffer(bufferAddr);
+  }
+}
+
+void DeviceMemoryAllocator::InsertFreeBlock(uint64_t addr, uint64_t size) {
+  // merge with the block above
+  auto next = freeBlocks_.lower_bound(addr);
+  if (next != freeBlocks_.end() && addr + size == next->first) {
+    size += next->second;
+    next = freeBlocks_.erase(next);
+  }
+  // merge with the block below
+  if (next != freeBlocks_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == addr) {
+      prev->second += size;
+      return;
+    }
+  }
+  freeBlocks_[addr] = size;
+}
+
+// Walk the buffers from the highest address down and pack each one directly below the previous one. A buffer only
+// ever moves upwards and never past the buffer above it, so each copy only overwrites free space or its own old
+// location, and MmdWrapper::CopyDDR handles that overlap.
+void DeviceMemoryAllocator::Compact(int instance, const std::function<void(uint64_t oldAddr, uint64_t newAddr)>& relocate) {
+  std::map<uint64_t, PrivateBuffer> packedBuffers;
+  std::map<uint64_t, ConstantBuffer> packedConstantBuffers;
+  uint64_t packedStart = totalGlobalMemSize_;
+  for (auto it = privateBuffers_.rbegin(); it != privateBuffers_.rend(); ++it) {
+    const PrivateBuffer& buffer = it->second;
+    uint64_t oldAddr = it->first;
+    uint64_t newAddr = packedStart - buffer.size;
+    newAddr -= (newAddr % buffer.alignment);
+    if (newAddr != oldAddr) {
+      mmdWrapper_->CopyDDR(instance, newAddr, oldAddr, buffer.size);
+      relocate(oldAddr, newAddr);
+    }
+    packedBuffers[newAddr] = PrivateBuffer{buffer.size, buffer.alignment, packedStart - newAddr};
+    auto constantBuffer = constantBuffers_.find(oldAddr);
+    if (constantBuffer != constantBuffers_.end()) {
+      packedConstantBuffers[newAddr] = constantBuffer->second;
+      constantBufferAddrs_[constantBuffer->second.key] = newAddr;
+    }
+    packedStart = newAddr;
+  }
+  privateBuffers_.swap(packedBuffers);
+  constantBuffers_.swap(packedConstantBuffers);
+  freeBlocks_.clear();
+  if (packedStart > 0) freeBlocks_[0] = packedStart;
+}
+
+uint64_t DeviceMemoryAllocator::GetFreeSize() const {
+  uint64_t freeSize = 0;
+  for (const auto& block : freeBlocks_) {
+    uint64_t blockEnd = block.first + block.second;
+    uint64_t lowestUsableAddr = std::max(block.first, PrivateSpaceStart());
+    if (blockEnd > lowestUsableAddr) freeSize += blockEnd - lowestUsableAddr;
+  }
+  return freeSize;
+}
+
+uint64_t DeviceMemoryAllocator::GetLargestFreeBlockSize() const {
+  uint64_t largestSize = 0;
+  for (const auto& block : freeBlocks_) {
+    uint64_t blockEnd = block.first + block.second;
+    uint64_t lowestUsableAddr = std::max(block.first, PrivateSpaceStart());
+    if (blockEnd > lowestUsableAddr) largestSize = std::max(largestSize, blockEnd - lowestUsableAddr);
+  }
+  return largestSize;
 }
 
 void DeviceMemoryAllocator::Clear() {
   currentIntermediateMaxBufferSizeAllocated_ = 0;
-  currentStartAddressGraphBufferSpace_ = totalGlobalMemSize_;
+  sharedBufferSizes_.clear();
+  constantBuffers_.clear();
+  constantBufferAddrs_.clear();
+  privateBuffers_.clear();
+  freeBlocks_.clear();
+  freeBlocks_[0] = totalGlobalMemSize_;
 }
 
 DeviceMemoryAllocator::~DeviceMemoryAllocator() { Clear(); }
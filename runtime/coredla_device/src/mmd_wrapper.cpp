@@ -15,11 +15,13 @@
 #include "aocl_mmd.h"           // aocl_mmd_***
 #include "dla_dma_constants.h"  // DLA_DMA_CSR_OFFSET_***
 
+#include <algorithm>  // std::min
 #include <cassert>    // assert
 #include <cstddef>    // size_t
 #include <iostream>   // std::cerr
 #include <stdexcept>  // std::runtime_error
 #include <string>     // std::string
+#include <vector>     // std::vector
 
 // All board variants must obey the CoreDLA CSR spec, which says that all access must be
 // - 32 bits in size
@@ -33,6 +35,20 @@ constexpr uint64_t DLA_CSR_SIZE = 2048;
 template <class T>
 void suppress_warning_unused_varible(const T &) {}
 
+#ifdef DDR_ASYNC_ACCESS
+// Called by the MMD when an asynchronous DDR transfer completes, op is the promise created by
+// WriteToDDRAsync or ReadFromDDRAsync
+static void DdrTransferStatusHandler(int handle, void *user_data, aocl_mmd_op_t op, int status) {
+  std::promise<void> *done = static_cast<std::promise<void> *>(op);
+  if (status) {
+    done->set_exception(std::make_exception_ptr(std::runtime_error("Asynchronous DDR transfer failed")));
+  } else {
+    done->set_value();
+  }
+  delete done;
+}
+#endif
+
 MmdWrapper::MmdWrapper(bool enableLog) {
   // Open the MMD
   constexpr size_t MAX_BOARD_NAMES_LEN = 4096;
@@ -70,9 +86,27 @@ MmdWrapper::MmdWrapper(bool enableLog) {
   }
   ddrClockFreq_ = dla_mmd_get_ddr_clock_freq();
   logLevel_ = enableLog ? MmdLogLevel::ENABLE : MmdLogLevel::DISABLE;
+
+#ifdef DDR_ASYNC_ACCESS
+  status = aocl_mmd_set_status_handler(handle_, DdrTransferStatusHandler, nullptr);
+  if (status) {
+    std::string msg = "Failed to register a status handler with MMD";
+    throw std::runtime_error(msg);
+  }
+#endif
 }
 
 MmdWrapper::~MmdWrapper() {
+  // Finish any queued asynchronous DDR transfers before the MMD is closed
+  if (ddrTransferThread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(ddrTransferMutex_);
+      ddrTransferStop_ = true;
+    }
+    ddrTransferCondVar_.notify_all();
+    ddrTransferThread_.join();
+  }
+
   // Close the MMD
   int status = aocl_mmd_close(handle_);
   if (status) {
@@ -116,6 +150,36 @@ uint32_t MmdWrapper::ReadFromCsr(int instance, uint32_t addr) const {
   return data;
 }
 
+void MmdWrapper::WriteToCsrCached(int instance, uint32_t addr, uint32_t data) const {
+  {
+    std::lock_guard<std::mutex> lock(csrShadowMutex_);
+    auto it = csrShadow_.find(std::make_pair(instance, addr));
+    if (it != csrShadow_.end() && it->second == data) return;
+  }
+  WriteToCsr(instance, addr, data);
+  std::lock_guard<std::mutex> lock(csrShadowMutex_);
+  csrShadow_[std::make_pair(instance, addr)] = data;
+}
+
+void MmdWrapper::InvalidateCsrCache(int instance) const {
+  std::lock_guard<std::mutex> lock(csrShadowMutex_);
+  csrShadow_.erase(csrShadow_.lower_bound(std::make_pair(instance, 0u)),
+                   csrShadow_.lower_bound(std::make_pair(instance + 1, 0u)));
+}
+
+// The MMDs have no multi register access, every CSR access is a single MMIO so a batch costs the same as its parts
+void MmdWrapper::WriteToCsrBatch(int instance, const uint32_t *addrs, const uint32_t *data, size_t count) const {
+  for (size_t i = 0; i < count; i++) {
+    WriteToCsr(instance, addrs[i], data[i]);
+  }
+}
+
+void MmdWrapper::ReadFromCsrBatch(int instance, const uint32_t *addrs, uint32_t *data, size_t count) const {
+  for (size_t i = 0; i < count; i++) {
+    data[i] = ReadFromCsr(instance, addrs[i]);
+  }
+}
+
 void MmdWrapper::WriteToDDR(int instance, uint64_t addr, uint64_t length, const void *data) const {
   assert(instance >= 0 && instance < maxInstances_);
   assert(addr + length <= ddrSizePerInstance_);
@@ -132,6 +196,123 @@ void MmdWrapper::ReadFromDDR(int instance, uint64_t addr, uint64_t length, void
   suppress_warning_unused_varible(status);
 }
 
+void MmdWrapper::CopyDDR(int instance, uint64_t dstAddr, uint64_t srcAddr, uint64_t length) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  assert(dstAddr + length <= ddrSizePerInstance_);
+  assert(srcAddr + length <= ddrSizePerInstance_);
+  if (length == 0 || dstAddr == srcAddr) return;
+#ifdef DDR_COPY_ACCESS
+  if (dla_mmd_ddr_copy(handle_, instance, srcAddr, dstAddr, length) == 0) return;
+#endif
+  // Bounce through host memory. When moving data upwards, copy the chunks starting from the end of the range so
+  // that each chunk of the source is read before the overlapping destination overwrites it.
+  constexpr uint64_t chunkSize = 1ULL << 20;
+  std::vector<uint8_t> staging(std::min(chunkSize, length));
+  for (uint64_t copied = 0; copied < length;) {
+    uint64_t count = std::min(chunkSize, length - copied);
+    uint64_t offset = (dstAddr > srcAddr) ? (length - copied - count) : copied;
+    ReadFromDDR(instance, srcAddr + offset, count, staging.data());
+    WriteToDDR(instance, dstAddr + offset, count, staging.data());
+    copied += count;
+  }
+}
+
+void *MmdWrapper::GetMappedDDR(int instance, uint64_t &length) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  length = 0;
+#ifdef DDR_MAP_ACCESS
+  return dla_mmd_ddr_map(handle_, instance, &length);
+#else
+  return nullptr;
+#endif
+}
+
+// Without DDR_MAP_ACCESS nothing is mapped, see GetMappedDDR
+void MmdWrapper::SyncMappedDDR(int instance, uint64_t addr, uint64_t length, bool toDevice) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  assert(addr + length <= ddrSizePerInstance_);
+#ifdef DDR_MAP_ACCESS
+  if (dla_mmd_ddr_sync(handle_, instance, addr, length, toDevice ? 1 : 0) != 0) {
+    throw std::runtime_error("Failed to sync the mapped device memory");
+  }
+#endif
+}
+
+#ifdef DDR_ASYNC_ACCESS
+// The MMD queues the transfer on its own DMA work thread
+std::future<void> MmdWrapper::WriteToDDRAsync(int instance, uint64_t addr, uint64_t length, const void *data) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  assert(addr + length <= ddrSizePerInstance_);
+  std::promise<void> *done = new std::promise<void>();
+  std::future<void> future = done->get_future();
+  int status = dla_mmd_ddr_write_async(handle_, instance, addr, length, data, done);
+  if (status) {
+    delete done;
+    throw std::runtime_error("Failed to queue an asynchronous DDR write");
+  }
+  return future;
+}
+
+std::future<void> MmdWrapper::ReadFromDDRAsync(int instance, uint64_t addr, uint64_t length, void *data) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  assert(addr + length <= ddrSizePerInstance_);
+  std::promise<void> *done = new std::promise<void>();
+  std::future<void> future = done->get_future();
+  int status = dla_mmd_ddr_read_async(handle_, instance, addr, length, data, done);
+  if (status) {
+    delete done;
+    throw std::runtime_error("Failed to queue an asynchronous DDR read");
+  }
+  return future;
+}
+#else
+// The MMD only has blocking transfers, run them on the DDR transfer thread
+std::future<void> MmdWrapper::WriteToDDRAsync(int instance, uint64_t addr, uint64_t length, const void *data) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  assert(addr + length <= ddrSizePerInstance_);
+  return EnqueueDdrTransfer([=]() {
+    if (dla_mmd_ddr_write(handle_, instance, addr, length, data)) {
+      throw std::runtime_error("Asynchronous DDR write failed");
+    }
+  });
+}
+
+std::future<void> MmdWrapper::ReadFromDDRAsync(int instance, uint64_t addr, uint64_t length, void *data) const {
+  assert(instance >= 0 && instance < maxInstances_);
+  assert(addr + length <= ddrSizePerInstance_);
+  return EnqueueDdrTransfer([=]() {
+    if (dla_mmd_ddr_read(handle_, instance, addr, length, data)) {
+      throw std::runtime_error("Asynchronous DDR read failed");
+    }
+  });
+}
+#endif
+
+std::future<void> MmdWrapper::EnqueueDdrTransfer(std::function<void()> transfer) const {
+  std::call_once(ddrTransferThreadStarted_, [this]() { ddrTransferThread_ = std::thread(&MmdWrapper::DdrTransferThread, this); });
+  std::packaged_task<void()> task(transfer);
+  std::future<void> future = task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(ddrTransferMutex_);
+    ddrTransferQueue_.push_back(std::move(task));
+  }
+  ddrTransferCondVar_.notify_one();
+  return future;
+}
+
+void MmdWrapper::DdrTransferThread() const {
+  std::unique_lock<std::mutex> lock(ddrTransferMutex_);
+  while (true) {
+    ddrTransferCondVar_.wait(lock, [this]() { return ddrTransferStop_ || !ddrTransferQueue_.empty(); });
+    if (ddrTransferQueue_.empty()) break;  // stop requested and nothing left to transfer
+    std::packaged_task<void()> task = std::move(ddrTransferQueue_.front());
+    ddrTransferQueue_.pop_front();
+    lock.unlock();
+    task();  // exceptions are stored in the future
+    lock.lock();
+  }
+}
+
 void MmdWrapper::enableCSRLogger() {
   // Non-hostless MMD currently does not support CSR logging
   // This function is required by the system-console runtime
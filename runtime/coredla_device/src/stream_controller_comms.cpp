@@ -12,7 +12,9 @@
 // License.
 
 #include "stream_controller_comms.h"
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstring>
 #include <iostream>
 #include <sstream>
@@ -24,6 +26,33 @@
 static const uint32_t messageReadyMagicNumber = 0x55225522;
 static constexpr uint32_t mailboxRamSize = 0x1000;
 
+static_assert(offsetof(MessageHeader, _payload) + sizeof(ScheduleItemsPayload) <= mailboxRamSize / 2,
+              "ScheduleItemsPayload does not fit in the send half of the mailbox");
+
+// The NIOS-V polls the mailbox continuously and normally answers within a few microseconds,
+// so spin for a short while before giving up the CPU between polls
+static constexpr std::chrono::microseconds mailboxSpinTime(50);
+static constexpr std::chrono::milliseconds mailboxTimeout(100);
+
+// Polls isReady until it returns true or mailboxTimeout has passed
+template <typename Predicate>
+static bool WaitForMailbox(Predicate isReady) {
+  auto startTime = std::chrono::steady_clock::now();
+  while (true) {
+    if (isReady()) {
+      return true;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    if (elapsed >= mailboxTimeout) {
+      return false;
+    }
+    if (elapsed >= mailboxSpinTime) {
+      std::this_thread::yield();
+    }
+  }
+}
+
 StreamControllerComms::StreamControllerComms() {}
 
 bool StreamControllerComms::IsPresent() {
@@ -39,11 +68,7 @@ bool StreamControllerComms::IsPresent() {
 
 // Query for the current status
 Payload<StatusMessagePayload> StreamControllerComms::GetStatus() {
-  BusyCheck busyCheck(_busyFlag);
-  if (!busyCheck) {
-    return {};
-  }
-
+  std::lock_guard<std::mutex> lock(_mailboxMutex);
   if (SendMessage(MessageType_GetStatus)) {
     if (ReceiveMessage() == MessageType_Status) {
       return _receivedStatusMessage;
@@ -53,16 +78,62 @@ Payload<StatusMessagePayload> StreamControllerComms::GetStatus() {
   return {};
 }
 
-// Schedule an inference request with the stream controller
+// Schedule inference requests with the stream controller
 bool StreamControllerComms::ScheduleItems(std::vector<Payload<CoreDlaJobPayload>> items) {
-  BusyCheck busyCheck(_busyFlag);
-  if (!busyCheck) {
+  {
+    std::lock_guard<std::mutex> lock(_pendingItemsMutex);
+    _pendingItems.insert(_pendingItems.end(), items.begin(), items.end());
+
+    // The thread that is already sending picks these up with its next message
+    if (_sendingItems) {
+      return true;
+    }
+    _sendingItems = true;
+  }
+
+  // Keep going after a failed message, the other threads' items were accepted already
+  bool status = true;
+  while (true) {
+    std::vector<Payload<CoreDlaJobPayload>> batch;
+    {
+      std::lock_guard<std::mutex> lock(_pendingItemsMutex);
+      if (_pendingItems.empty()) {
+        _sendingItems = false;
+        break;
+      }
+
+      size_t batchSize = std::min<size_t>(_pendingItems.size(), MaxScheduleItemsPerMessage);
+      batch.assign(_pendingItems.begin(), _pendingItems.begin() + batchSize);
+      _pendingItems.erase(_pendingItems.begin(), _pendingItems.begin() + batchSize);
+    }
+
+    std::lock_guard<std::mutex> lock(_mailboxMutex);
+    if (!SendScheduleItems(batch)) {
+      status = false;
+    }
+  }
+
+  return status;
+}
+
+// Send a batch of jobs in one ScheduleItems message, or one ScheduleItem message
+// per job if the stream controller firmware does not support ScheduleItems
+bool StreamControllerComms::SendScheduleItems(const std::vector<Payload<CoreDlaJobPayload>>& items) {
+  if (_batchSupported and (items.size() > 1)) {
+    Payload<ScheduleItemsPayload> scheduleItemsPayload;
+    scheduleItemsPayload._numItems = static_cast<uint32_t>(items.size());
+    std::copy(items.begin(), items.end(), scheduleItemsPayload._items);
+    size_t payloadSize = offsetof(ScheduleItemsPayload, _items) + items.size() * sizeof(CoreDlaJobPayload);
+
+    if (SendMessage(MessageType_ScheduleItems, scheduleItemsPayload.GetPayload(), payloadSize)) {
+      return (ReceiveMessage() == MessageType_NoOperation);
+    }
     return false;
   }
 
   bool status = true;
 
-  for (auto& job : items) {
+  for (auto job : items) {
     bool thisJobStatus = false;
 
     if (SendMessage(MessageType_ScheduleItem, job.GetPayload(), job.GetSize())) {
@@ -80,15 +151,24 @@ bool StreamControllerComms::ScheduleItems(std::vector<Payload<CoreDlaJobPayload>
 }
 
 // Send a ping command to the stream controller and wait for a pong
-// response.
+// response. The pong carries the firmware capabilities, firmware that
+// predates them sends no payload, so the field is cleared first and
+// stays 0. Sending it an unknown message type instead would set its
+// sticky BadMessage status.
 bool StreamControllerComms::Ping() {
-  BusyCheck busyCheck(_busyFlag);
-  if (!busyCheck) {
-    return false;
-  }
+  std::lock_guard<std::mutex> lock(_mailboxMutex);
+
+  MessageHeader* pReceiveMessage = nullptr;
+  uint32_t pongPayloadOffset = static_cast<uint32_t>(mailboxRamSize / 2 + (size_t)&pReceiveMessage->_payload);
+  Payload<PongPayload> noCapabilities{};
+  _mmdWrapper.WriteToStreamController(
+      _streamControllerInstance, pongPayloadOffset, noCapabilities.GetSize(), noCapabilities.GetPayload());
 
   if (SendMessage(MessageType_Ping)) {
-    return (ReceiveMessage() == MessageType_Pong);
+    if (ReceiveMessage() == MessageType_Pong) {
+      _batchSupported = (_receivedPongMessage._capabilities & StreamControllerCapability_ScheduleItems) != 0;
+      return true;
+    }
   }
 
   return false;
@@ -110,10 +190,7 @@ bool StreamControllerComms::Ping() {
 bool StreamControllerComms::Initialize(uint32_t sourceBufferSize,
                                        uint32_t dropSourceBuffers,
                                        uint32_t numInferenceRequests) {
-  BusyCheck busyCheck(_busyFlag);
-  if (!busyCheck) {
-    return false;
-  }
+  std::lock_guard<std::mutex> lock(_mailboxMutex);
 
   Payload<InitializeStreamControllerPayload> initializePayload{};
   initializePayload._sourceBufferSize = sourceBufferSize;
@@ -132,45 +209,45 @@ bool StreamControllerComms::Initialize(uint32_t sourceBufferSize,
 
 // Receive a message from the stream controller by reading from the
 // mailbox memory until the magic number is set to indicate a message is ready.
-// Only the Status return message has a payload
+// Only the Status and Pong return messages have a payload
 MessageType StreamControllerComms::ReceiveMessage() {
   uint32_t receiveMessageOffset = mailboxRamSize / 2;
   MessageHeader* pReceiveMessage = nullptr;
   uint32_t messageReadyMagicNumberOffset = receiveMessageOffset;
   uint32_t payloadOffset = static_cast<uint32_t>(receiveMessageOffset + (size_t)&pReceiveMessage->_payload);
-  uint32_t waitCount = 0;
 
-  while (waitCount < 100) {
-    MessageHeader messageHeader;
+  MessageHeader messageHeader;
+  auto isMessageReady = [&]() {
     _mmdWrapper.ReadFromStreamController(
         _streamControllerInstance, receiveMessageOffset, sizeof(messageHeader), &messageHeader);
-    if (messageHeader._messageReadyMagicNumber == messageReadyMagicNumber) {
-      MessageType messageType = static_cast<MessageType>(messageHeader._messageType);
-      uint32_t sequenceId = messageHeader._sequenceID;
+    return (messageHeader._messageReadyMagicNumber == messageReadyMagicNumber);
+  };
 
-      bool ok = false;
+  if (!WaitForMailbox(isMessageReady)) {
+    return MessageType_Invalid;
+  }
 
-      if (messageType == MessageType_Status) {
-        ok = StatusMessageHandler(payloadOffset);
-      } else if (messageType == MessageType_Pong) {
-        ok = true;
-      }
+  MessageType messageType = static_cast<MessageType>(messageHeader._messageType);
+  uint32_t sequenceId = messageHeader._sequenceID;
 
-      if (!ok) {
-        _numBadMessages++;
-      }
+  bool ok = false;
 
-      _mmdWrapper.WriteToStreamController(
-          _streamControllerInstance, messageReadyMagicNumberOffset, sizeof(sequenceId), &sequenceId);
-      _lastReceiveSequenceID = sequenceId;
-      return messageType;
-    }
+  if (messageType == MessageType_Status) {
+    ok = StatusMessageHandler(payloadOffset);
+  } else if (messageType == MessageType_Pong) {
+    ok = PongMessageHandler(payloadOffset);
+  } else if (messageType == MessageType_NoOperation) {
+    ok = true;
+  }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    waitCount++;
+  if (!ok) {
+    _numBadMessages++;
   }
 
-  return MessageType_Invalid;
+  _mmdWrapper.WriteToStreamController(
+      _streamControllerInstance, messageReadyMagicNumberOffset, sizeof(sequenceId), &sequenceId);
+  _lastReceiveSequenceID = sequenceId;
+  return messageType;
 }
 
 // Send a message to the stream controller by writing to the mailbox memory,
@@ -202,19 +279,16 @@ bool StreamControllerComms::SendMessage(MessageType messageType, void* pPayload,
 
   // Wait until the message has been processed by looking for the sequence ID
   // in the magic number position
-  uint32_t waitCount = 0;
-  while (waitCount < 100) {
-    MessageHeader messageHeader;
+  auto isMessageTaken = [&]() {
+    uint32_t magicNumber = 0;
     _mmdWrapper.ReadFromStreamController(
-        _streamControllerInstance, sendMessageOffset, sizeof(messageHeader), &messageHeader);
-
-    if (messageHeader._messageReadyMagicNumber == _sendSequenceID) {
-      _sendSequenceID++;
-      return true;
-    }
+        _streamControllerInstance, sendMessageOffset, sizeof(magicNumber), &magicNumber);
+    return (magicNumber == _sendSequenceID);
+  };
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    waitCount++;
+  if (WaitForMailbox(isMessageTaken)) {
+    _sendSequenceID++;
+    return true;
   }
 
   return false;
@@ -227,6 +301,13 @@ bool StreamControllerComms::StatusMessageHandler(uint32_t payloadOffset) {
   return true;
 }
 
+// Read the pong message payload
+bool StreamControllerComms::PongMessageHandler(uint32_t payloadOffset) {
+  _mmdWrapper.ReadFromStreamController(
+      _streamControllerInstance, payloadOffset, sizeof(_receivedPongMessage), &_receivedPongMessage);
+  return true;
+}
+
 // Parse the status message payload into a string
 std::string StreamControllerComms::GetStatusString(Payload<StatusMessagePayload>& statusPayload) {
   std::ostringstream stringStream;
@@ -236,39 +317,3 @@ std::string StreamControllerComms::GetStatusString(Payload<StatusMessagePayload>
   return stringStream.str();
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
-// BusyFlag is used to prevent concurrent access to the stream controller,
-// without holding a mutex when sending/receiving commands
-using LockGuard = std::lock_guard<std::recursive_mutex>;
-
-bool BusyFlag::Lock() {
-  LockGuard lock(_mutex);
-  if (_busy) {
-    return false;
-  }
-
-  _busy = true;
-  return true;
-}
-
-void BusyFlag::Release() {
-  LockGuard lock(_mutex);
-  _busy = false;
-}
-
-BusyCheck::BusyCheck(BusyFlag& busyFlag) : _busyFlag(busyFlag), _haveLocked(false) {}
-
-BusyCheck::~BusyCheck() {
-  if (_haveLocked) {
-    _busyFlag.Release();
-  }
-}
-
-BusyCheck::operator bool() {
-  bool locked = _busyFlag.Lock();
-  if (locked) {
-    _haveLocked = true;
-  }
-  return locked;
-}
@@ -33,9 +33,26 @@ bool ScheduleItemMessageHandler(StreamController* this, volatile uint32_t* pPayl
     return true;
 }
 
+bool ScheduleItemsMessageHandler(StreamController* this, volatile uint32_t* pPayload)
+{
+    volatile ScheduleItemsPayload* pScheduleItemsPayload = (volatile ScheduleItemsPayload*)pPayload;
+    uint32_t numItems = pScheduleItemsPayload->_numItems;
+    if (numItems > MaxScheduleItemsPerMessage)
+        return false;
+
+    // Same as numItems ScheduleItem messages, with a single reply
+    for (uint32_t i = 0; i < numItems; i++)
+        this->NewInferenceRequestReceived(this, &pScheduleItemsPayload->_items[i]);
+
+    this->SendMessage(this, MessageType_NoOperation, NULL, 0);
+    return true;
+}
+
 bool PingMessageHandler(StreamController* this, volatile uint32_t* pPayload)
 {
-    this->SendMessage(this, MessageType_Pong, NULL, 0);
+    PongPayload pongPayload;
+    pongPayload._capabilities = StreamControllerCapability_ScheduleItems;
+    this->SendMessage(this, MessageType_Pong, &pongPayload, sizeof(pongPayload));
     return true;
 }
 
@@ -16,6 +16,7 @@
 
 extern bool InitializeStreamControllerMessageHandler(StreamController* this, volatile uint32_t* pPayload);
 extern bool ScheduleItemMessageHandler(StreamController* this, volatile uint32_t* pPayload);
+extern bool ScheduleItemsMessageHandler(StreamController* this, volatile uint32_t* pPayload);
 extern bool PingMessageHandler(StreamController* this, volatile uint32_t* pPayload);
 extern bool GetStatusMessageHandler(StreamController* this, volatile uint32_t* pPayload);
 extern bool ManualArmDmaTransferMessageHandler(StreamController* this, volatile uint32_t* pPayload);
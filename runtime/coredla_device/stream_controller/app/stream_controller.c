@@ -62,6 +62,7 @@ int main()
     // Message handlers
     this->GetStatusMessageHandler = GetStatusMessageHandler;
     this->ScheduleItemMessageHandler = ScheduleItemMessageHandler;
+    this->ScheduleItemsMessageHandler = ScheduleItemsMessageHandler;
     this->PingMessageHandler = PingMessageHandler;
     this->InitializeStreamControllerMessageHandler = InitializeStreamControllerMessageHandler;
     this->ManualArmDmaTransferMessageHandler = ManualArmDmaTransferMessageHandler;
@@ -188,6 +189,8 @@ static MessageType ReceiveMessage(StreamController* this, volatile MessageHeader
         ok = this->GetStatusMessageHandler(this, pPayload);
     else if (messageType == MessageType_ScheduleItem)
         ok = this->ScheduleItemMessageHandler(this, pPayload);
+    else if (messageType == MessageType_ScheduleItems)
+        ok = this->ScheduleItemsMessageHandler(this, pPayload);
     else if (messageType == MessageType_Ping)
         ok = this->PingMessageHandler(this, pPayload);
     else if (messageType == MessageType_InitializeStreamController)
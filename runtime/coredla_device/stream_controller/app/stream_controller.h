@@ -58,6 +58,7 @@ typedef struct StreamController
     // Message handlers
     bool        (*GetStatusMessageHandler)(struct StreamController* this, volatile uint32_t* pPayload);
     bool        (*ScheduleItemMessageHandler)(struct StreamController* this, volatile uint32_t* pPayload);
+    bool        (*ScheduleItemsMessageHandler)(struct StreamController* this, volatile uint32_t* pPayload);
     bool        (*PingMessageHandler)(struct StreamController* this, volatile uint32_t* pPayload);
     bool        (*InitializeStreamControllerMessageHandler)(struct StreamController* this, volatile uint32_t* pPayload);
     bool        (*ManualArmDmaTransferMessageHandler)(struct StreamController* this, volatile uint32_t* pPayload);
@@ -25,7 +25,8 @@ typedef enum
     MessageType_Pong,
     MessageType_InitializeStreamController,
     MessageType_ManualArmDmaTransfer,
-    MessageType_ManualScheduleDlaInference
+    MessageType_ManualScheduleDlaInference,
+    MessageType_ScheduleItems
 } MessageType;
 
 typedef enum
@@ -58,6 +59,17 @@ typedef struct
     uint32_t _outputAddressDDR;
 } CoreDlaJobPayload;
 
+// The 4 KB mailbox is split in two, the first half carries messages to the stream controller
+// and the second half its replies. A ScheduleItems payload starts at MessageHeader::_payload,
+// so it can carry up to (0x800 - 12 - 4) / 16 = 127 jobs.
+#define MaxScheduleItemsPerMessage 127
+
+typedef struct
+{
+    uint32_t _numItems;
+    CoreDlaJobPayload _items[MaxScheduleItemsPerMessage];
+} ScheduleItemsPayload;
+
 typedef struct
 {
     uint32_t _sourceBufferSize;
@@ -65,6 +77,15 @@ typedef struct
     uint32_t _numInferenceRequests;
 } InitializeStreamControllerPayload;
 
+// Bits of PongPayload::_capabilities. Firmware that predates the field replies to a Ping
+// without a payload, the host clears the field before sending the Ping to detect that.
+#define StreamControllerCapability_ScheduleItems 0x1
+
+typedef struct
+{
+    uint32_t _capabilities;
+} PongPayload;
+
 typedef struct
 {
     NiosStatusType _status;
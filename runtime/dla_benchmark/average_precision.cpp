@@ -29,10 +29,13 @@
 namespace fs = std::filesystem;
 #endif
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <thread>
 #include <utility>
 #include <sstream>
 
@@ -214,7 +217,7 @@ void reduce_by_index(std::vector<T> &vec, std::vector<unsigned> indices) {
 
 // Calculates and returns the Intersection over Union score for two boxes by
 // calculating their area of overlap and area of union.
-double intersection_over_union(Box<double> box1, Box<double> box2) {
+double intersection_over_union(const Box<double> &box1, const Box<double> &box2) {
   using namespace std;
   {
     double intersect_length_x =
@@ -328,14 +331,35 @@ void resize_and_filter_prediction_boxes(Tensor2d<double> &raw_predictions,
 #endif
 }
 
-// Returns indices of `vec` sorted in descending order.
+// Returns indices of `vec` sorted in descending order. Equal values keep their order, so the result does not
+// depend on the sort implementation.
 std::vector<unsigned> argsort_gt(const std::vector<double> &vec) {
   std::vector<unsigned> order(vec.size());
   std::generate(order.begin(), order.end(), [n = 0]() mutable { return n++; });
-  std::sort(order.begin(), order.end(), [&](int i1, int i2) { return vec[i1] > vec[i2]; });
+  std::stable_sort(order.begin(), order.end(), [&](int i1, int i2) { return vec[i1] > vec[i2]; });
   return order;
 }
 
+// Calls `func` with every index in [0, `count`) from all cores. Indices are handed out one at a time, so uneven
+// work items balance out.
+void parallel_for(size_t count, const std::function<void(size_t)> &func) {
+  std::atomic<size_t> next_index{0};
+  const auto run = [&]() {
+    for (size_t index = next_index++; index < count; index = next_index++) {
+      func(index);
+    }
+  };
+  const size_t num_threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
 // Performs non-maximum suppression algorithm to eliminate repetitive bounding boxes.
 // A bounding box is preserved iff. it has the highest confidence score over all
 // overlapping bounding boxes.
@@ -408,21 +432,19 @@ void clip_box(PredictionEntry &prediction, const unsigned batch) {
   }
 }
 
-// Calculates area under the PR curve using 11-intervaled sum.
+// Calculates area under the PR curve using 11-intervaled sum. `recall` is non-decreasing, so the highest
+// precision at or above a recall point is a suffix maximum starting at the first recall that reaches the point.
 double average_precision(const std::vector<double> &precision, const std::vector<double> &recall, unsigned interval) {
+  std::vector<double> max_precision(precision.size() + 1, 0.0);
+  for (size_t idx = precision.size(); idx-- > 0;) {
+    max_precision[idx] = std::max(precision[idx], max_precision[idx + 1]);
+  }
   double result = 0.0;
   double step = 1 / (double)(interval - 1);
   for (unsigned intvl = 0; intvl < interval; intvl++) {
     double point = step * intvl;
-    double max_precision = 0.0;
-    for (unsigned idx = 0; idx < recall.size(); idx++) {
-      if (recall[idx] >= point) {
-        if (precision[idx] > max_precision) {
-          max_precision = precision[idx];
-        }
-      }
-    }
-    result += max_precision / (double)interval;
+    size_t first_idx = std::lower_bound(recall.begin(), recall.end(), point) - recall.begin();
+    result += max_precision[first_idx] / (double)interval;
   }
   return result;
 }
@@ -439,67 +461,86 @@ typedef struct _map_stats {
   _map_stats() { this->num_gt_object = 0; }
 } mAPStats;
 
-// Calculates the 11-point interpolated mAP.
-std::vector<mAPStats> mean_average_precision(PredictionEntry &prediction, AnnotationEntry &annotation, double thresh) {
-  std::vector<int> class_list(yolo_meta.num_classes);
-  std::generate(class_list.begin(), class_list.end(), [n = 0]() mutable { return n++; });
+// Predicted bounding boxes of one class of an image, in descending order of class score, with the groundtruth
+// box of the class each one overlaps the most. This does not depend on the IoU threshold, so it is computed once
+// and shared by the mAP and every COCO threshold.
+typedef struct _class_matches {
+  int num_gt_object;
+  std::vector<double> scores;
+  // index of the most overlapped groundtruth box among the boxes of the class, and its IoU
+  std::vector<unsigned> most_overlapped_idx;
+  std::vector<double> most_overlapped_iou;
+
+  _class_matches() { this->num_gt_object = 0; }
+} ClassMatches;
+
+// Buckets the predicted and groundtruth bounding boxes by class and finds the most overlapped groundtruth box of
+// each predicted box. Boxes with a class outside of the evaluated classes are ignored.
+std::vector<ClassMatches> match_boxes(PredictionEntry &prediction, AnnotationEntry &annotation) {
+  std::vector<ClassMatches> matches(yolo_meta.num_classes);
+
+  std::vector<Tensor2d<double>> gt_boxes(yolo_meta.num_classes);
+  for (unsigned gtbox_idx = 0; gtbox_idx < annotation.size; gtbox_idx++) {
+    const int category = annotation.cls[gtbox_idx];
+    if (category < 0 || category >= (int)yolo_meta.num_classes) continue;
+    gt_boxes[category].emplace_back(annotation.box_at(gtbox_idx));
+  }
+
+  // visits the predicted boxes in descending order of class score, so every bucket ends up sorted.
+  for (unsigned pbox_idx : argsort_gt(prediction.cls_score)) {
+    const int category = prediction.cls[pbox_idx];
+    if (category < 0 || category >= (int)yolo_meta.num_classes) continue;
+    const Box<double> pbox = prediction.box_at(pbox_idx);
+
+    unsigned most_overlapped_idx = 0;
+    double most_overlapped_iou = 0.0;
+    for (unsigned gtbox_idx = 0; gtbox_idx < gt_boxes[category].size(); gtbox_idx++) {
+      double iou = intersection_over_union(pbox, gt_boxes[category][gtbox_idx]);
+      if (iou > most_overlapped_iou) {
+        most_overlapped_iou = iou;
+        most_overlapped_idx = gtbox_idx;
+      }
+    }
+    matches[category].scores.emplace_back(prediction.cls_score[pbox_idx]);
+    matches[category].most_overlapped_idx.emplace_back(most_overlapped_idx);
+    matches[category].most_overlapped_iou.emplace_back(most_overlapped_iou);
+  }
+
+  for (unsigned category = 0; category < yolo_meta.num_classes; category++) {
+    matches[category].num_gt_object = gt_boxes[category].size();
+  }
+  return matches;
+}
 
+// Calculates the per-class statistics of an image for the 11-point interpolated mAP at IoU threshold `thresh`.
+std::vector<mAPStats> mean_average_precision(const std::vector<ClassMatches> &matches, double thresh) {
   std::vector<mAPStats> image_result(yolo_meta.num_classes, mAPStats{});
+  // one bit per groundtruth box of the class, set once the box is matched.
+  std::vector<bool> matched_gtbox;
 
-  // average precision for each class
-  for (int category : class_list) {
-    // total number of bounding boxes in the annotation.
-    int num_gt_object =
-        std::count_if(annotation.cls.begin(), annotation.cls.end(), [&](int &cls) { return (cls == (int)category); });
-
-    // total number of predicted bounding boxes.
-    int num_pred_boxes =
-        std::count_if(prediction.cls.begin(), prediction.cls.end(), [&](int &cls) { return (cls == (int)category); });
-
-    image_result[category].num_gt_object = num_gt_object;
-
-    // stores the scores for sorting out the correct order of TP and FP.
-    image_result[category].true_positive.resize(num_pred_boxes, 0);
-    image_result[category].false_positive.resize(num_pred_boxes, 0);
-    image_result[category].scores.resize(num_pred_boxes, 0.0);
-    std::set<unsigned> matched_gtbox;
-
-    unsigned pred_num = 0;
-    std::vector<unsigned> &&sorted_pbox_idx = argsort_gt(prediction.cls_score);
-    for (unsigned &pbox_idx : sorted_pbox_idx) {
-      if (prediction.cls[pbox_idx] != category) continue;
-      image_result[category].scores[pred_num] = prediction.cls_score[pbox_idx];
-
-      unsigned most_overlapped_idx = 0;
-      double most_overlapped_iou = 0.0;
-
-      // finds the most overlapped predicted bounding box.
-      for (unsigned gtbox_idx = 0; gtbox_idx < annotation.size; gtbox_idx++) {
-        if (annotation.cls[gtbox_idx] != category) continue;
-        double iou = intersection_over_union(prediction.box_at(pbox_idx), annotation.box_at(gtbox_idx));
-        if (iou > most_overlapped_iou) {
-          most_overlapped_iou = iou;
-          most_overlapped_idx = gtbox_idx;
-        }
-      }
-      // when there is no ground truth, all predicted boxes are false positive,
-      // and they are preserved for batched AP calculation.
-      if (!num_gt_object) {
-        image_result[category].false_positive[pred_num++] = 1;
+  for (unsigned category = 0; category < yolo_meta.num_classes; category++) {
+    const ClassMatches &class_matches = matches[category];
+    mAPStats &stats = image_result[category];
+    const size_t num_pred_boxes = class_matches.scores.size();
+
+    stats.num_gt_object = class_matches.num_gt_object;
+    stats.scores = class_matches.scores;
+    stats.true_positive.assign(num_pred_boxes, 0);
+    stats.false_positive.assign(num_pred_boxes, 0);
+    matched_gtbox.assign(class_matches.num_gt_object, false);
+
+    for (size_t pred_num = 0; pred_num < num_pred_boxes; pred_num++) {
+      // the predicted bounding box is a true positive iff. it is the most overlapped,
+      // the matched groundtruth bounding box has not been matched previously, and
+      // the iou is above `thresh`. when there is no ground truth, all predicted boxes
+      // are false positive, and they are preserved for batched AP calculation.
+      const unsigned most_overlapped_idx = class_matches.most_overlapped_idx[pred_num];
+      if (class_matches.num_gt_object && class_matches.most_overlapped_iou[pred_num] >= thresh &&
+          !matched_gtbox[most_overlapped_idx]) {
+        matched_gtbox[most_overlapped_idx] = true;
+        stats.true_positive[pred_num] = 1;
       } else {
-        // the predicted bounding box is a true positive iff. it is the most overlapped,
-        // the matched groundtruth bounding box has not been matched previously, and
-        // the iou is above `thresh`.
-        if (most_overlapped_iou >= thresh) {
-          if (matched_gtbox.find(most_overlapped_idx) == matched_gtbox.end()) {
-            matched_gtbox.insert(most_overlapped_idx);
-            image_result[category].true_positive[pred_num++] = 1;
-          } else {
-            image_result[category].false_positive[pred_num++] = 1;
-          }
-        } else {
-          image_result[category].false_positive[pred_num++] = 1;
-        }
+        stats.false_positive[pred_num] = 1;
       }
     }
   }
@@ -546,13 +587,16 @@ struct metrics validate_yolo(std::vector<double> &results_data,
     exit(EXIT_FAILURE);
   }
 
+  // the boxes are matched once, the thresholds only decide which matches count.
+  const std::vector<ClassMatches> matches = match_boxes(prediction, annotation);
+
   // mAP
-  std::vector<mAPStats> map_stats = mean_average_precision(prediction, annotation, yolo_meta.pascal_voc_metric);
+  std::vector<mAPStats> map_stats = mean_average_precision(matches, yolo_meta.pascal_voc_metric);
 
   // COCO metric
   Tensor2d<mAPStats> coco_ap_stats;
   std::for_each(std::begin(yolo_meta.coco_metric), std::end(yolo_meta.coco_metric), [&](const double thresh) {
-    coco_ap_stats.emplace_back(mean_average_precision(prediction, annotation, thresh));
+    coco_ap_stats.emplace_back(mean_average_precision(matches, thresh));
   });
 
   return {map_stats, coco_ap_stats};
@@ -578,35 +622,75 @@ void metrics_update(std::vector<mAPStats> &batched_stats, const std::vector<mAPS
   }
 }
 
+// Calculates the AP of one class using the given integral function. Returns `false` if the class is omitted
+// because no prediction presents.
+bool class_average_precision(const mAPStats &stats, unsigned interval, double &class_ap) {
+  if (!stats.scores.size()) return false;
+  // the predictions are false-positive when there is no groundtruth for this
+  // class, and therefore the class AP is 0.0
+  if (stats.num_gt_object == 0) {
+    class_ap = 0.0;
+    return true;
+  }
+
+  int TP = 0, FP = 0;
+  std::vector<double> precision, recall;
+  precision.reserve(stats.scores.size());
+  recall.reserve(stats.scores.size());
+
+  // sorts the tp and fp based on the order of confidence score.
+  std::vector<unsigned> &&sorted_stats_index = argsort_gt(stats.scores);
+  // calculates intermediate statistics calculation.
+  for (unsigned idx : sorted_stats_index) {
+    TP += stats.true_positive[idx];
+    FP += stats.false_positive[idx];
+    precision.emplace_back(TP / (double)(TP + FP));
+    recall.emplace_back(TP / (double)stats.num_gt_object);
+  }
+  // returns ROC of P-R curve.
+  class_ap = average_precision(precision, recall, interval);
+  return true;
+}
+
 // Calculates AP using the given integral function.
 double metrics_eval(const std::vector<mAPStats> &stats, unsigned interval) {
   std::vector<double> class_aps;
   for (unsigned category = 0; category < yolo_meta.num_classes; category++) {
-    // omits the class when there is no prediction presents.
-    if (!stats[category].scores.size()) continue;
-    // the predictions are false-positive when there is no groundtruth for this
-    // class, and therefore the class AP is 0.0
-    if (stats[category].num_gt_object == 0 && stats[category].scores.size()) {
-      class_aps.push_back(0.0);
-      continue;
+    double class_ap;
+    if (class_average_precision(stats[category], interval, class_ap)) {
+      class_aps.push_back(class_ap);
     }
+  }
+  return std::accumulate(class_aps.begin(), class_aps.end(), 0.0) / (double)class_aps.size();
+}
+
+// Same as `metrics_eval` for several sets of statistics at once, with every class of every set evaluated in
+// parallel.
+std::vector<double> parallel_metrics_eval(const Tensor2d<mAPStats> &stats_sets,
+                                          const std::vector<unsigned> &intervals) {
+  const size_t num_classes = yolo_meta.num_classes;
+  Tensor2d<double> class_aps(stats_sets.size(), std::vector<double>(num_classes, 0.0));
+  std::vector<std::vector<char>> class_present(stats_sets.size(), std::vector<char>(num_classes, 0));
+  parallel_for(stats_sets.size() * num_classes, [&](size_t index) {
+    const size_t set = index / num_classes;
+    const size_t category = index % num_classes;
+    class_present[set][category] =
+        class_average_precision(stats_sets[set][category], intervals[set], class_aps[set][category]);
+  });
 
-    int TP = 0, FP = 0;
-    std::vector<double> precision, recall;
-
-    // sorts the tp and fp based on the order of confidence score.
-    std::vector<unsigned> &&sorted_stats_index = argsort_gt(stats[category].scores);
-    // calculates intermediate statistics calculation.
-    for (unsigned idx : sorted_stats_index) {
-      TP += stats[category].true_positive[idx];
-      FP += stats[category].false_positive[idx];
-      precision.emplace_back(TP / (double)(TP + FP));
-      recall.emplace_back(TP / (double)stats[category].num_gt_object);
+  // sums the class AP's in class order, so the result matches `metrics_eval`.
+  std::vector<double> results;
+  for (size_t set = 0; set < stats_sets.size(); set++) {
+    double sum = 0.0;
+    unsigned num_present = 0;
+    for (size_t category = 0; category < num_classes; category++) {
+      if (!class_present[set][category]) continue;
+      sum += class_aps[set][category];
+      num_present++;
     }
-    // returns ROC of P-R curve.
-    class_aps.emplace_back(average_precision(precision, recall, interval));
+    results.push_back(sum / (double)num_present);
   }
-  return std::accumulate(class_aps.begin(), class_aps.end(), 0.0) / (double)class_aps.size();
+  return results;
 }
 
 // Wrapper of the function `validate_yolo`. This function prepares data and dispatches metrics calculations for each
@@ -651,39 +735,59 @@ std::pair<double, double> validate_yolo_wrapper(std::map<std::string, ov::Tensor
     stats.resize(yolo_meta.num_classes, mAPStats{});
   });
 
-  for (unsigned batch = 0; batch < runtime_vars.niter; batch++) {
-    for (unsigned img = 0; img < runtime_vars.batch_size; img++) {
+  // images are validated in parallel, a chunk at a time so that only the statistics of one chunk are held. the
+  // statistics are accumulated in image order, which keeps the result independent of the number of cores.
+  const unsigned num_images = runtime_vars.niter * runtime_vars.batch_size;
+  const unsigned chunk_size = 64 * std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<metrics> chunk_stats;
+  std::vector<double> chunk_img_AP;
+  for (unsigned chunk_begin = 0; chunk_begin < num_images; chunk_begin += chunk_size) {
+    const unsigned chunk_end = std::min(chunk_begin + chunk_size, num_images);
+    chunk_stats.assign(chunk_end - chunk_begin, metrics{});
+    chunk_img_AP.assign(chunk_end - chunk_begin, 0.0);
+    parallel_for(chunk_end - chunk_begin, [&](size_t chunk_idx) {
+      const unsigned image = chunk_begin + chunk_idx;
+      const unsigned batch = image / runtime_vars.batch_size;
+      const unsigned img = image % runtime_vars.batch_size;
       // stores the flattened output tensors from the resulting convolution layers.
       std::vector<double> curr_img_data;
       for (auto &item : result_layout) {
         const std::string &name = item.get_any_name();
-        auto curr_outputBlob = raw_results.at(name).at(batch);
+        const auto &curr_outputBlob = raw_results.at(name).at(batch);
         auto output_tensor_start = curr_outputBlob.data<float>();
         unsigned output_size = curr_outputBlob.get_size() / runtime_vars.batch_size;
         unsigned offset = img * output_size;
-        for (unsigned idx = 0; idx < output_size; idx++) {
-          curr_img_data.push_back(output_tensor_start[idx + offset]);
-        }
+        curr_img_data.insert(curr_img_data.end(),
+                             output_tensor_start + offset,
+                             output_tensor_start + offset + output_size);
       }
 
-      struct metrics &&curr_img_stats =
-          validate_yolo(curr_img_data, raw_annotations, img + batch * runtime_vars.batch_size);
+      chunk_stats[chunk_idx] = validate_yolo(curr_img_data, raw_annotations, image);
+      chunk_img_AP[chunk_idx] = metrics_eval(chunk_stats[chunk_idx].map, yolo_meta.ap_interval);
+    });
+
+    for (unsigned chunk_idx = 0; chunk_idx < chunk_stats.size(); chunk_idx++) {
+      const metrics &curr_img_stats = chunk_stats[chunk_idx];
       metrics_update(batched_stats.map, curr_img_stats.map);
       for (unsigned thresh = 0; thresh < yolo_meta.coco_metric.size(); thresh++) {
         metrics_update(batched_stats.coco[thresh], curr_img_stats.coco[thresh]);
       }
-
-      double img_AP = metrics_eval(curr_img_stats.map, yolo_meta.ap_interval);
       // fout << "image " << input_files[img] << " AP @ 0.5" << std::endl;
-      fout << std::fixed << std::setprecision(10) << img_AP << std::endl;
+      fout << std::fixed << std::setprecision(10) << chunk_img_AP[chunk_idx] << std::endl;
     }
   }
 
-  double map = metrics_eval(batched_stats.map, yolo_meta.ap_interval);
-  double coco_ap = 0.0;
+  // the mAP and every COCO threshold are evaluated together.
+  Tensor2d<mAPStats> stats_sets;
+  stats_sets.emplace_back(std::move(batched_stats.map));
+  std::vector<unsigned> intervals{yolo_meta.ap_interval};
   for (auto &coco_stats : batched_stats.coco) {
-    coco_ap += metrics_eval(coco_stats, yolo_meta.coco_interval);
+    stats_sets.emplace_back(std::move(coco_stats));
+    intervals.push_back(yolo_meta.coco_interval);
   }
+  const std::vector<double> set_aps = parallel_metrics_eval(stats_sets, intervals);
+  double map = set_aps[0];
+  double coco_ap = std::accumulate(set_aps.begin() + 1, set_aps.end(), 0.0);
   coco_ap /= (double)yolo_meta.coco_metric.size();
 
   fout << "\nAP at IoU=.50: " << std::fixed << std::setprecision(6) << map * 100 << "%" << std::endl;
@@ -41,6 +41,45 @@ static const char iterations_count_message[] = "Required. Number of iterations."
 static const char infer_requests_count_message[] =
     "Optional. Number of infer requests. Default value is determined automatically for device.";
 
+/// @brief message for input_queue_depth option
+static const char input_queue_depth_message[] =
+    "Optional. Decode inputs in the background while inference runs, keeping at most this many iterations of input "
+    "tensors ready. Inference starts once the first nireq iterations are ready. Default: 0, all -niter iterations "
+    "are prepared before inference starts.";
+
+/// @brief message for input_decode_threads option
+static const char input_decode_threads_message[] =
+    "Optional. Number of threads decoding inputs when -input_queue_depth is set. "
+    "Default: 0, one per hardware thread.";
+
+/// @brief message for load_rate option
+static const char load_rate_message[] =
+    "Optional. Run open-loop: submit frames to each graph at this rate in frames per second, driven by a timer, "
+    "instead of as soon as a request becomes idle. Reports the queueing delay of each submission separately from "
+    "the device latency. A comma separated list of rates (e.g. 100,200,400) sweeps the rates in one run, measuring "
+    "-niter iterations at each of them, and reports a latency vs load curve. Requires -api async.";
+
+/// @brief message for load_arrivals option
+static const char load_arrivals_message[] =
+    "Optional. Arrival process of -load_rate, \"constant\" or \"poisson\" (exponentially distributed gaps with "
+    "the same mean rate). Default value is \"constant\".";
+
+/// @brief message for load_drop_late option
+static const char load_drop_late_message[] =
+    "Optional. With -load_rate, drop a frame that arrives while every infer request is busy instead of queueing it "
+    "until a request becomes idle. Late and dropped frames are counted either way.";
+
+/// @brief message for graph_threads option
+static const char graph_threads_message[] =
+    "Optional. With several graphs, submit to each graph from its own thread with its own iteration counter, so a "
+    "slow graph does not hold back the submissions to the others. All threads start together. Cannot be used with "
+    "-load_rate.";
+
+/// @brief message for graph_thread_cores option
+static const char graph_thread_cores_message[] =
+    "Optional. With -graph_threads, comma separated list of the CPU cores the submission threads are pinned to, one "
+    "per graph in the order of the graphs. The list is repeated if it is shorter than the number of graphs.";
+
 /// @brief message for #threads for CPU inference
 static const char infer_num_threads_message[] =
     "Optional. Number of threads to use for inference on the CPU "
@@ -104,6 +143,11 @@ static const char old_plugins_message[] =
 static const char groundtruth_loc_message[] =
     "Optional. Select a ground truth file to use for calculating top 1 top 5 results.";
 
+/// @brief message for live_accuracy flag
+static const char live_accuracy_message[] =
+    "Optional. Show the top 1 top 5 accuracy of the images scored so far next to the progress bar. Shows the last "
+    "graph when several graphs run. Requires -groundtruth_loc and -progress.";
+
 /// @brief message for architecture .arch file
 static const char arch_file_message[] = "Optional. Provide a path for the architecture .arch file.";
 
@@ -125,6 +169,12 @@ static const char bgr_message[] = "Optional. Indicate images are in bgr format."
 /// @brief message dump_output flag
 static const char dump_output_message[] = "Optional. Dumps output of graph to result.txt and result.bin file(s).";
 
+/// @brief message recycle_output_tensors flag
+static const char recycle_output_tensors_message[] =
+    "Optional. Allocate one set of output tensors per inference request instead of one per iteration. "
+    "-dump_output results are written while inference is running, so host memory use does not grow with -niter. "
+    "Cannot be used with -enable_object_detection_ap.";
+
 /// @brief message for output_dir option
 static const char output_dir_message[] = "Optional. Path to a folder where result files are dumped to.";
 
@@ -133,6 +183,17 @@ static const char dump_csr_message[] =
     "Optional. If set to true, then dumps FPGA AI Suite IP's CSR accesses in <current_working_directory>/csr_log.txt. "
     "Only available for AGX5 hostless designs. Default: true";
 
+/// @brief message for trace_file option
+static const char trace_file_message[] =
+    "Optional. Write a timeline of every inference to this file in the Chrome trace event format, viewable in "
+    "Perfetto or chrome://tracing. Each request of each graph gets a track showing the input preparation, submit, "
+    "device and callback phases of its inferences. On the FPGA the IP active time, and with -debug_network the "
+    "debug network counters, are sampled into counter tracks.";
+
+/// @brief message for trace_counter_period_ms option
+static const char trace_counter_period_message[] =
+    "Optional. Period in milliseconds of the counter samples written to -trace_file. Default: 100";
+
 /// @brief message encryption_key flag
 static const char encryption_key_message[] =
     "Optional. Encryption key (using hexidecimal characters, 16 bytes- 32 hexidecimal char).";
@@ -259,6 +320,27 @@ DEFINE_int32(niter, 0, iterations_count_message);
 /// @brief Number of infer requests in parallel
 DEFINE_int32(nireq, 0, infer_requests_count_message);
 
+/// @brief Number of iterations of input tensors the background decoder keeps ready, 0 preloads all iterations
+DEFINE_int32(input_queue_depth, 0, input_queue_depth_message);
+
+/// @brief Number of background input decode threads
+DEFINE_int32(input_decode_threads, 0, input_decode_threads_message);
+
+/// @brief Open-loop submission rate(s) in frames per second, empty runs closed-loop
+DEFINE_string(load_rate, "", load_rate_message);
+
+/// @brief Arrival process of the open-loop submissions
+DEFINE_string(load_arrivals, "constant", load_arrivals_message);
+
+/// @brief Drop open-loop arrivals that find no idle infer request
+DEFINE_bool(load_drop_late, false, load_drop_late_message);
+
+/// @brief Submit to each graph from its own thread
+DEFINE_bool(graph_threads, false, graph_threads_message);
+
+/// @brief CPU cores the per-graph submission threads are pinned to
+DEFINE_string(graph_thread_cores, "", graph_thread_cores_message);
+
 /// @brief Number of threads to use for inference on the CPU in throughput mode (also affects Hetero cases)
 DEFINE_int32(nthreads, 0, infer_num_threads_message);
 
@@ -299,6 +381,9 @@ DEFINE_string(plugins_xml_file, "", old_plugins_message);
 /// @brief Path to a groundtruth file
 DEFINE_string(groundtruth_loc, "", groundtruth_loc_message);
 
+/// @brief Show the running accuracy with the progress bar
+DEFINE_bool(live_accuracy, false, live_accuracy_message);
+
 /// @brief Path to arch file
 DEFINE_string(arch_file, "", arch_file_message);
 
@@ -314,12 +399,21 @@ DEFINE_bool(bgr, false, bgr_message);
 /// @brief Define flag for enable output results dumping
 DEFINE_bool(dump_output, false, dump_output_message);
 
+/// @brief Reuse a bounded pool of output tensors and consume the results during inference
+DEFINE_bool(recycle_output_tensors, false, recycle_output_tensors_message);
+
 /// @brief Define flag for output directory where result files are dumped to
 DEFINE_string(output_dir, "", output_dir_message);
 
 /// @brief Define flag for enabling CSR dumping for AGX5 hostless designs.
 DEFINE_bool(dump_csr, true, dump_csr_message);
 
+/// @brief Define flag for the Chrome trace of the inferences
+DEFINE_string(trace_file, "", trace_file_message);
+
+/// @brief Define flag for the sampling period of the counter tracks in the trace
+DEFINE_int32(trace_counter_period_ms, 100, trace_counter_period_message);
+
 /// Select folding options; 0,1,2,3
 DEFINE_int32(folding_option, 1, folding_option_message);
 
@@ -405,7 +499,9 @@ static void ShowCompileOptions() {
 static void ShowAccuracyOptions() {
   std::cout << std::endl << "Accuracy Options:" << std::endl;
   std::cout << "    -dump_output                                " << dump_output_message << std::endl;
+  std::cout << "    -recycle_output_tensors                     " << recycle_output_tensors_message << std::endl;
   std::cout << "    -groundtruth_loc                            " << groundtruth_loc_message << std::endl;
+  std::cout << "    -live_accuracy                              " << live_accuracy_message << std::endl;
   std::cout << "    -enable_object_detection_ap                 " << enable_object_detection_ap_message << std::endl;
   std::cout << "    -yolo_version \"yolo-v3-tf/yolo-v3-tiny-tf\"  " << yolo_version_message << std::endl;
 }
@@ -423,6 +519,8 @@ static void ShowStatsOrReportDumpingOptions() {
   std::cout << "    -save_run_summary                           " << save_run_summary_message << std::endl;
   std::cout << "    -report_folder                              " << report_folder_message << std::endl;
   std::cout << "    -dump_csr                                   " << dump_csr_message << std::endl;
+  std::cout << "    -trace_file \"<path>\"                        " << trace_file_message << std::endl;
+  std::cout << "    -trace_counter_period_ms \"<integer>\"        " << trace_counter_period_message << std::endl;
 }
 
 /**
@@ -446,6 +544,13 @@ static void ShowInferenceOptions() {
   std::cout << "    -api \"<sync/async>\"                         " << api_message << std::endl;
   std::cout << "    -niter \"<integer>\"                          " << iterations_count_message << std::endl;
   std::cout << "    -nireq \"<integer>\"                          " << infer_requests_count_message << std::endl;
+  std::cout << "    -input_queue_depth \"<integer>\"              " << input_queue_depth_message << std::endl;
+  std::cout << "    -input_decode_threads \"<integer>\"           " << input_decode_threads_message << std::endl;
+  std::cout << "    -load_rate \"<fps>[,<fps>...]\"               " << load_rate_message << std::endl;
+  std::cout << "    -load_arrivals \"<constant/poisson>\"         " << load_arrivals_message << std::endl;
+  std::cout << "    -load_drop_late                             " << load_drop_late_message << std::endl;
+  std::cout << "    -graph_threads                              " << graph_threads_message << std::endl;
+  std::cout << "    -graph_thread_cores \"<core>[,<core>...]\"    " << graph_thread_cores_message << std::endl;
   std::cout << "    -b \"<integer>\"                              " << batch_size_message << std::endl;
   std::cout << "    -batch-size \"<integer>\"                     " << batch_size_alias_message << std::endl;
 }
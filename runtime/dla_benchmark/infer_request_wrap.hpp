@@ -17,8 +17,12 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <limits>
 
 #include <openvino/openvino.hpp>
+#include "inference_trace.hpp"
+#include "latency_histogram.hpp"
 #include "statistics_report.hpp"
 #include "utils.hpp"
 
@@ -31,26 +35,45 @@ class InferReqWrap final {
 
   ~InferReqWrap() = default;
 
-  explicit InferReqWrap(ov::CompiledModel& model, size_t id, QueueCallbackFunction callbackQueue)
-      : _request(model.create_infer_request()), _id(id), _callbackQueue(callbackQueue) {
+  /// @param trace  optional timeline the phases of every inference are added to, as request id of graph graph_id
+  explicit InferReqWrap(ov::CompiledModel& model,
+                        size_t id,
+                        QueueCallbackFunction callbackQueue,
+                        InferenceTrace* trace = nullptr,
+                        size_t graph_id = 0)
+      : _request(model.create_infer_request()),
+        _id(id),
+        _callbackQueue(callbackQueue),
+        _trace(trace),
+        _graphId(graph_id) {
     _request.set_callback([&](const std::exception_ptr& ptr) {
       _endTime = Time::now();
-      _callbackQueue(_id, get_execution_time_in_milliseconds(), ptr);
+      complete(ptr);
     });
   }
 
+  /// Marks the start of the input and output setup of the given iteration, only used for the trace
+  void prepare(size_t iteration) {
+    _prepareTime = Time::now();
+    _iteration = iteration;
+  }
+
   void start_async() {
     _startTime = Time::now();
+    _submittedTicks.store(kNotSubmitted, std::memory_order_relaxed);
     _request.start_async();
+    // The completion callback may already be running, it reads this through the atomic
+    _submittedTicks.store(Time::now().time_since_epoch().count(), std::memory_order_release);
   }
 
   void wait() { _request.wait(); }
 
   void infer() {
     _startTime = Time::now();
+    _submittedTicks.store(_startTime.time_since_epoch().count(), std::memory_order_relaxed);
     _request.infer();
     _endTime = Time::now();
-    _callbackQueue(_id, get_execution_time_in_milliseconds(), nullptr);
+    complete(nullptr);
   }
 
   std::vector<ov::ProfilingInfo> get_performance_counts() { return _request.get_profiling_info(); }
@@ -68,18 +91,51 @@ class InferReqWrap final {
 
   ov::Tensor get_output_tensor() { return _request.get_output_tensor(); }
 
+  size_t get_id() const { return _id; }
+
  private:
+  void complete(const std::exception_ptr& ptr) {
+    if (!_trace) {
+      _callbackQueue(_id, get_execution_time_in_milliseconds(), ptr);
+      return;
+    }
+    // A fast request can complete before start_async has returned, the submission then ends with
+    // the request rather than after it
+    const Time::rep submittedTicks = _submittedTicks.load(std::memory_order_acquire);
+    const Time::time_point submittedTime = (submittedTicks == kNotSubmitted)
+                                               ? _endTime
+                                               : std::min(_endTime, Time::time_point(Time::duration(submittedTicks)));
+
+    // The request can be reused as soon as the queue has it back, so take the timestamps before that
+    InferenceTrace::Inference inference{_prepareTime, _startTime, submittedTime, _endTime, {}};
+    const size_t iteration = _iteration;
+    _callbackQueue(_id, get_execution_time_in_milliseconds(), ptr);
+    if (!ptr) {
+      inference.released = Time::now();
+      _trace->add_inference(_graphId, _id, iteration, inference);
+    }
+  }
+
+  static constexpr Time::rep kNotSubmitted = std::numeric_limits<Time::rep>::min();
+
   ov::InferRequest _request;
+  Time::time_point _prepareTime;
   Time::time_point _startTime;
+  std::atomic<Time::rep> _submittedTicks{kNotSubmitted};  // when start_async returned
   Time::time_point _endTime;
   size_t _id;
+  size_t _iteration = 0;
   QueueCallbackFunction _callbackQueue;
+  InferenceTrace* _trace;
+  size_t _graphId;
 };
 
 // Handles a queue of inference requests.
 class InferRequestsQueue final {
  public:
-  InferRequestsQueue(ov::CompiledModel& model, size_t nireq) {
+  /// @param trace     optional timeline the inferences of the queue are added to
+  /// @param graph_id  process id of the queue in the trace
+  InferRequestsQueue(ov::CompiledModel& model, size_t nireq, InferenceTrace* trace = nullptr, size_t graph_id = 0) {
     for (size_t id = 0; id < nireq; id++) {
       requests.push_back(std::make_shared<InferReqWrap>(model,
                                                         id,
@@ -87,8 +143,13 @@ class InferRequestsQueue final {
                                                                   this,
                                                                   std::placeholders::_1,
                                                                   std::placeholders::_2,
-                                                                  std::placeholders::_3)));
+                                                                  std::placeholders::_3),
+                                                        trace,
+                                                        graph_id));
       _idleIds.push(id);
+      if (trace) {
+        trace->set_thread_name(graph_id, id, "infer request " + std::to_string(id));
+      }
     }
     reset_times();
   }
@@ -106,7 +167,7 @@ class InferRequestsQueue final {
   void reset_times() {
     _startTime = Time::time_point::max();
     _endTime = Time::time_point::min();
-    _latencies.clear();
+    _latencies.reset();
   }
 
   double get_durations_in_milliseconds() {
@@ -114,11 +175,12 @@ class InferRequestsQueue final {
   }
 
   void put_idle_request(size_t id, const double latency, const std::exception_ptr& ptr = nullptr) {
+    // The histogram is lock free, keep it out of the critical section
+    if (!ptr) _latencies.record(latency);
     std::unique_lock<std::mutex> lock(_mutex);
     if (ptr) {
       inferenceException = ptr;
     } else {
-      _latencies.push_back(latency);
       _idleIds.push(id);
       _endTime = std::max(Time::now(), _endTime);
     }
@@ -139,6 +201,21 @@ class InferRequestsQueue final {
     return request;
   }
 
+  // Same as get_idle_request, but returns nullptr instead of blocking when every request is busy
+  InferReqWrap::Ptr try_get_idle_request() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (inferenceException) {
+      std::rethrow_exception(inferenceException);
+    }
+    if (_idleIds.empty()) {
+      return nullptr;
+    }
+    auto request = requests.at(_idleIds.front());
+    _idleIds.pop();
+    _startTime = std::min(Time::now(), _startTime);
+    return request;
+  }
+
   void wait_all() {
     std::unique_lock<std::mutex> lock(_mutex);
     _cv.wait(lock, [this] {
@@ -149,7 +226,7 @@ class InferRequestsQueue final {
     });
   }
 
-  std::vector<double>& get_latencies() { return _latencies; }
+  const LatencyHistogram& get_latencies() const { return _latencies; }
 
   Time::time_point get_start_time() { return _startTime; }
 
@@ -163,6 +240,6 @@ class InferRequestsQueue final {
   std::condition_variable _cv;
   Time::time_point _startTime;
   Time::time_point _endTime;
-  std::vector<double> _latencies;
+  LatencyHistogram _latencies;
   std::exception_ptr inferenceException = nullptr;
 };
@@ -0,0 +1,165 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Collects a timeline of the inferences of dla_benchmark and writes it as Chrome trace event JSON,
+//              which Perfetto and chrome://tracing can open.
+
+#include "inference_trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <samples/slog.hpp>
+
+namespace {
+
+// Quotes and escapes a string for JSON
+std::string JsonString(const std::string& value) {
+  std::string quoted = "\"";
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+}  // namespace
+
+InferenceTrace::InferenceTrace(Clock::time_point origin) : _origin(origin) {}
+
+InferenceTrace::~InferenceTrace() { stop_sampling(); }
+
+double InferenceTrace::to_us(Clock::time_point time) const {
+  return std::chrono::duration<double, std::micro>(time - _origin).count();
+}
+
+void InferenceTrace::set_process_name(uint32_t pid, const std::string& name) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _process_names[pid] = name;
+}
+
+void InferenceTrace::set_thread_name(uint32_t pid, uint32_t tid, const std::string& name) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _thread_names[std::make_pair(pid, tid)] = name;
+}
+
+void InferenceTrace::add_inference(uint32_t graph, uint32_t request, uint64_t iteration, const Inference& inference) {
+  // A request that was never prepared (e.g. a warm-up run) starts at its submission
+  const Clock::time_point begin =
+      inference.prepare == Clock::time_point() ? inference.submit : std::min(inference.prepare, inference.submit);
+  const double begin_us = to_us(begin);
+  const double submit_us = to_us(inference.submit);
+  const double submitted_us = to_us(inference.submitted);
+  const double completed_us = to_us(inference.completed);
+  const double released_us = to_us(inference.released);
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  _slices.push_back({"iteration", graph, request, iteration, begin_us, released_us - begin_us});
+  _slices.push_back({"prepare", graph, request, iteration, begin_us, submit_us - begin_us});
+  _slices.push_back({"submit", graph, request, iteration, submit_us, submitted_us - submit_us});
+  _slices.push_back({"device", graph, request, iteration, submitted_us, completed_us - submitted_us});
+  _slices.push_back({"callback", graph, request, iteration, completed_us, released_us - completed_us});
+}
+
+void InferenceTrace::add_counter(uint32_t pid,
+                                 const std::string& name,
+                                 Clock::time_point time,
+                                 const std::map<std::string, double>& values) {
+  const double time_us = to_us(time);
+  std::lock_guard<std::mutex> lock(_mutex);
+  _counters.push_back({pid, name, time_us, values});
+}
+
+void InferenceTrace::start_sampling(std::function<void()> sample, std::chrono::milliseconds period) {
+  stop_sampling();
+  _stop_sampling = false;
+  _sampler = std::thread(&InferenceTrace::sampling_thread, this, std::move(sample), period);
+}
+
+void InferenceTrace::stop_sampling() {
+  {
+    std::lock_guard<std::mutex> lock(_sampling_mutex);
+    _stop_sampling = true;
+  }
+  _sampling_cv.notify_all();
+  if (_sampler.joinable()) {
+    _sampler.join();
+  }
+}
+
+void InferenceTrace::sampling_thread(std::function<void()> sample, std::chrono::milliseconds period) {
+  auto next_sample = Clock::now();
+  std::unique_lock<std::mutex> lock(_sampling_mutex);
+  while (!_stop_sampling) {
+    lock.unlock();
+    try {
+      sample();
+    } catch (const std::exception& ex) {
+      slog::warn << "Stopped sampling the trace counters: " << ex.what() << slog::endl;
+      return;
+    }
+    lock.lock();
+    next_sample += period;
+    _sampling_cv.wait_until(lock, next_sample, [this] { return _stop_sampling; });
+  }
+}
+
+void InferenceTrace::write(const std::string& path) {
+  std::ofstream file(path);
+  if (!file) {
+    throw std::runtime_error("Cannot open trace file " + path);
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  auto begin_event = [&]() -> std::ofstream& {
+    file << (first ? "" : ",\n");
+    first = false;
+    return file;
+  };
+
+  for (const auto& process : _process_names) {
+    begin_event() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << process.first
+                  << ",\"args\":{\"name\":" << JsonString(process.second) << "}}";
+  }
+  for (const auto& thread : _thread_names) {
+    begin_event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << thread.first.first
+                  << ",\"tid\":" << thread.first.second << ",\"args\":{\"name\":" << JsonString(thread.second)
+                  << "}}";
+  }
+
+  // Timestamps are in microseconds, keep nanosecond resolution
+  file.setf(std::ios::fixed);
+  file.precision(3);
+  for (const auto& slice : _slices) {
+    begin_event() << "{\"name\":\"" << slice.name << "\",\"ph\":\"X\",\"pid\":" << slice.pid
+                  << ",\"tid\":" << slice.tid << ",\"ts\":" << slice.begin_us << ",\"dur\":" << slice.duration_us
+                  << ",\"args\":{\"iteration\":" << slice.iteration << "}}";
+  }
+  for (const auto& counter : _counters) {
+    begin_event() << "{\"name\":" << JsonString(counter.name) << ",\"ph\":\"C\",\"pid\":" << counter.pid
+                  << ",\"ts\":" << counter.time_us << ",\"args\":{";
+    const char* separator = "";
+    for (const auto& value : counter.values) {
+      file << separator << JsonString(value.first) << ":" << value.second;
+      separator = ",";
+    }
+    file << "}}";
+  }
+  file << "\n]}\n";
+
+  if (!file) {
+    throw std::runtime_error("Failed to write trace file " + path);
+  }
+}
@@ -0,0 +1,101 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Collects a timeline of the inferences of dla_benchmark and writes it as Chrome trace event JSON,
+//              which Perfetto and chrome://tracing can open.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief Timeline of the inferences of a run.
+///
+/// Every graph is a process of the trace and every infer request of the graph is a thread, so each request slot gets
+/// its own track and gaps between its inferences show up as bubbles. Counters are drawn as separate counter tracks.
+/// All methods are thread safe, inferences are added from the inference callbacks.
+class InferenceTrace {
+ public:
+  typedef std::chrono::high_resolution_clock Clock;
+
+  /// Timestamps of one inference, in the order they happen
+  struct Inference {
+    Clock::time_point prepare;    // the request was taken to set up the inputs and outputs
+    Clock::time_point submit;     // start_async() or infer() was called
+    Clock::time_point submitted;  // start_async() returned
+    Clock::time_point completed;  // the device finished, the callback was entered
+    Clock::time_point released;   // the callback returned the request to its queue
+  };
+
+  /// @param origin  time of the trace timestamp 0
+  explicit InferenceTrace(Clock::time_point origin = Clock::now());
+
+  ~InferenceTrace();
+
+  InferenceTrace(const InferenceTrace &) = delete;
+  InferenceTrace &operator=(const InferenceTrace &) = delete;
+
+  /// Names the track group of a graph, or of any other process id
+  void set_process_name(uint32_t pid, const std::string &name);
+
+  /// Names the track of one request of a graph
+  void set_thread_name(uint32_t pid, uint32_t tid, const std::string &name);
+
+  /// Adds an "iteration" slice with one nested slice per phase of the inference
+  void add_inference(uint32_t graph, uint32_t request, uint64_t iteration, const Inference &inference);
+
+  /// Adds a sample of a counter track. Each entry of values is drawn as one series of the track.
+  void add_counter(uint32_t pid, const std::string &name, Clock::time_point time,
+                   const std::map<std::string, double> &values);
+
+  /// Calls sample every period on a background thread until stop_sampling() is called. The first sample is taken
+  /// right away. An exception thrown by sample ends the sampling with a warning.
+  void start_sampling(std::function<void()> sample, std::chrono::milliseconds period);
+
+  /// Stops the sampling thread, if any, after its current sample
+  void stop_sampling();
+
+  /// Writes the trace collected so far as JSON. Throws std::runtime_error if the file cannot be written.
+  void write(const std::string &path);
+
+ private:
+  struct Slice {
+    const char *name;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t iteration;
+    double begin_us;
+    double duration_us;
+  };
+
+  struct Counter {
+    uint32_t pid;
+    std::string name;
+    double time_us;
+    std::map<std::string, double> values;
+  };
+
+  double to_us(Clock::time_point time) const;
+  void sampling_thread(std::function<void()> sample, std::chrono::milliseconds period);
+
+  const Clock::time_point _origin;
+
+  std::mutex _mutex;
+  std::map<uint32_t, std::string> _process_names;
+  std::map<std::pair<uint32_t, uint32_t>, std::string> _thread_names;
+  std::vector<Slice> _slices;
+  std::vector<Counter> _counters;
+
+  std::mutex _sampling_mutex;
+  std::condition_variable _sampling_cv;
+  bool _stop_sampling = false;
+  std::thread _sampler;
+};
@@ -0,0 +1,124 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Background decoding of dla_benchmark input tensors.
+
+#include "input_tensor_producer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+// Set on the decode threads, 0 everywhere else
+static thread_local size_t t_threads_per_iteration = 0;
+
+InputTensorProducer::InputTensorProducer(InputTensorFactory create_tensors,
+                                         size_t num_iterations,
+                                         size_t queue_depth,
+                                         size_t num_threads)
+    : _create_tensors(std::move(create_tensors)),
+      _num_iterations(num_iterations),
+      _queue_depth(std::max<size_t>(queue_depth, 1)) {
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  // More threads than queue slots would only ever wait for space
+  num_threads = std::min(num_threads, _queue_depth);
+  _threads_per_iteration = std::max<size_t>(std::thread::hardware_concurrency() / num_threads, 1);
+  for (size_t i = 0; i < num_threads; i++) {
+    _threads.emplace_back(&InputTensorProducer::decode_thread, this);
+  }
+}
+
+InputTensorProducer::~InputTensorProducer() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _space_cv.notify_all();
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+size_t InputTensorProducer::threads_per_iteration() {
+  if (t_threads_per_iteration > 0) {
+    return t_threads_per_iteration;
+  }
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void InputTensorProducer::decode_thread() {
+  t_threads_per_iteration = _threads_per_iteration;
+  while (true) {
+    size_t iteration;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _space_cv.wait(lock, [this] {
+        return _stop || _exception || _next_decode >= _num_iterations || _next_decode < _next_take + _queue_depth;
+      });
+      if (_stop || _exception || _next_decode >= _num_iterations) {
+        return;
+      }
+      iteration = _next_decode++;
+    }
+
+    std::map<std::string, ov::Tensor> tensors;
+    try {
+      tensors = _create_tensors(iteration);
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_exception) {
+          _exception = std::current_exception();
+        }
+      }
+      _ready_cv.notify_all();
+      _space_cv.notify_all();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _ready.emplace(iteration, std::move(tensors));
+    }
+    _ready_cv.notify_all();
+  }
+}
+
+std::map<std::string, ov::Tensor> InputTensorProducer::take(size_t iteration) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (iteration != _next_take || iteration >= _num_iterations) {
+    throw std::logic_error("Input tensors must be taken in iteration order");
+  }
+  _ready_cv.wait(lock, [&] { return _exception || _ready.count(iteration) != 0; });
+  auto it = _ready.find(iteration);
+  if (it == _ready.end()) {
+    std::rethrow_exception(_exception);
+  }
+  std::map<std::string, ov::Tensor> tensors = std::move(it->second);
+  _ready.erase(it);
+  _next_take++;
+  lock.unlock();
+  _space_cv.notify_all();
+  return tensors;
+}
+
+void InputTensorProducer::wait_ready(size_t count) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  const size_t last = std::min(_next_take + count, _num_iterations);
+  _ready_cv.wait(lock, [&] {
+    if (_exception) {
+      return true;
+    }
+    for (size_t iteration = _next_take; iteration < last; iteration++) {
+      if (_ready.count(iteration) == 0) {
+        return false;
+      }
+    }
+    return true;
+  });
+  if (_exception) {
+    std::rethrow_exception(_exception);
+  }
+}
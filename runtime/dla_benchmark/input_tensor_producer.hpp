@@ -0,0 +1,65 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Decodes the input tensors of upcoming iterations on a pool of background threads, so inference can
+//              start before every input is prepared and memory does not grow with the number of iterations.
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+#include "inputs_filling.hpp"
+
+/// @brief Bounded queue of ready input tensors, filled in iteration order by a pool of decode threads
+class InputTensorProducer final {
+ public:
+  /// @param create_tensors  creates the input tensors of one iteration, called from the decode threads
+  /// @param num_iterations  total number of iterations to produce
+  /// @param queue_depth     maximum number of iterations decoded or being decoded ahead of the consumer
+  /// @param num_threads     number of decode threads, 0 uses one per hardware thread
+  InputTensorProducer(InputTensorFactory create_tensors, size_t num_iterations, size_t queue_depth, size_t num_threads);
+
+  /// Stops decoding and joins the decode threads
+  ~InputTensorProducer();
+
+  /// Blocks until the input tensors of the iteration are ready and removes them from the queue. Iterations must be
+  /// taken in order. Rethrows the exception of a decode thread that failed.
+  std::map<std::string, ov::Tensor> take(size_t iteration);
+
+  /// Blocks until the next count iterations are ready, or every remaining iteration if there are fewer
+  void wait_ready(size_t count);
+
+  /// Number of threads the tensor factory may use for one iteration. On a decode thread this is its share of the
+  /// hardware threads, so the decode threads and the threads they start never outnumber the cores. Anywhere else it
+  /// is the number of hardware threads.
+  static size_t threads_per_iteration();
+
+ private:
+  void decode_thread();
+
+  InputTensorProducer(const InputTensorProducer&) = delete;
+  InputTensorProducer& operator=(const InputTensorProducer&) = delete;
+
+  InputTensorFactory _create_tensors;
+  size_t _num_iterations;
+  size_t _queue_depth;
+  size_t _threads_per_iteration = 1;  // hardware threads divided between the decode threads
+
+  std::mutex _mutex;
+  std::condition_variable _space_cv;  // signalled when the consumer takes an iteration
+  std::condition_variable _ready_cv;  // signalled when a decode thread finishes an iteration
+  size_t _next_decode = 0;            // next iteration a decode thread picks up
+  size_t _next_take = 0;              // next iteration the consumer takes
+  std::map<size_t, std::map<std::string, ov::Tensor>> _ready;
+  std::exception_ptr _exception = nullptr;
+  bool _stop = false;
+
+  std::vector<std::thread> _threads;
+};
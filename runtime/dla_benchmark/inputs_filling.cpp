@@ -9,20 +9,25 @@
 #include "inputs_filling.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <functional>
 #include <limits>
 #include <tuple>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <opencv2/videoio.hpp>
 #include <opencv2/opencv.hpp>
+#include <samples/pooled_tensor_allocator.hpp>
 #include <samples/slog.hpp>
 #include "format_reader_ptr.h"
-#include "shared_tensor_allocator.hpp"
+#include "input_tensor_producer.hpp"
+#include "planar_conversion.hpp"
 #include "utils.hpp"
 
 /**
@@ -55,6 +60,9 @@ static bool IsGrayScaleImage(const ReaderInfo& reader_info, uint32_t image_size)
   return true;
 }
 
+// Number of pixels CreateTensorFromImage hands to one conversion thread at a time, rounded to whole rows
+static constexpr size_t kConversionChunkPixels = 64 * 1024;
+
 template <typename T>
 using uniformDistribution = typename std::conditional<
     std::is_floating_point<T>::value,
@@ -92,7 +100,7 @@ ov::Tensor CreateTensorFromImage(const std::vector<std::string>& files,
                                  const bool verbose = false) {
   size_t tensor_size =
       std::accumulate(input_info.data_shape.begin(), input_info.data_shape.end(), 1, std::multiplies<size_t>());
-  auto allocator = SharedTensorAllocator(tensor_size * sizeof(T));
+  auto allocator = PooledTensorAllocator(tensor_size * sizeof(T));
   auto data = reinterpret_cast<T*>(allocator.get_buffer());
   /** Collect images data ptrs **/
   std::vector<ReaderInfo> vreader;
@@ -140,41 +148,48 @@ ov::Tensor CreateTensorFromImage(const std::vector<std::string>& files,
 
   const size_t image_size = width * height;  // Calculate the image size
 
-  // Lambda expression for calculating the pixel index in inputBlobData
-  const auto get_index = [=](size_t image_id, size_t pid, size_t ch) {
-    // Reverse the channel index if bgr is set to true
-    return image_id * image_size * num_channels + (bgr ? ch : (num_channels - ch - 1)) * image_size + pid;
-  };
+  // Mean, reciprocal scale and the source channel of every plane (reversed unless bgr is set) are computed once
+  const PlanarConversion conversion(num_channels, input_info.mean_values, input_info.scale_values, bgr);
 
-  // Lambda expression for calculating the channel (if bgr)
-  const auto get_channel = [=](size_t ch) {
-    return bgr ? ch : (num_channels - ch - 1);
-  };
-
-  /** Iterate over all input images **/
-  for (size_t image_id = 0; image_id < vreader.size(); ++image_id) {
-    const auto& reader_info = vreader.at(image_id);
+  for (const auto& reader_info : vreader) {
     // Error out of the graph has a single channel input and the image is not grayscale
     if (num_channels == 1 && !IsGrayScaleImage(reader_info, image_size)) {
       OPENVINO_THROW(
           "Graph input is grayscale (has a single channel) and the following image is in RGB format:\n\t",
           files.at(reader_info.file_index));
     }
-    const auto reader_channels = reader_info.channels;
-    /** Iterate over all pixel in image (b,g,r) **/
-    for (size_t pid = 0; pid < image_size; pid++) {
-      /** Iterate over all channels **/
-      for (size_t ch = 0; ch < num_channels; ++ch) {
-        // check if scale values are 0
-        if (input_info.scale_values[get_channel(ch)] == 0) {
-          OPENVINO_THROW("Cannot apply scale value of 0");
-        }
-        // Reader is created with the assumption that the number of channels is always the maximum
-        data[get_index(image_id, pid, ch)] = static_cast<T>(
-            (reader_info.data.get()[pid * reader_channels + ch] - input_info.mean_values[get_channel(ch)]) /
-            input_info.scale_values[get_channel(ch)]);
-      }
+  }
+
+  // Split every image into chunks of rows so a single large image is also converted by several threads
+  const size_t chunk_size = std::max<size_t>(kConversionChunkPixels / std::max<size_t>(width, 1), 1) * width;
+  const size_t chunks_per_image = image_size == 0 ? 0 : (image_size + chunk_size - 1) / chunk_size;
+  const size_t num_chunks = vreader.size() * chunks_per_image;
+  std::atomic<size_t> next_chunk{0};
+  const auto convert_chunks = [&]() {
+    for (size_t chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) {
+      const size_t image_id = chunk / chunks_per_image;
+      const size_t begin = (chunk % chunks_per_image) * chunk_size;
+      const auto& reader_info = vreader[image_id];
+      // Reader is created with the assumption that the number of channels is always the maximum
+      ConvertImageToPlanar(conversion,
+                           reader_info.data.get(),
+                           reader_info.channels,
+                           image_size,
+                           begin,
+                           std::min(begin + chunk_size, image_size),
+                           data + image_id * image_size * num_channels);
     }
+  };
+  // When called from the InputTensorProducer decode threads, which already run one per core, this stays on the
+  // caller's share of the cores instead of starting a thread per core from every decode thread
+  const size_t num_threads = std::min(InputTensorProducer::threads_per_iteration(), num_chunks);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(convert_chunks);
+  }
+  convert_chunks();
+  for (auto& thread : threads) {
+    thread.join();
   }
 
   auto tensor = ov::Tensor(input_info.type, {batch, num_channels, height, width}, allocator);
@@ -211,7 +226,7 @@ ov::Tensor CreateTensorFromVideo(const std::vector<std::string>& file_paths,
                                  const bool verbose = false) {
   size_t tensor_size =
       std::accumulate(input_info.data_shape.begin(), input_info.data_shape.end(), 1, std::multiplies<size_t>());
-  auto allocator = SharedTensorAllocator(tensor_size * sizeof(T));
+  auto allocator = PooledTensorAllocator(tensor_size * sizeof(T));
   auto data = reinterpret_cast<T*>(allocator.get_buffer());
 
   const size_t input_idx = (request_id * input_size + input_id) % file_paths.size();
@@ -401,7 +416,7 @@ ov::Tensor CreateTensorImInfo(const std::pair<size_t, size_t>& image_size,
                               const std::string& input_name) {
   size_t tensor_size =
       std::accumulate(input_info.data_shape.begin(), input_info.data_shape.end(), 1, std::multiplies<size_t>());
-  auto allocator = SharedTensorAllocator(tensor_size * sizeof(T));
+  auto allocator = PooledTensorAllocator(tensor_size * sizeof(T));
   auto data = reinterpret_cast<T*>(allocator.get_buffer());
 
   size_t info_batch_size = 1;
@@ -457,7 +472,7 @@ ov::Tensor CreateTensorFromBinary(const std::vector<std::string>& files,
                                   const bool verbose = false) {
   size_t tensor_size =
       std::accumulate(input_info.data_shape.begin(), input_info.data_shape.end(), 1, std::multiplies<size_t>());
-  auto allocator = SharedTensorAllocator(tensor_size * sizeof(T));
+  auto allocator = PooledTensorAllocator(tensor_size * sizeof(T));
   char* data = allocator.get_buffer();
   size_t binary_batch_size = 1;
   if (!input_info.layout.empty() && ov::layout::has_batch(input_info.layout)) {
@@ -521,7 +536,7 @@ ov::Tensor CreateTensorRandom(const dla_benchmark::InputInfo& input_info,
                               T rand_max = std::numeric_limits<uint8_t>::max()) {
   size_t tensor_size =
       std::accumulate(input_info.data_shape.begin(), input_info.data_shape.end(), 1, std::multiplies<size_t>());
-  auto allocator = SharedTensorAllocator(tensor_size * sizeof(T));
+  auto allocator = PooledTensorAllocator(tensor_size * sizeof(T));
   auto data = reinterpret_cast<T*>(allocator.get_buffer());
 
   std::mt19937 gen(0);
@@ -641,11 +656,9 @@ ov::Tensor GetRandomTensor(const std::pair<std::string, dla_benchmark::InputInfo
 ov::Tensor GetStreamingTensor(const std::pair<std::string, dla_benchmark::InputInfo>& input_info) {
   const dla_benchmark::InputInfo& info = input_info.second;
   size_t tensor_size = std::accumulate(info.data_shape.begin(), info.data_shape.end(), 1, std::multiplies<size_t>());
-  auto allocator = SharedTensorAllocator(tensor_size * sizeof(info.type));
-  auto data = allocator.get_buffer();
-  for (size_t i = 0; i < tensor_size; i++) {
-    data[i] = 0;
-  }
+  auto allocator = PooledTensorAllocator(tensor_size * info.type.size());
+  // Pooled buffers are recycled, so clear what the previous tensor left behind
+  memset(allocator.get_buffer(), 0, tensor_size * info.type.size());
   auto tensor = ov::Tensor(info.type, info.data_shape, allocator);
   return tensor;
 }
@@ -705,7 +718,7 @@ ov::Tensor GetBinaryTensor(const std::vector<std::string>& files,
 }
 
 /**
- * @brief Main function used by DLA benchmark, creates input tensors based off of input files and precision
+ * @brief Sorts the input files by type and returns a function creating the input tensors of one iteration
  *
  * Only creates static tensors (no dims of -1). Calls all other functions in this file.
  *
@@ -713,24 +726,23 @@ ov::Tensor GetBinaryTensor(const std::vector<std::string>& files,
  * @param batch_size batch size of input
  * @param inputs_info map of input name to InputInfo struct which contains useful input information
  *                    such as precision, tensor layout
- * @param requests_num number of infer requests
+ * @param requests_num number of iterations the input tensors will be created for, only used for warnings
  * @param bgr boolean indicating if channels are reversed, corresponds to user bgr flag
  * @param is_binary_data boolean indicating if the image data should be binary, corresponding to user binary flag
  * @param streaming_data boolean indication if dla benchmark is expecting data to be streamed in
  * @param verbose Verbosity boolean. If true, additional logs are printed
- * @return A map of input name with tensor vectors. TensorVector being an alias of ov::Tensors where
- *         each index corresponds to the batch
+ * @return A function that takes the iteration index and returns a map of input name to the input tensor.
+ *         It only reads the input files, so it may be called from several threads at once.
 */
-std::map<std::string, ov::TensorVector> GetStaticTensors(const std::vector<std::string>& input_files,
-                                                         const size_t& batch_size,
-                                                         dla_benchmark::InputsInfo& inputs_info,
-                                                         size_t requests_num,
-                                                         std::string resize_type,
-                                                         bool bgr = false,
-                                                         bool is_binary_data = false,
-                                                         bool streaming_data = false,
-                                                         bool verbose = false) {
-  std::map<std::string, ov::TensorVector> blobs;
+InputTensorFactory GetInputTensorFactory(const std::vector<std::string>& input_files,
+                                         const size_t& batch_size,
+                                         const dla_benchmark::InputsInfo& inputs_info,
+                                         size_t requests_num,
+                                         std::string resize_type,
+                                         bool bgr,
+                                         bool is_binary_data,
+                                         bool streaming_data,
+                                         bool verbose) {
   std::vector<std::pair<size_t, size_t>> net_input_im_sizes;
   std::vector<std::tuple<size_t, size_t, size_t>> net_input_vid_sizes;
   FormatReader::Reader::ResizeType resize_type_enum;
@@ -845,7 +857,8 @@ std::map<std::string, ov::TensorVector> GetStaticTensors(const std::vector<std::
     }
   }
 
-  for (size_t i = 0; i < requests_num; ++i) {
+  return [=](size_t i) {
+    std::map<std::string, ov::Tensor> blobs;
     size_t img_input_id = 0;
     size_t bin_input_id = 0;
     size_t vid_input_id = 0;
@@ -856,40 +869,68 @@ std::map<std::string, ov::TensorVector> GetStaticTensors(const std::vector<std::
       if (item.second.IsImage() && !is_binary_data) {
         if (!image_files.empty()) {
           // Fill with images
-          blobs[input_name].push_back(GetImageTensor(
-              image_files, img_input_id++, batch_size, img_input_count, i, {input_name, input_info}, resize_type_enum, bgr, verbose));
+          blobs[input_name] = GetImageTensor(
+              image_files, img_input_id++, batch_size, img_input_count, i, {input_name, input_info}, resize_type_enum, bgr, verbose);
           continue;
         }
       } else if (input_info.IsVideo()) {
         if (!video_files.empty()) {
           // Fill with videos
-          blobs[input_name].push_back(GetVideoTensor(
-              video_files, vid_input_id++, batch_size, vid_input_count, i, {input_name, input_info}, bgr, verbose));
+          blobs[input_name] = GetVideoTensor(
+              video_files, vid_input_id++, batch_size, vid_input_count, i, {input_name, input_info}, bgr, verbose);
           continue;
         }
       } else {
         if (!binary_files.empty()) {
           // Fill with binary files
-          blobs[input_name].push_back(
-              GetBinaryTensor(binary_files, bin_input_id++, batch_size, bin_input_count, i, {input_name, input_info}, verbose));
+          blobs[input_name] =
+              GetBinaryTensor(binary_files, bin_input_id++, batch_size, bin_input_count, i, {input_name, input_info}, verbose);
           continue;
         }
         if (input_info.IsImageInfo() && (net_input_im_sizes.size() == 1)) {
           // Most likely it is image info: fill with image information
           auto image_size = net_input_im_sizes.at(0);
-          blobs[input_name].push_back(GetImInfoTensor(image_size, batch_size, {input_name, input_info}));
+          blobs[input_name] = GetImInfoTensor(image_size, batch_size, {input_name, input_info});
           continue;
         }
       }
 
       if (streaming_data) {
-        blobs[input_name].push_back(GetStreamingTensor({input_name, input_info}));
+        blobs[input_name] = GetStreamingTensor({input_name, input_info});
       } else {
         // Fill random
         slog::info << "No suitable input data found, filling input tensors with random data.\n";
-        blobs[input_name].push_back(GetRandomTensor({input_name, input_info}));
+        blobs[input_name] = GetRandomTensor({input_name, input_info});
       }
     }
+    return blobs;
+  };
+}
+
+/**
+ * @brief Main function used by DLA benchmark, creates the input tensors of every iteration up front
+ *
+ * See GetInputTensorFactory for params.
+ *
+ * @return A map of input name with tensor vectors. TensorVector being an alias of ov::Tensors where
+ *         each index corresponds to the batch
+*/
+std::map<std::string, ov::TensorVector> GetStaticTensors(const std::vector<std::string>& input_files,
+                                                         const size_t& batch_size,
+                                                         dla_benchmark::InputsInfo& inputs_info,
+                                                         size_t requests_num,
+                                                         std::string resize_type,
+                                                         bool bgr,
+                                                         bool is_binary_data,
+                                                         bool streaming_data,
+                                                         bool verbose) {
+  const InputTensorFactory create_tensors = GetInputTensorFactory(
+      input_files, batch_size, inputs_info, requests_num, resize_type, bgr, is_binary_data, streaming_data, verbose);
+  std::map<std::string, ov::TensorVector> blobs;
+  for (size_t i = 0; i < requests_num; ++i) {
+    for (auto& item : create_tensors(i)) {
+      blobs[item.first].push_back(item.second);
+    }
   }
   return blobs;
 }
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -12,10 +13,29 @@
 #include <openvino/openvino.hpp>
 #include "infer_request_wrap.hpp"
 
+/// @brief Creates the input tensors of one iteration, keyed by input name
+typedef std::function<std::map<std::string, ov::Tensor>(size_t iteration)> InputTensorFactory;
+
+/**
+ * @brief Sorts the input files by type and returns a function creating the input tensors of one iteration
+ *
+ * Takes the same parameters as GetStaticTensors. The returned function only reads the input files and can be
+ * called from several threads at once, see InputTensorProducer.
+ */
+InputTensorFactory GetInputTensorFactory(const std::vector<std::string>& input_files,
+                                         const size_t& batch_size,
+                                         const dla_benchmark::InputsInfo& inputs_info,
+                                         size_t requests_num,
+                                         std::string resize_type,
+                                         bool bgr,
+                                         bool is_binary_data,
+                                         bool streaming_data,
+                                         bool verbose);
+
 /**
  * @brief Main function used by DLA benchmark, creates input tensors based off of input files and precision
  *
- * Only creates static tensors (no dims of -1). Calls all other functions in this file.
+ * Only creates static tensors (no dims of -1). The tensors of all requests_num iterations are created up front.
  *
  * @param input_files vector of input file paths
  * @param batch_size batch size of input
@@ -0,0 +1,133 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Fixed memory, HDR style latency histogram used to report the latency distribution of a run.
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double kNanosecondsPerMillisecond = 1000000.0;
+
+// Index of the most significant set bit of a non-zero value
+inline unsigned HighestBit(uint64_t value) {
+  unsigned bit = 0;
+  while (value >>= 1) bit++;
+  return bit;
+}
+
+// Lowers target to value if value is smaller, without a lock
+inline void AtomicMin(std::atomic<uint64_t>& target, uint64_t value) {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+inline void AtomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+// Values below kSubBuckets get one bucket each. Above that, the range [2^b, 2^(b+1)) is covered by kSubBuckets / 2
+// buckets of width 2^(b - kSubBucketBits + 1), so the last index is the one of kMaxNanoseconds.
+LatencyHistogram::LatencyHistogram() : _buckets(bucket_index(kMaxNanoseconds) + 1) { reset(); }
+
+void LatencyHistogram::reset() {
+  for (auto& bucket : _buckets) bucket.store(0, std::memory_order_relaxed);
+  _count.store(0, std::memory_order_relaxed);
+  _sum_ns.store(0, std::memory_order_relaxed);
+  _min_ns.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  _max_ns.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t value_ns) {
+  if (value_ns < kSubBuckets) return static_cast<size_t>(value_ns);
+  const unsigned shift = HighestBit(value_ns) - (kSubBucketBits - 1);
+  return static_cast<size_t>(shift * (kSubBuckets / 2) + (value_ns >> shift));
+}
+
+uint64_t LatencyHistogram::bucket_highest_value(size_t index) {
+  if (index < kSubBuckets) return index;
+  const unsigned shift = static_cast<unsigned>(index / (kSubBuckets / 2) - 1);
+  const uint64_t sub_bucket = index - shift * (kSubBuckets / 2);
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::bucket_midpoint(size_t index) {
+  if (index < kSubBuckets) return index;
+  const unsigned shift = static_cast<unsigned>(index / (kSubBuckets / 2) - 1);
+  const uint64_t sub_bucket = index - shift * (kSubBuckets / 2);
+  return (sub_bucket << shift) + ((uint64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::record(double latency_ms) {
+  const double value = std::max(latency_ms, 0.0) * kNanosecondsPerMillisecond;
+  const uint64_t value_ns =
+      value >= static_cast<double>(kMaxNanoseconds) ? kMaxNanoseconds : static_cast<uint64_t>(std::llround(value));
+  _buckets[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+  _sum_ns.fetch_add(value_ns, std::memory_order_relaxed);
+  AtomicMin(_min_ns, value_ns);
+  AtomicMax(_max_ns, value_ns);
+  _count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < _buckets.size(); i++) {
+    const uint64_t bucket_count = other._buckets[i].load(std::memory_order_relaxed);
+    if (bucket_count) _buckets[i].fetch_add(bucket_count, std::memory_order_relaxed);
+  }
+  _sum_ns.fetch_add(other._sum_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  AtomicMin(_min_ns, other._min_ns.load(std::memory_order_relaxed));
+  AtomicMax(_max_ns, other._max_ns.load(std::memory_order_relaxed));
+  _count.fetch_add(other._count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+double LatencyHistogram::min() const {
+  return count() ? _min_ns.load(std::memory_order_relaxed) / kNanosecondsPerMillisecond : 0.0;
+}
+
+double LatencyHistogram::max() const { return _max_ns.load(std::memory_order_relaxed) / kNanosecondsPerMillisecond; }
+
+double LatencyHistogram::mean() const {
+  const uint64_t n = count();
+  return n ? _sum_ns.load(std::memory_order_relaxed) / kNanosecondsPerMillisecond / n : 0.0;
+}
+
+double LatencyHistogram::stddev() const {
+  const uint64_t n = count();
+  if (n == 0) return 0.0;
+  // The spread is taken from the bucket midpoints, which is accurate to the bucket width
+  const double mean_ns = static_cast<double>(_sum_ns.load(std::memory_order_relaxed)) / n;
+  double squares = 0.0;
+  for (size_t i = 0; i < _buckets.size(); i++) {
+    const uint64_t bucket_count = _buckets[i].load(std::memory_order_relaxed);
+    if (bucket_count == 0) continue;
+    const double deviation = static_cast<double>(bucket_midpoint(i)) - mean_ns;
+    squares += deviation * deviation * bucket_count;
+  }
+  return std::sqrt(squares / n) / kNanosecondsPerMillisecond;
+}
+
+double LatencyHistogram::percentile(double percentile) const {
+  const uint64_t n = count();
+  if (n == 0) return 0.0;
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * n)));
+  const uint64_t min_ns = _min_ns.load(std::memory_order_relaxed);
+  const uint64_t max_ns = _max_ns.load(std::memory_order_relaxed);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < _buckets.size(); i++) {
+    seen += _buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(std::max(bucket_highest_value(i), min_ns), max_ns) / kNanosecondsPerMillisecond;
+    }
+  }
+  return max_ns / kNanosecondsPerMillisecond;
+}
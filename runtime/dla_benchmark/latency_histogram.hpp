@@ -0,0 +1,63 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Fixed memory, HDR style latency histogram used to report the latency distribution of a run.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Log-linear histogram of latencies with a bounded relative error.
+///
+/// Latencies are kept in nanoseconds. Values below kSubBuckets are exact, above that every power of two range is
+/// split into kSubBuckets / 2 linear buckets, so a reported percentile is within 2 / kSubBuckets (about 0.8%) of the
+/// recorded value. This includes the median, so the reported latency, and the sync mode FPS derived from it, are
+/// quantized to the bucket width. Latencies above kMaxNanoseconds (about 73 minutes) are counted in the last bucket.
+/// All counters are atomics, so recording from the inference callbacks and merging the histograms of several queues do
+/// not need a lock.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  /// Clears all counters. Must not run concurrently with record() or merge().
+  void reset();
+
+  void record(double latency_ms);
+
+  /// Adds the counts of other to this histogram
+  void merge(const LatencyHistogram& other);
+
+  uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+  // All statistics are in milliseconds and return 0 when nothing was recorded
+  double min() const;
+  double max() const;
+  double mean() const;
+  double stddev() const;
+
+  /// @param percentile  in [0, 100]. The result is the highest value equivalent to the bucket holding the
+  ///                    percentile, clamped to the recorded min and max.
+  double percentile(double percentile) const;
+
+ private:
+  static constexpr unsigned kSubBucketBits = 8;
+  static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+  static constexpr unsigned kMaxBits = 42;
+  static constexpr uint64_t kMaxNanoseconds = (uint64_t(1) << kMaxBits) - 1;
+
+  static size_t bucket_index(uint64_t value_ns);
+  static uint64_t bucket_highest_value(size_t index);
+  static uint64_t bucket_midpoint(size_t index);
+
+  std::vector<std::atomic<uint64_t>> _buckets;
+  std::atomic<uint64_t> _count;
+  std::atomic<uint64_t> _sum_ns;
+  std::atomic<uint64_t> _min_ns;
+  std::atomic<uint64_t> _max_ns;
+};
@@ -0,0 +1,61 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Timer driven arrival schedule for the open-loop (-load_rate) mode of dla_benchmark.
+
+#include "load_generator.hpp"
+
+#include <random>
+#include <stdexcept>
+
+LoadGenerator::Arrivals LoadGenerator::parse_arrivals(const std::string &name) {
+  if (name == "constant") return Arrivals::CONSTANT;
+  if (name == "poisson") return Arrivals::POISSON;
+  throw std::logic_error("Unknown arrival process \"" + name + "\", expected \"constant\" or \"poisson\"");
+}
+
+LoadGenerator::LoadGenerator(double rate, Arrivals arrivals, uint64_t seed) {
+  if (!(rate > 0.0)) {
+    throw std::logic_error("The load rate must be positive");
+  }
+  _thread = std::thread(&LoadGenerator::timer_thread, this, rate, arrivals, seed);
+}
+
+LoadGenerator::~LoadGenerator() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _stop_cv.notify_all();
+  _thread.join();
+}
+
+void LoadGenerator::timer_thread(double rate, Arrivals arrivals, uint64_t seed) {
+  std::mt19937_64 generator(seed);
+  std::exponential_distribution<double> poisson_gap(rate);
+  const double constant_gap = 1.0 / rate;
+
+  // Arrival times are accumulated in double precision seconds from the start, rounding each gap to the clock
+  // resolution would drift the mean rate
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_stop) {
+    const Clock::time_point due =
+        start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(elapsed));
+    if (_stop_cv.wait_until(lock, due, [this] { return _stop; })) {
+      return;
+    }
+    _due.push_back(due);
+    _arrival_cv.notify_one();
+    elapsed += arrivals == Arrivals::POISSON ? poisson_gap(generator) : constant_gap;
+  }
+}
+
+LoadGenerator::Clock::time_point LoadGenerator::next_arrival() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _arrival_cv.wait(lock, [this] { return !_due.empty(); });
+  const Clock::time_point due = _due.front();
+  _due.pop_front();
+  return due;
+}
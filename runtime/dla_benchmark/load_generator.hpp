@@ -0,0 +1,68 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Timer driven arrival schedule for the open-loop (-load_rate) mode of dla_benchmark.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/// @brief Generates arrivals at a fixed mean rate, independently of how fast they are consumed.
+///
+/// A timer thread wakes up at every scheduled arrival time and queues it. Arrivals the consumer has not taken yet
+/// pile up in the queue, so a slow consumer sees a growing backlog instead of slowing down the offered load, and
+/// the queueing delay of an arrival is the time between its scheduled time and its submission.
+class LoadGenerator {
+ public:
+  // Monotonic, so a wall clock adjustment cannot move the arrival schedule or the sleeps
+  typedef std::chrono::steady_clock Clock;
+
+  enum class Arrivals {
+    CONSTANT,  // evenly spaced arrivals
+    POISSON,   // exponentially distributed gaps
+  };
+
+  /// Parses "constant" or "poisson", throws std::logic_error on anything else
+  static Arrivals parse_arrivals(const std::string &name);
+
+  /// @param rate      mean number of arrivals per second, must be positive
+  /// @param arrivals  arrival process
+  /// @param seed      seed of the Poisson gaps, so runs can be repeated with the same schedule
+  LoadGenerator(double rate, Arrivals arrivals, uint64_t seed = 0);
+
+  ~LoadGenerator();
+
+  LoadGenerator(const LoadGenerator &) = delete;
+  LoadGenerator &operator=(const LoadGenerator &) = delete;
+
+  /// Blocks until the next arrival is due and returns the time it was scheduled for
+  Clock::time_point next_arrival();
+
+ private:
+  void timer_thread(double rate, Arrivals arrivals, uint64_t seed);
+
+  std::mutex _mutex;
+  std::condition_variable _arrival_cv;  // signalled when an arrival is queued
+  std::condition_variable _stop_cv;     // signalled when the generator is destroyed
+  std::deque<Clock::time_point> _due;
+  bool _stop = false;
+  std::thread _thread;
+};
+
+/// @brief Result of running -niter iterations at one offered load
+struct LoadPointSummary {
+  double offered_fps = 0.0;   // requested frames per second per graph
+  double achieved_fps = 0.0;  // submitted frames per second per graph
+  double latency_p50 = 0.0;   // device latency of the submitted requests (ms)
+  double latency_p99 = 0.0;
+  double queueing_p50 = 0.0;  // time from the scheduled arrival to the submission (ms)
+  double queueing_p99 = 0.0;
+  uint64_t late = 0;     // arrivals that found every infer request busy
+  uint64_t dropped = 0;  // late arrivals that were dropped with -load_drop_late
+};
@@ -10,11 +10,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #if defined(_WIN32) || defined(_WIN64)
@@ -23,12 +26,13 @@
 #include <Windows.h>
 #else
 #include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #endif
 #include <stdio.h>
 #include <sys/stat.h>
 #include <fstream>
-#include <regex>
 
 #include <samples/args_helper.hpp>
 #include <samples/common.hpp>
@@ -43,7 +47,12 @@
 #include "dla_benchmark.hpp"
 #include "dla_plugin_config.hpp"
 #include "infer_request_wrap.hpp"
+#include "inference_trace.hpp"
+#include "input_tensor_producer.hpp"
 #include "inputs_filling.hpp"
+#include "latency_histogram.hpp"
+#include "load_generator.hpp"
+#include "output_dumper.hpp"
 #include "progress_bar.hpp"
 #include "statistics_report.hpp"
 #include "top1_top5.hpp"
@@ -211,6 +220,41 @@ bool CheckAndSetPluginsPath(const char* coredla_root) {
   return false;
 }
 
+// Parses a comma separated list of CPU core numbers
+std::vector<int> ParseCoreList(const std::string& cores) {
+  std::vector<int> core_list;
+  for (const auto& core : split(cores, ',')) {
+    size_t parsed = 0;
+    const int core_number = std::stoi(core, &parsed);
+    if (parsed != core.size() || core_number < 0) {
+      throw std::logic_error("Invalid CPU core \"" + core + "\" in \"" + cores + "\"");
+    }
+    core_list.push_back(core_number);
+  }
+  return core_list;
+}
+
+// Pins the calling thread to one CPU core. Failing to do so only affects performance, so it is just reported.
+void PinCurrentThreadToCore(int core) {
+#if defined(_WIN32) || defined(_WIN64)
+  if (core >= static_cast<int>(sizeof(DWORD_PTR) * 8) ||
+      SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) == 0) {
+    slog::warn << "Could not pin thread to CPU core " << core << slog::endl;
+  }
+#else
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (core >= CPU_SETSIZE) {
+    slog::warn << "Could not pin thread to CPU core " << core << slog::endl;
+    return;
+  }
+  CPU_SET(core, &cpus);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+    slog::warn << "Could not pin thread to CPU core " << core << slog::endl;
+  }
+#endif
+}
+
 bool ParseAndCheckCommandLine(int argc, char* argv[], size_t& net_size) {
   // ---------------------------Parsing and validating input arguments--------------------------------------
   slog::info << "Parsing input parameters" << slog::endl;
@@ -339,6 +383,46 @@ bool ParseAndCheckCommandLine(int argc, char* argv[], size_t& net_size) {
     throw std::logic_error("-niter is a required flag and its value must be positive");
   }
 
+  if (FLAGS_input_queue_depth < 0 || FLAGS_input_decode_threads < 0) {
+    throw std::logic_error("-input_queue_depth and -input_decode_threads must not be negative");
+  }
+
+  if (FLAGS_trace_counter_period_ms <= 0) {
+    throw std::logic_error("-trace_counter_period_ms must be positive");
+  }
+
+  if (FLAGS_graph_threads && !FLAGS_load_rate.empty()) {
+    throw std::logic_error("-graph_threads cannot be used with -load_rate");
+  }
+
+  if (FLAGS_live_accuracy && (FLAGS_groundtruth_loc.empty() || FLAGS_enable_object_detection_ap)) {
+    throw std::logic_error(
+        "-live_accuracy requires -groundtruth_loc and cannot be used with -enable_object_detection_ap");
+  }
+
+  if (!FLAGS_graph_thread_cores.empty()) {
+    if (!FLAGS_graph_threads) {
+      throw std::logic_error("-graph_thread_cores requires -graph_threads");
+    }
+    ParseCoreList(FLAGS_graph_thread_cores);
+  }
+
+  if (!FLAGS_load_rate.empty()) {
+    if (FLAGS_api != "async") {
+      throw std::logic_error("-load_rate submits requests in the background and requires -api async");
+    }
+    const std::vector<float> load_rates = SplitFloat(FLAGS_load_rate, ',');
+    if (load_rates.empty() || std::any_of(load_rates.begin(), load_rates.end(), [](float rate) { return rate <= 0; })) {
+      throw std::logic_error("-load_rate must be a positive rate or a comma separated list of positive rates");
+    }
+    LoadGenerator::parse_arrivals(FLAGS_load_arrivals);
+    if (load_rates.size() > 1 && FLAGS_input_queue_depth > 0) {
+      throw std::logic_error(
+          "A -load_rate sweep feeds the same inputs at every rate, which needs them preloaded. "
+          "It cannot be used with -input_queue_depth");
+    }
+  }
+
   const char* coredla_root = std::getenv("COREDLA_ROOT");
   if (coredla_root == nullptr) {
     slog::err << "ERROR: COREDLA_ROOT environment variable is not set." << slog::endl;
@@ -359,6 +443,11 @@ bool ParseAndCheckCommandLine(int argc, char* argv[], size_t& net_size) {
                 << slog::endl;
       throw std::logic_error("Incorrect YOLO version.");
     }
+    if (FLAGS_recycle_output_tensors) {
+      throw std::logic_error(
+          "-recycle_output_tensors cannot be used with -enable_object_detection_ap, the mAP calculation needs the "
+          "output of every iteration at once.");
+    }
   }
 
   // Checks if output directory exists and can be opened
@@ -397,14 +486,19 @@ static void next_step(const std::string additional_info = "") {
             << (additional_info.empty() ? "" : " (" + additional_info + ")") << std::endl;
 }
 
-template <typename T>
-T GetMedianValue(const std::vector<T>& vec) {
-  std::vector<T> sorted_vec(vec);
-  std::sort(sorted_vec.begin(), sorted_vec.end());
-  return (sorted_vec.size() % 2 != 0)
-             ? sorted_vec[sorted_vec.size() / 2ULL]
-             : (sorted_vec[sorted_vec.size() / 2ULL] + sorted_vec[sorted_vec.size() / 2ULL - 1ULL]) /
-                   static_cast<T>(2.0);
+// Percentiles of the latency distribution that end up in the console output and the run summary
+static const std::vector<std::pair<std::string, double>> latencyPercentiles = {
+    {"p50", 50.0}, {"p90", 90.0}, {"p95", 95.0}, {"p99", 99.0}, {"p99.9", 99.9}};
+
+// Latency distribution of a histogram as (statistic, value in ms) pairs, from min to max followed by the stddev
+std::vector<std::pair<std::string, double>> GetLatencyDistribution(const LatencyHistogram& latencies) {
+  std::vector<std::pair<std::string, double>> distribution = {{"min", latencies.min()}};
+  for (const auto& percentile : latencyPercentiles) {
+    distribution.emplace_back(percentile.first, latencies.percentile(percentile.second));
+  }
+  distribution.emplace_back("max", latencies.max());
+  distribution.emplace_back("stddev", latencies.stddev());
+  return distribution;
 }
 
 void ReadDebugNetworkInfo(ov::Core core) {
@@ -1128,27 +1222,170 @@ int main(int argc, char* argv[]) {
     // TensorVector: An alias for vector<ov::tensor> where each vector element correspond to the batch
     std::vector<std::map<std::string, ov::TensorVector>> input_data_tensors;
     std::vector<std::map<std::string, ov::TensorVector>> output_tensors(compiled_models.size());
+    // With -input_queue_depth the inputs are decoded in the background instead and input_data_tensors stays empty
+    std::vector<std::unique_ptr<InputTensorProducer>> input_producers;
+    size_t input_queue_depth = FLAGS_input_queue_depth;
+    if (input_queue_depth > 0 && input_queue_depth < nireq) {
+      slog::warn << "-input_queue_depth was raised from " << input_queue_depth << " to the number of requests "
+                 << nireq << slog::endl;
+      input_queue_depth = nireq;
+    }
 
+    // Declared before the queues, so it outlives the inference callbacks that add to it
+    std::unique_ptr<InferenceTrace> trace;
+    if (!FLAGS_trace_file.empty()) {
+      trace.reset(new InferenceTrace());
+    }
     std::vector<std::unique_ptr<InferRequestsQueue>> infer_request_queues;
     const std::string resize_type = FLAGS_resize_type.empty() ? "resize" : FLAGS_resize_type;
     for (size_t net_idx = 0; net_idx < compiled_models.size(); net_idx++) {
       // Handle the case that use same inputs for all networks
       const auto& inputFiles =
           net_idx >= multi_input_files.size() ? multi_input_files.back() : multi_input_files[net_idx];
-      input_data_tensors.push_back(GetStaticTensors(inputFiles.empty() ? std::vector<std::string>{} : inputFiles,
-                                                    batch_size,
-                                                    input_infos[net_idx],
-                                                    num_batches,
-                                                    resize_type,
-                                                    FLAGS_bgr,
-                                                    FLAGS_bin_data,
-                                                    !FLAGS_streaming_input_pipe.empty(),
-                                                    FLAGS_verbose));
+      if (input_queue_depth > 0) {
+        InputTensorFactory create_tensors =
+            GetInputTensorFactory(inputFiles.empty() ? std::vector<std::string>{} : inputFiles,
+                                  batch_size,
+                                  input_infos[net_idx],
+                                  num_batches,
+                                  resize_type,
+                                  FLAGS_bgr,
+                                  FLAGS_bin_data,
+                                  !FLAGS_streaming_input_pipe.empty(),
+                                  FLAGS_verbose);
+        input_producers.emplace_back(
+            new InputTensorProducer(create_tensors, num_batches, input_queue_depth, FLAGS_input_decode_threads));
+      } else {
+        input_data_tensors.push_back(GetStaticTensors(inputFiles.empty() ? std::vector<std::string>{} : inputFiles,
+                                                      batch_size,
+                                                      input_infos[net_idx],
+                                                      num_batches,
+                                                      resize_type,
+                                                      FLAGS_bgr,
+                                                      FLAGS_bin_data,
+                                                      !FLAGS_streaming_input_pipe.empty(),
+                                                      FLAGS_verbose));
+      }
       // Use unique_ptr to create InferRequestsQueue objects and avoid copying mutex and cv
       infer_request_queues.push_back(
-          std::move(std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(*(compiled_models[net_idx]), nireq))));
+          std::move(std::unique_ptr<InferRequestsQueue>(
+              new InferRequestsQueue(*(compiled_models[net_idx]), nireq, trace.get(), net_idx))));
+      if (trace) {
+        trace->set_process_name(net_idx, "graph " + topology_names[net_idx]);
+      }
+    }
+
+    // For multi-outputs: Sort to ensure the order of each tensor dump aligns with the ground truth files
+    std::vector<std::vector<ov::Output<const ov::Node>>> sorted_output_infos;
+    for (const auto& compiled_model : compiled_models) {
+      std::vector<ov::Output<const ov::Node>> output_info = compiled_model->outputs();
+      std::sort(output_info.begin(), output_info.end(), CompareOutputNodeNames);
+      sorted_output_infos.push_back(output_info);
+    }
+
+    const auto make_output_dumper = [&](size_t net_idx) {
+      // backward compatibility support for old regtests that used only one graph
+      std::string file_prefix = output_dir;
+      if (compiled_models.size() > 1) {
+        file_prefix += topology_names[net_idx] + "_";
+      }
+      dla_benchmark::InferenceMetaData result_metadata;
+      result_metadata.input_files = multi_input_files.at(net_idx);  // all input files in -i
+      result_metadata.groundtruth_loc = FLAGS_groundtruth_loc;
+      result_metadata.batch_size = FLAGS_batch_size;
+      result_metadata.niter = niter;
+      result_metadata.nireq = nireq;
+      result_metadata.model_input_info = input_infos[net_idx];
+      return std::unique_ptr<OutputDumper>(new OutputDumper(file_prefix,
+                                                            topology_names[net_idx],
+                                                            sorted_output_infos[net_idx],
+                                                            result_metadata,
+                                                            batch_size,
+                                                            FLAGS_max_output_file_size));
+    };
+
+    // Before a request is reused, the batch it last computed is handed to the reorder buffer of its graph, which scores
+    // it against the ground truth in iteration order, so the accuracy is known as soon as the run ends without
+    // collecting every output first. With -recycle_output_tensors each infer request also owns one set of output
+    // tensors, which the reorder buffer dumps. Host memory for outputs is then bounded by nireq instead of niter.
+    const bool stream_top_results = FLAGS_groundtruth_loc != "" && !FLAGS_enable_object_detection_ap;
+    std::vector<std::vector<BatchOutputTensors>> output_tensor_pool(compiled_models.size());
+    // Batch held by each request of each graph, -1 once it has been handed to the reorder buffer
+    std::vector<std::vector<int64_t>> request_batches(compiled_models.size());
+    std::vector<std::unique_ptr<OutputDumper>> output_dumpers(compiled_models.size());
+    std::vector<std::unique_ptr<TopResultsAccumulator>> top_results(compiled_models.size());
+    std::vector<std::unique_ptr<OutputReorderBuffer>> output_reorder_buffers(compiled_models.size());
+    if (FLAGS_recycle_output_tensors || stream_top_results) {
+      const auto groundtruth_files = split(FLAGS_groundtruth_loc, MULTIGRAPH_SEP);
+      for (size_t net_idx = 0; net_idx < compiled_models.size(); net_idx++) {
+        if (FLAGS_recycle_output_tensors) {
+          for (size_t iireq = 0; iireq < nireq; iireq++) {
+            BatchOutputTensors tensors;
+            for (const auto& output : compiled_models[net_idx]->outputs()) {
+              tensors.emplace(output.get_any_name(), ov::Tensor(output.get_element_type(), output.get_shape()));
+            }
+            output_tensor_pool[net_idx].push_back(tensors);
+          }
+          if (FLAGS_dump_output) {
+            output_dumpers[net_idx] = make_output_dumper(net_idx);
+          }
+        }
+        request_batches[net_idx].assign(nireq, -1);
+
+        if (stream_top_results && net_idx < groundtruth_files.size()) {
+          // All graphs are scored at the same time, so each needs its own report
+          const std::string accuracy_results_loc = compiled_models.size() > 1
+                                                       ? topology_names[net_idx] + "_accuracy_report.txt"
+                                                       : "accuracy_report.txt";
+          top_results[net_idx].reset(new TopResultsAccumulator(groundtruth_files[net_idx], accuracy_results_loc));
+        }
+
+        // Without -recycle_output_tensors every batch has its own tensors, so early batches need no copy
+        output_reorder_buffers[net_idx].reset(new OutputReorderBuffer(
+            [&, net_idx](uint32_t batch, const BatchOutputTensors& tensors) {
+              if (output_dumpers[net_idx]) {
+                output_dumpers[net_idx]->addBatch(batch, tensors);
+              }
+              if (top_results[net_idx]) {
+                // captures the results in higher precision for accuracy analysis
+                std::vector<float> results;
+                for (unsigned int img = 0; img < batch_size; img++) {
+                  results.clear();
+                  for (const auto& item : sorted_output_infos[net_idx]) {
+                    const ov::Tensor& tensor = tensors.at(item.get_any_name());
+                    const float* tensor_data = tensor.data<float>();
+                    unsigned int output_size = tensor.get_size() / batch_size;
+                    results.insert(results.end(),
+                                   tensor_data + img * output_size,
+                                   tensor_data + (img + 1) * output_size);
+                  }
+                  top_results[net_idx]->add_image(results.data(), results.size());
+                }
+              }
+            },
+            FLAGS_recycle_output_tensors));
+      }
     }
 
+    // Hands the batch held by a request to the reorder buffer of its graph. The tensors of the batch must be complete.
+    auto release_request_batch = [&](size_t net_id, size_t request_id) {
+      auto& batch = request_batches.at(net_id).at(request_id);
+      if (batch < 0) {
+        return;
+      }
+      if (FLAGS_recycle_output_tensors) {
+        output_reorder_buffers.at(net_id)->push(static_cast<uint32_t>(batch),
+                                                output_tensor_pool.at(net_id).at(request_id));
+      } else {
+        BatchOutputTensors tensors;
+        for (const auto& item : output_tensors.at(net_id)) {
+          tensors.emplace(item.first, item.second.at(batch));
+        }
+        output_reorder_buffers.at(net_id)->push(static_cast<uint32_t>(batch), tensors);
+      }
+      batch = -1;
+    };
+
     // ----------------- 10. Measuring performance ------------------------------------------------------------------
     size_t progress_bar_total_count = progressBarDefaultTotalCount;
 
@@ -1171,54 +1408,256 @@ int main(int argc, char* argv[]) {
       }
     }
     ss << ", limits: " << niter << " iterations with each graph, " << compiled_models.size() << " graph(s)";
-    progress_bar_total_count = niter;
+    // With -load_rate, -niter iterations run open-loop at each of the listed rates. The outputs of the last rate
+    // are the ones that get dumped and checked, the earlier rates only measure the latency at their load.
+    std::vector<float> load_rates;
+    if (!FLAGS_load_rate.empty()) {
+      load_rates = SplitFloat(FLAGS_load_rate, ',');
+      ss << ", open-loop " << FLAGS_load_arrivals << " arrivals at " << FLAGS_load_rate << " FPS";
+    }
+    progress_bar_total_count = niter * std::max<size_t>(load_rates.size(), 1);
     next_step(ss.str());
 
     /** Start inference & calculate performance **/
     /** to align number if iterations to guarantee that last infer requests are executed in the same conditions **/
     ProgressBar progress_bar(progress_bar_total_count, FLAGS_stream_output, FLAGS_progress);
     std::vector<size_t> iterations(compiled_models.size(), 0);
-    try {
-      while ((niter != 0LL && iterations.back() < niter) || (FLAGS_api == "async" && iterations.back() % nireq != 0)) {
-        // set up all infer request and prep all i/o Blobs
-        for (size_t net_id = 0; net_id < compiled_models.size(); net_id++) {
-          for (size_t iireq = 0; iireq < nireq; iireq++) {
-            auto infer_request = infer_request_queues.at(net_id)->get_idle_request();
-            if (!infer_request) {
-              OPENVINO_THROW("No idle Infer Requests!");
+    // Open-loop results of each -load_rate, and the queueing delays of the last one
+    std::vector<LoadPointSummary> load_points;
+    LatencyHistogram queueing_delays;
+
+    // Only the thread of the last graph reports progress, so the progress bar is never updated concurrently. The
+    // last graph also scores its batches on that thread, so its running accuracy can be shown with the progress.
+    auto report_progress = [&]() {
+      const auto& scored = top_results.back();
+      if (FLAGS_live_accuracy && scored && scored->num_images() > 0) {
+        std::ostringstream status;
+        status << std::fixed << std::setprecision(2) << "top1 " << scored->top1_accuracy() << "% top5 "
+               << scored->top5_accuracy() << "% (" << scored->num_images() << " images)";
+        progress_bar.setStatus(status.str());
+      }
+      progress_bar.addProgress(1);
+    };
+
+    // Gives a request the inputs of its next iteration and, if keep_outputs is set, the tensors its outputs are
+    // kept in until they are dumped
+    auto prepare_request = [&](size_t net_id, const InferReqWrap::Ptr& infer_request, bool keep_outputs) {
+      infer_request->prepare(iterations.at(net_id));
+      // Without keep_outputs the outputs stay in the tensors the request allocated itself
+      if (keep_outputs) {
+        const auto& outputs = compiled_models[net_id]->outputs();
+        // The request is idle, so the batch it computed last is complete and can be consumed
+        if (output_reorder_buffers.at(net_id)) {
+          release_request_batch(net_id, infer_request->get_id());
+          request_batches.at(net_id).at(infer_request->get_id()) = iterations.at(net_id);
+        }
+        if (FLAGS_recycle_output_tensors) {
+          const auto& pooled_tensors = output_tensor_pool.at(net_id).at(infer_request->get_id());
+          for (const auto& output : outputs) {
+            infer_request->set_tensor(output, pooled_tensors.at(output.get_any_name()));
+          }
+        } else {
+          for (const auto& output : outputs) {
+            const std::string& name = output.get_any_name();
+            output_tensors.at(net_id)[name].emplace_back(output.get_element_type(), output.get_shape());
+            infer_request->set_tensor(output, output_tensors.at(net_id).at(name).at(iterations.at(net_id)));
+          }
+        }
+      }
+      const auto& inputs = compiled_models[net_id]->inputs();
+      if (!input_producers.empty()) {
+        // The request keeps a reference to the tensors until it is given the next iteration's inputs
+        const auto data = input_producers.at(net_id)->take(iterations.at(net_id));
+        for (auto& input : inputs) {
+          infer_request->set_tensor(input, data.at(input.get_any_name()));
+        }
+      } else {
+        for (auto& input : inputs) {
+          const std::string& name = input.get_any_name();
+          const auto& data = input_data_tensors.at(net_id).at(name)[iterations.at(net_id)];
+          infer_request->set_tensor(input, data);
+        }
+      }
+    };
+
+    // Closed-loop end condition of a graph. In async mode the graph also runs until all of its requests got the same
+    // number of iterations, so the last requests are executed under the same conditions as the others.
+    auto has_iterations_left = [&](size_t net_id) {
+      return (niter != 0LL && iterations.at(net_id) < niter) ||
+             (FLAGS_api == "async" && iterations.at(net_id) % nireq != 0);
+    };
+
+    // Runs the next iteration of a graph on the next idle request of the graph
+    auto submit_next_iteration = [&](size_t net_id) {
+      auto infer_request = infer_request_queues.at(net_id)->get_idle_request();
+      if (!infer_request) {
+        OPENVINO_THROW("No idle Infer Requests!");
+      }
+
+      if (niter != 0LL) {
+        prepare_request(net_id, infer_request, true);
+      }
+
+      // Execute one request/batch
+      if (FLAGS_api == "sync") {
+        infer_request->infer();
+      } else {
+        // As the inference request is currently idle, the wait() adds no additional overhead (and should return
+        // immediately). The primary reason for calling the method is exception checking/re-throwing. Callback,
+        // that governs the actual execution can handle errors as well, but as it uses just error codes it has no
+        // details like ‘what()’ method of `std::exception` So, rechecking for any exceptions here.
+        infer_request->wait();
+        infer_request->start_async();
+      }
+      iterations.at(net_id)++;
+      if (net_id == compiled_models.size() - 1) {
+        report_progress();
+      }
+    };
+
+    // The FPGA counters get their own track group after the graphs
+    if (trace && has_fpga) {
+      const uint32_t counters_pid = static_cast<uint32_t>(compiled_models.size());
+      trace->set_process_name(counters_pid, "FPGA");
+      double last_active_time = 0.0;
+      InferenceTrace::Clock::time_point last_sample;
+      trace->start_sampling(
+          [&core, &trace, counters_pid, last_active_time, last_sample]() mutable {
+            const auto now = InferenceTrace::Clock::now();
+            const double active_time = core.get_property("FPGA", "IP_ACTIVE_TIME").as<double>();
+            trace->add_counter(counters_pid, "IP active time (ms)", now, {{"active time", active_time}});
+            if (last_sample != InferenceTrace::Clock::time_point()) {
+              const double elapsed = std::chrono::duration<double, std::milli>(now - last_sample).count();
+              trace->add_counter(
+                  counters_pid, "IP busy (%)", now, {{"busy", 100.0 * (active_time - last_active_time) / elapsed}});
+            }
+            last_active_time = active_time;
+            last_sample = now;
+            if (FLAGS_debug_network) {
+              const auto debug_network = core.get_property("FPGA", "COREDLA_DEBUG_NETWORK_INFO")
+                                             .as<std::vector<DebugNetworkData>>();
+              for (size_t instance = 0; instance < debug_network.size(); instance++) {
+                std::map<std::string, double> values(debug_network[instance].begin(), debug_network[instance].end());
+                trace->add_counter(
+                    counters_pid, "debug network instance " + std::to_string(instance), now, values);
+              }
             }
+          },
+          std::chrono::milliseconds(FLAGS_trace_counter_period_ms));
+    }
 
-            if (niter != 0LL) {
-              const auto& outputs = compiled_models[net_id]->outputs();
-              for (const auto& output : outputs) {
-                const std::string& name = output.get_any_name();
-                output_tensors.at(net_id)[name].emplace_back(output.get_element_type(), output.get_shape());
-                infer_request->set_tensor(output, output_tensors.at(net_id).at(name).at(iterations.at(net_id)));
+    try {
+      // Every request needs its first input before the measurement starts, the rest is decoded while inferring
+      for (auto& input_producer : input_producers) {
+        input_producer->wait_ready(nireq);
+      }
+      if (load_rates.empty() && FLAGS_graph_threads) {
+        // Each graph is fed by its own thread, so a graph waiting for an idle request does not hold back the others.
+        // The threads wait for each other before their first submission so the graphs start loaded together.
+        const std::vector<int> cores = ParseCoreList(FLAGS_graph_thread_cores);
+        std::mutex start_mutex;
+        std::condition_variable start_cv;
+        size_t threads_waiting = 0;
+        std::vector<std::exception_ptr> thread_exceptions(compiled_models.size());
+        std::vector<std::thread> submission_threads;
+        for (size_t net_id = 0; net_id < compiled_models.size(); net_id++) {
+          submission_threads.emplace_back([&, net_id] {
+            try {
+              if (!cores.empty()) {
+                PinCurrentThreadToCore(cores[net_id % cores.size()]);
+              }
+              {
+                std::unique_lock<std::mutex> lock(start_mutex);
+                if (++threads_waiting == compiled_models.size()) {
+                  start_cv.notify_all();
+                } else {
+                  start_cv.wait(lock, [&] { return threads_waiting == compiled_models.size(); });
+                }
               }
-              const auto& inputs = compiled_models[net_id]->inputs();
-              for (auto& input : inputs) {
-                const std::string& name = input.get_any_name();
-                const auto& data = input_data_tensors.at(net_id).at(name)[iterations.at(net_id)];
-                infer_request->set_tensor(input, data);
+              while (has_iterations_left(net_id)) {
+                submit_next_iteration(net_id);
               }
+            } catch (...) {
+              thread_exceptions[net_id] = std::current_exception();
             }
-
-            // Execute one request/batch
-            if (FLAGS_api == "sync") {
-              infer_request->infer();
-            } else {
-              // As the inference request is currently idle, the wait() adds no additional overhead (and should return
-              // immediately). The primary reason for calling the method is exception checking/re-throwing. Callback,
-              // that governs the actual execution can handle errors as well, but as it uses just error codes it has no
-              // details like ‘what()’ method of `std::exception` So, rechecking for any exceptions here.
-              infer_request->wait();
-              infer_request->start_async();
+          });
+        }
+        for (auto& submission_thread : submission_threads) {
+          submission_thread.join();
+        }
+        for (const auto& thread_exception : thread_exceptions) {
+          if (thread_exception) std::rethrow_exception(thread_exception);
+        }
+      } else if (load_rates.empty()) {
+        while (has_iterations_left(compiled_models.size() - 1)) {
+          // set up all infer request and prep all i/o Blobs
+          for (size_t net_id = 0; net_id < compiled_models.size(); net_id++) {
+            for (size_t iireq = 0; iireq < nireq; iireq++) {
+              submit_next_iteration(net_id);
+            }
+          }
+        }
+      } else {
+        const LoadGenerator::Arrivals arrivals = LoadGenerator::parse_arrivals(FLAGS_load_arrivals);
+        for (size_t point = 0; point < load_rates.size(); point++) {
+          const bool last_point = point + 1 == load_rates.size();
+          if (point > 0) {
+            for (auto& infer_request_queue : infer_request_queues) {
+              infer_request_queue->reset_times();
             }
-            iterations.at(net_id)++;
-            if (net_id == compiled_models.size() - 1) {
-              progress_bar.addProgress(1);
+            std::fill(iterations.begin(), iterations.end(), 0);
+          }
+          queueing_delays.reset();
+          LoadPointSummary summary;
+          summary.offered_fps = load_rates[point];
+          {
+            // Each arrival submits one request, so one batch, to every graph that still has iterations to run
+            LoadGenerator load_generator(load_rates[point] / batch_size, arrivals, point);
+            auto has_arrivals_left = [&] {
+              return std::any_of(iterations.begin(), iterations.end(), [&](size_t it) { return it < niter; });
+            };
+            while (has_arrivals_left()) {
+              const auto arrival = load_generator.next_arrival();
+              for (size_t net_id = 0; net_id < compiled_models.size(); net_id++) {
+                if (iterations.at(net_id) >= niter) continue;
+                auto infer_request = infer_request_queues.at(net_id)->try_get_idle_request();
+                if (!infer_request) {
+                  summary.late++;
+                  if (FLAGS_load_drop_late) {
+                    summary.dropped++;
+                    continue;
+                  }
+                  infer_request = infer_request_queues.at(net_id)->get_idle_request();
+                }
+                prepare_request(net_id, infer_request, last_point);
+                queueing_delays.record(
+                    std::chrono::duration_cast<ns>(LoadGenerator::Clock::now() - arrival).count() * 0.000001);
+                infer_request->wait();
+                infer_request->start_async();
+                iterations.at(net_id)++;
+                if (net_id == compiled_models.size() - 1) {
+                  report_progress();
+                }
+              }
             }
           }
+
+          LatencyHistogram point_latencies;
+          auto point_start = infer_request_queues.at(0)->get_start_time();
+          auto point_end = infer_request_queues.at(0)->get_end_time();
+          for (auto& infer_request_queue : infer_request_queues) {
+            infer_request_queue->wait_all();
+            point_latencies.merge(infer_request_queue->get_latencies());
+            point_start = std::min(point_start, infer_request_queue->get_start_time());
+            point_end = std::max(point_end, infer_request_queue->get_end_time());
+          }
+          const double point_duration = std::chrono::duration_cast<ns>(point_end - point_start).count() * 0.000000001;
+          summary.achieved_fps = niter * batch_size / point_duration;
+          summary.latency_p50 = point_latencies.percentile(50.0);
+          summary.latency_p99 = point_latencies.percentile(99.0);
+          summary.queueing_p50 = queueing_delays.percentile(50.0);
+          summary.queueing_p99 = queueing_delays.percentile(99.0);
+          load_points.push_back(summary);
         }
       }
 
@@ -1226,9 +1665,34 @@ int main(int argc, char* argv[]) {
       for (auto& infer_request_queue : infer_request_queues) {
         infer_request_queue->wait_all();
       }
+
+      // Consume the batches still held by the requests, oldest first so nothing needs to be reordered
+      for (size_t net_id = 0; net_id < compiled_models.size(); net_id++) {
+        if (!output_reorder_buffers[net_id]) {
+          continue;
+        }
+        std::map<int64_t, size_t> batch_to_request;
+        for (size_t iireq = 0; iireq < nireq; iireq++) {
+          if (request_batches[net_id][iireq] >= 0) {
+            batch_to_request[request_batches[net_id][iireq]] = iireq;
+          }
+        }
+        for (const auto& item : batch_to_request) {
+          release_request_batch(net_id, item.second);
+        }
+      }
+      if (trace) {
+        trace->stop_sampling();
+      }
     } catch (const std::exception& ex) {
       slog::err << "Inference failed:" << slog::endl;
       slog::err << ex.what() << slog::endl;
+      if (trace) {
+        // The inferences up to the failure are often the best hint at what went wrong
+        trace->stop_sampling();
+        trace->write(FLAGS_trace_file);
+        slog::info << "Inference trace is saved to " << FLAGS_trace_file << slog::endl;
+      }
       if (has_fpga) {
         ReadDebugNetworkInfo(core);
         PrintLSUCounterInfo(core);
@@ -1240,21 +1704,28 @@ int main(int argc, char* argv[]) {
 
     size_t iteration = iterations.back();
 
-    std::vector<double> all_latencies;
+    LatencyHistogram all_latencies;
     auto start_time = infer_request_queues.at(0)->get_start_time();
     auto end_time = infer_request_queues.at(0)->get_end_time();
     for (auto& infer_request_queue : infer_request_queues) {
-      auto& latencies = infer_request_queue->get_latencies();
-      all_latencies.insert(all_latencies.end(), latencies.begin(), latencies.end());
+      all_latencies.merge(infer_request_queue->get_latencies());
       start_time = std::min(start_time, infer_request_queue->get_start_time());
       end_time = std::max(end_time, infer_request_queue->get_end_time());
     }
-    double latency = GetMedianValue<double>(all_latencies);
+    // Quantized to the histogram bucket width (under 0.8%), and so is the sync mode FPS derived from it
+    double latency = all_latencies.percentile(50.0);
     double total_duration = std::chrono::duration_cast<ns>(end_time - start_time).count() * 0.000001;
     double total_fps = (FLAGS_api == "sync")
                            ? compiled_models.size() * batch_size * 1000.0 / latency
                            : compiled_models.size() * batch_size * 1000.0 * iteration / total_duration;
 
+    // Throughput of each graph over its own active time, the graphs may finish at different times
+    std::vector<double> graph_fps;
+    for (size_t net_idx = 0; net_idx < infer_request_queues.size(); net_idx++) {
+      const double graph_duration = infer_request_queues[net_idx]->get_durations_in_milliseconds();
+      graph_fps.push_back(graph_duration > 0.0 ? batch_size * 1000.0 * iterations[net_idx] / graph_duration : 0.0);
+    }
+
     int ip_num_instances = 0;
     double ip_duration = 0.0;
     double ip_fps = 0.0;
@@ -1266,11 +1737,13 @@ int main(int argc, char* argv[]) {
     if (has_fpga) {
       ip_num_instances = core.get_property("FPGA", "COREDLA_NUM_INSTANCES").as<int>();
       // even if hardware has 2 instances, only 1 instance actually gets used if only 1 inference is performed
-      size_t ip_num_instances_used = std::min((size_t)ip_num_instances, iteration);
+      // The IP active time covers every rate of a -load_rate sweep
+      const size_t ip_iterations = iteration * std::max<size_t>(load_rates.size(), 1);
+      size_t ip_num_instances_used = std::min((size_t)ip_num_instances, ip_iterations);
       ip_duration = core.get_property("FPGA", "IP_ACTIVE_TIME").as<double>();
       if (ip_duration) {
         if (ip_duration != 0.0) {
-          ip_fps = compiled_models.size() * batch_size * 1000.0 * iteration / ip_duration / ip_num_instances_used;
+          ip_fps = compiled_models.size() * batch_size * 1000.0 * ip_iterations / ip_duration / ip_num_instances_used;
         }
         fmax_core = core.get_property("FPGA", "COREDLA_CLOCK_FREQUENCY").as<double>();
         if (fmax_core > 0.0) {
@@ -1346,10 +1819,50 @@ int main(int argc, char* argv[]) {
                                   {
                                       {"latency (ms)", double_to_string(latency)},
                                   });
+        StatisticsReport::Parameters latency_parameters;
+        for (const auto& statistic : GetLatencyDistribution(all_latencies)) {
+          latency_parameters.emplace_back("latency " + statistic.first + " (ms)", double_to_string(statistic.second));
+        }
+        if (infer_request_queues.size() > 1) {
+          for (size_t net_idx = 0; net_idx < infer_request_queues.size(); net_idx++) {
+            for (const auto& statistic : GetLatencyDistribution(infer_request_queues[net_idx]->get_latencies())) {
+              latency_parameters.emplace_back(topology_names[net_idx] + " latency " + statistic.first + " (ms)",
+                                              double_to_string(statistic.second));
+            }
+          }
+        }
+        statistics->addParameters(StatisticsReport::Category::EXECUTION_RESULTS, latency_parameters);
       }
       statistics->addParameters(
           StatisticsReport::Category::EXECUTION_RESULTS,
           {{"throughput", double_to_string(total_fps)}, {"IP throughput", double_to_string(ip_fps)}});
+      if (FLAGS_api == "async" && infer_request_queues.size() > 1) {
+        for (size_t net_idx = 0; net_idx < infer_request_queues.size(); net_idx++) {
+          statistics->addParameters(StatisticsReport::Category::EXECUTION_RESULTS,
+                                    {{topology_names[net_idx] + " throughput", double_to_string(graph_fps[net_idx])}});
+        }
+      }
+      if (!load_points.empty()) {
+        StatisticsReport::Parameters load_parameters;
+        for (const auto& statistic : GetLatencyDistribution(queueing_delays)) {
+          load_parameters.emplace_back("queueing delay " + statistic.first + " (ms)",
+                                       double_to_string(statistic.second));
+        }
+        for (const auto& point : load_points) {
+          const std::string load = "load " + double_to_string(point.offered_fps) + " FPS ";
+          load_parameters.insert(load_parameters.end(),
+                                 {
+                                     {load + "achieved FPS", double_to_string(point.achieved_fps)},
+                                     {load + "latency p50 (ms)", double_to_string(point.latency_p50)},
+                                     {load + "latency p99 (ms)", double_to_string(point.latency_p99)},
+                                     {load + "queueing delay p50 (ms)", double_to_string(point.queueing_p50)},
+                                     {load + "queueing delay p99 (ms)", double_to_string(point.queueing_p99)},
+                                     {load + "late arrivals", std::to_string(point.late)},
+                                     {load + "dropped arrivals", std::to_string(point.dropped)},
+                                 });
+        }
+        statistics->addParameters(StatisticsReport::Category::EXECUTION_RESULTS, load_parameters);
+      }
     }
 
     progress_bar.finish();
@@ -1383,12 +1896,53 @@ int main(int argc, char* argv[]) {
       statistics->dump();
     }
 
+    if (trace) {
+      trace->write(FLAGS_trace_file);
+      slog::info << "Inference trace is saved to " << FLAGS_trace_file << slog::endl;
+    }
+
     std::cout << "count:             " << iteration << " iterations" << std::endl;
     std::cout << "system duration:   " << double_to_string(total_duration) << " ms" << std::endl;
     if (ip_duration != 0.0) std::cout << "IP duration:       " << double_to_string(ip_duration) << " ms" << std::endl;
-    if (device_name.find("MULTI") == std::string::npos)
+    auto print_latency_distribution = [&double_to_string](const std::string& label,
+                                                          const LatencyHistogram& latencies) {
+      std::cout << label;
+      for (const auto& statistic : GetLatencyDistribution(latencies)) {
+        std::cout << " " << statistic.first << " " << double_to_string(statistic.second);
+      }
+      std::cout << " ms" << std::endl;
+    };
+    if (device_name.find("MULTI") == std::string::npos) {
       std::cout << "latency:           " << double_to_string(latency) << " ms" << std::endl;
+      print_latency_distribution("latency distribution:", all_latencies);
+      if (infer_request_queues.size() > 1) {
+        for (size_t net_idx = 0; net_idx < infer_request_queues.size(); net_idx++) {
+          print_latency_distribution("  " + topology_names[net_idx] + ":",
+                                     infer_request_queues[net_idx]->get_latencies());
+        }
+      }
+    }
     std::cout << "system throughput: " << double_to_string(total_fps) << " FPS" << std::endl;
+    if (FLAGS_api == "async" && infer_request_queues.size() > 1) {
+      for (size_t net_idx = 0; net_idx < infer_request_queues.size(); net_idx++) {
+        std::cout << "  " << topology_names[net_idx] << ": " << double_to_string(graph_fps[net_idx]) << " FPS"
+                  << std::endl;
+      }
+    }
+    if (!load_points.empty()) {
+      print_latency_distribution("queueing delay distribution:", queueing_delays);
+      std::cout << "latency vs load (per graph, latencies in ms):" << std::endl;
+      std::cout << std::setw(14) << "offered FPS" << std::setw(14) << "achieved FPS" << std::setw(14) << "latency p50"
+                << std::setw(14) << "latency p99" << std::setw(14) << "queueing p50" << std::setw(14) << "queueing p99"
+                << std::setw(10) << "late" << std::setw(10) << "dropped" << std::endl;
+      for (const auto& point : load_points) {
+        std::cout << std::setw(14) << double_to_string(point.offered_fps) << std::setw(14)
+                  << double_to_string(point.achieved_fps) << std::setw(14) << double_to_string(point.latency_p50)
+                  << std::setw(14) << double_to_string(point.latency_p99) << std::setw(14)
+                  << double_to_string(point.queueing_p50) << std::setw(14) << double_to_string(point.queueing_p99)
+                  << std::setw(10) << point.late << std::setw(10) << point.dropped << std::endl;
+      }
+    }
     if (ip_num_instances != 0) std::cout << "number of hardware instances: " << ip_num_instances << std::endl;
     if (compiled_models.size() != 0)
       std::cout << "number of network instances: " << compiled_models.size() << std::endl;
@@ -1409,117 +1963,21 @@ int main(int argc, char* argv[]) {
 
     if (FLAGS_dump_output) {
       for (size_t i = 0; i < compiled_models.size(); i++) {
-        std::vector<ov::Output<const ov::Node>> output_info = compiled_models[i]->outputs();
-        // For multi-outputs: Sort to ensure the order of each tensor dump aligns with the ground truth files
-        std::sort(output_info.begin(), output_info.end(), CompareOutputNodeNames);
-        const auto& output_tensors_map = output_tensors[i];
-        // A flag regarding whether we can dump output tensor in a text file due to unsupported layout.
-        // This flag is set at first during dumping.
-        bool can_dump_txt = true;
-        bool can_dump_layout_info_in_txt = true;
-        // dump output tensor as bin, which can be loaded using Python Numpy
-        std::regex pattern("\\{batch\\}");
-        std::string results_bin_file_name = output_dir + "result_{batch}.bin";
-        // dump output tensor as text
-        // backward compatibility support for old regtests that used only one graph
-        std::string results_txt_file_name = output_dir + "result.txt";
-        std::string results_boundaries_file_name = output_dir + "result_tensor_boundaries.txt";
-        // dump inference arguments and metadata as JSON
-        std::string results_meta_file_name = output_dir + "result_meta.json";
-
-        if (compiled_models.size() > 1) {
-          results_bin_file_name = output_dir + topology_names[i] + "_result_{batch}.bin";
-          results_txt_file_name = output_dir + topology_names[i] + "_result.txt";
-          results_boundaries_file_name = output_dir + topology_names[i] + "_result_tensor_boundaries.txt";
-          results_meta_file_name = output_dir + topology_names[i] + "_result_meta.json";
+        if (FLAGS_recycle_output_tensors) {
+          // Every batch was already written during inference
+          output_dumpers[i]->finish();
+          continue;
         }
-
-        slog::info << "Dumping result of " << topology_names[i]
-                   << " to " << results_txt_file_name << slog::endl;
-        slog::info << "Dumping per-batch result (raw output) of " << topology_names[i]
-                   << " to " << results_bin_file_name << slog::endl;
-        slog::info << "Dumping inference meta data of " << topology_names[i]
-                   << " to " << results_meta_file_name << slog::endl;
-
-        std::ofstream result_txt_file(results_txt_file_name);
-        std::ofstream results_boundaries(results_boundaries_file_name);
-        std::ofstream result_meta_file(results_meta_file_name);
-
-        dla_benchmark::InferenceMetaData result_metadata;
-        result_metadata.input_files = multi_input_files.at(i);  // all input files in -i
-        result_metadata.groundtruth_loc = FLAGS_groundtruth_loc;
-        result_metadata.batch_size = FLAGS_batch_size;
-        result_metadata.niter = niter;
-        result_metadata.nireq = nireq;
-        result_metadata.model_input_info = input_infos[i];
-        dla_benchmark::OutputsInfoVec model_output_info;
-
-        uint32_t current_lines = 1;
-        size_t max_allowed_megabytes_to_dump = FLAGS_max_output_file_size;
-
+        std::unique_ptr<OutputDumper> output_dumper = make_output_dumper(i);
+        const auto& output_tensors_map = output_tensors[i];
         for (uint32_t batch = 0; batch < num_batches; batch++) {
-          std::string per_batch_results_bin_file_name = std::regex_replace(results_bin_file_name,
-                                                                           pattern,
-                                                                           std::to_string(batch));
-          std::ofstream per_batch_results_bin_file(per_batch_results_bin_file_name, std::ios::binary);
-
-          for (const auto& item : output_info) {
-            auto tensor = output_tensors_map.at(item.get_any_name()).at(batch);
-            unsigned int output_size = tensor.get_size() / batch_size;
-
-            const ov::Layout& layout = ov::layout::get_layout(item);
-            const auto& shape = tensor.get_shape();
-            const std::string& name = item.get_any_name();
-            size_t total_bytes_to_dump = tensor.get_size() * niter * sizeof(float);
-
-            if (can_dump_txt) {
-              // if we cannot dump as a text file, we set can_dump_txt flag to false and write the one-time message
-              if (total_bytes_to_dump > max_allowed_megabytes_to_dump * BYTE_TO_MEGABYTE) {
-                can_dump_txt = false;
-                std::string msg = "Output tensor (" + std::to_string(total_bytes_to_dump / BYTE_TO_MEGABYTE) +
-                                  " MB) "
-                                  "is too large to dump. Change environmental variable MAX_DUMP_OUTPUT_TXT (default " +
-                                  std::to_string(FLAGS_max_output_file_size) + " MB) to allow dumping larger tensors";
-                slog::warn << msg << slog::endl;
-                result_txt_file << msg;
-              } else {
-                if (can_dump_layout_info_in_txt && shape.size() != 2 && shape.size() != 4 && shape.size() != 5) {
-                  can_dump_layout_info_in_txt = false;
-                  slog::warn << "Output data tensor of rank that is not 2, 4 or 5. layout info will not be dumped in "
-                             << "result.txt." << slog::endl;
-                }
-                // Otherwise, dump text and write to the result_tensor_boundaries.txt with additional information
-                // about the result.txt file
-                results_boundaries << name << ": Line " << current_lines << " to "
-                                   << "line " << current_lines + output_size - 1 << std::endl;
-                results_boundaries << name << " output layout: " << layout.to_string() << std::endl;
-                results_boundaries << name << " output dimension:";
-                for (unsigned int dim = 0; dim < shape.size(); dim++) {
-                  results_boundaries << " " << shape[dim];
-                }
-                results_boundaries << std::endl;
-                current_lines = current_lines + output_size;
-                DumpResultTxtFile(tensor, item, output_size, result_txt_file);
-              }
-            }
-            DumpResultBinFile(tensor, per_batch_results_bin_file);
-
-            if (batch == 0) {
-              // all batches should have the same output info
-              dla_benchmark::OutputInfo output_info;
-              output_info.name = name;
-              output_info.shape = shape;
-              model_output_info.push_back(output_info);
-            }
+          BatchOutputTensors tensors;
+          for (const auto& item : sorted_output_infos[i]) {
+            tensors.emplace(item.get_any_name(), output_tensors_map.at(item.get_any_name()).at(batch));
           }
-          per_batch_results_bin_file.close();
+          output_dumper->addBatch(batch, tensors);
         }
-
-        result_metadata.model_output_info = model_output_info;
-        DumpResultMetaJSONFile(result_metadata, result_meta_file);
-        result_txt_file.close();
-        results_boundaries.close();
-        result_meta_file.close();
+        output_dumper->finish();
       }
       const std::string throughput_file_name = output_dir + "throughput_report.txt";
       std::ofstream throughput_file;
@@ -1546,9 +2004,7 @@ int main(int argc, char* argv[]) {
         // gives the mAP and COCO AP scores. These scores are two of the main detection evaluation
         // metrics used in the Common Objects in Context contest, https://cocodataset.org/#detection-eval.
 
-        std::vector<ov::Output<const ov::Node>> output_info = compiled_models[i]->outputs();
-        // For multi-outputs: Sort to ensure the order of each tensor dump aligns with the ground truth files
-        std::sort(output_info.begin(), output_info.end(), CompareOutputNodeNames);
+        const auto& output_info = sorted_output_infos[i];
         // Run the default top-1, top-5 evaluation routine if AP scores are not required.
         if (!FLAGS_enable_object_detection_ap) {
           if (groundtruth_files.size() <= i) {
@@ -1557,24 +2013,8 @@ int main(int argc, char* argv[]) {
           }
           slog::info << "Comparing ground truth file " << groundtruth_files[i] << " with network " << topology_names[i]
                      << slog::endl;
-          // captures the results in higher precision for accuracy analysis
-          std::vector<float> results;
-          const auto& output_tensors_map = output_tensors[i];
-          for (uint32_t batch = 0; batch < num_batches; batch++) {
-            for (unsigned int img = 0; img < batch_size; img++) {
-              for (const auto& item : output_info) {
-                auto tensor = output_tensors_map.at(item.get_any_name()).at(batch);
-                auto tensor_data = tensor.data<float>();
-                unsigned int output_size = tensor.get_size() / batch_size;
-                size_t offset = img * output_size;
-                for (unsigned int j = 0; j < output_size; j++) {
-                  results.push_back(tensor_data[j + offset]);
-                }
-              }
-            }
-          }
-          bool passed = TopResultsAnalyser::get_top_results(groundtruth_files[i], results, batch_size * num_batches);
-          if (passed) {
+          // Every image was already scored during inference
+          if (top_results[i]->report()) {
             slog::info << "Get top results for \"" << topology_names[i] << "\" graph passed" << slog::endl;
           } else {
             // return 4 indicates that the accuracy of the result was below the threshold
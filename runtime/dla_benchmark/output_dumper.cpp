@@ -0,0 +1,134 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Writes the dla_benchmark result files one batch at a time and restores the iteration order of
+//              batches that finish out of order.
+
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <samples/slog.hpp>
+
+#include "output_dumper.hpp"
+
+OutputDumper::OutputDumper(const std::string &file_prefix,
+                           const std::string &topology_name,
+                           const std::vector<ov::Output<const ov::Node>> &output_info,
+                           const dla_benchmark::InferenceMetaData &metadata,
+                           size_t batch_size,
+                           size_t max_output_file_size)
+    : _output_info(output_info),
+      _metadata(metadata),
+      _batch_size(batch_size),
+      _max_output_file_size(max_output_file_size) {
+  // dump output tensor as bin, which can be loaded using Python Numpy
+  _results_bin_file_name = file_prefix + "result_{batch}.bin";
+  // dump output tensor as text
+  const std::string results_txt_file_name = file_prefix + "result.txt";
+  const std::string results_boundaries_file_name = file_prefix + "result_tensor_boundaries.txt";
+  // dump inference arguments and metadata as JSON
+  const std::string results_meta_file_name = file_prefix + "result_meta.json";
+
+  slog::info << "Dumping result of " << topology_name << " to " << results_txt_file_name << slog::endl;
+  slog::info << "Dumping per-batch result (raw output) of " << topology_name << " to " << _results_bin_file_name
+             << slog::endl;
+  slog::info << "Dumping inference meta data of " << topology_name << " to " << results_meta_file_name << slog::endl;
+
+  _result_txt_file.open(results_txt_file_name);
+  _results_boundaries.open(results_boundaries_file_name);
+  _result_meta_file.open(results_meta_file_name);
+  _metadata.model_output_info.clear();
+}
+
+void OutputDumper::addBatch(uint32_t batch, const BatchOutputTensors &tensors) {
+  static const std::regex pattern("\\{batch\\}");
+  std::string per_batch_results_bin_file_name =
+      std::regex_replace(_results_bin_file_name, pattern, std::to_string(batch));
+  std::ofstream per_batch_results_bin_file(per_batch_results_bin_file_name, std::ios::binary);
+
+  for (const auto &item : _output_info) {
+    const std::string &name = item.get_any_name();
+    const ov::Tensor &tensor = tensors.at(name);
+    unsigned int output_size = tensor.get_size() / _batch_size;
+
+    const ov::Layout &layout = ov::layout::get_layout(item);
+    const auto &shape = tensor.get_shape();
+    size_t total_bytes_to_dump = tensor.get_size() * _metadata.niter * sizeof(float);
+
+    if (_can_dump_txt) {
+      // if we cannot dump as a text file, we set can_dump_txt flag to false and write the one-time message
+      if (total_bytes_to_dump > _max_output_file_size * BYTE_TO_MEGABYTE) {
+        _can_dump_txt = false;
+        std::string msg = "Output tensor (" + std::to_string(total_bytes_to_dump / BYTE_TO_MEGABYTE) +
+                          " MB) "
+                          "is too large to dump. Change environmental variable MAX_DUMP_OUTPUT_TXT (default " +
+                          std::to_string(_max_output_file_size) + " MB) to allow dumping larger tensors";
+        slog::warn << msg << slog::endl;
+        _result_txt_file << msg;
+      } else {
+        if (_can_dump_layout_info_in_txt && shape.size() != 2 && shape.size() != 4 && shape.size() != 5) {
+          _can_dump_layout_info_in_txt = false;
+          slog::warn << "Output data tensor of rank that is not 2, 4 or 5. layout info will not be dumped in "
+                     << "result.txt." << slog::endl;
+        }
+        // Otherwise, dump text and write to the result_tensor_boundaries.txt with additional information
+        // about the result.txt file
+        _results_boundaries << name << ": Line " << _current_lines << " to "
+                            << "line " << _current_lines + output_size - 1 << std::endl;
+        _results_boundaries << name << " output layout: " << layout.to_string() << std::endl;
+        _results_boundaries << name << " output dimension:";
+        for (unsigned int dim = 0; dim < shape.size(); dim++) {
+          _results_boundaries << " " << shape[dim];
+        }
+        _results_boundaries << std::endl;
+        _current_lines = _current_lines + output_size;
+        DumpResultTxtFile(tensor, item, output_size, _result_txt_file);
+      }
+    }
+    DumpResultBinFile(tensor, per_batch_results_bin_file);
+
+    if (batch == 0) {
+      // all batches should have the same output info
+      dla_benchmark::OutputInfo output_info;
+      output_info.name = name;
+      output_info.shape = shape;
+      _metadata.model_output_info.push_back(output_info);
+    }
+  }
+  per_batch_results_bin_file.close();
+}
+
+void OutputDumper::finish() {
+  DumpResultMetaJSONFile(_metadata, _result_meta_file);
+  _result_txt_file.close();
+  _results_boundaries.close();
+  _result_meta_file.close();
+}
+
+void OutputReorderBuffer::push(uint32_t batch, const BatchOutputTensors &tensors) {
+  if (batch != _next_batch && !_copy_early_batches) {
+    _pending.emplace(batch, tensors);
+    return;
+  }
+  if (batch != _next_batch) {
+    // The tensors are handed to the next inference as soon as we return, keep a copy until it is this batch's turn
+    BatchOutputTensors copy;
+    for (const auto &item : tensors) {
+      ov::Tensor tensor(item.second.get_element_type(), item.second.get_shape());
+      item.second.copy_to(tensor);
+      copy.emplace(item.first, tensor);
+    }
+    _pending.emplace(batch, std::move(copy));
+    return;
+  }
+
+  _consumer(batch, tensors);
+  _next_batch++;
+  for (auto it = _pending.find(_next_batch); it != _pending.end(); it = _pending.find(_next_batch)) {
+    _consumer(it->first, it->second);
+    _pending.erase(it);
+    _next_batch++;
+  }
+}
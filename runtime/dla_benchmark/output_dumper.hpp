@@ -0,0 +1,83 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Classes that consume the output tensors of dla_benchmark one batch at a time: OutputDumper writes
+//              the result files of a graph and OutputReorderBuffer hands batches to a consumer in iteration order.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+#include "utils.hpp"
+
+/// @brief The output tensors of one batch, keyed by output name
+typedef std::map<std::string, ov::Tensor> BatchOutputTensors;
+
+/// @brief Writes result.txt, result_tensor_boundaries.txt, result_{batch}.bin and result_meta.json of one graph
+class OutputDumper {
+ public:
+  /// @param file_prefix      prepended to each result file name, e.g. "<output_dir>/<topology>_"
+  /// @param topology_name    name of the graph, only used in log messages
+  /// @param output_info      outputs of the graph, sorted in the order they are dumped
+  /// @param metadata         inference arguments written to result_meta.json, model_output_info is filled in here
+  /// @param batch_size       number of images in each output tensor
+  /// @param max_output_file_size  result.txt is not written if it would be larger than this many MB
+  OutputDumper(const std::string &file_prefix,
+               const std::string &topology_name,
+               const std::vector<ov::Output<const ov::Node>> &output_info,
+               const dla_benchmark::InferenceMetaData &metadata,
+               size_t batch_size,
+               size_t max_output_file_size);
+
+  /// Writes the outputs of one batch. Batches must be added in order, starting at 0.
+  void addBatch(uint32_t batch, const BatchOutputTensors &tensors);
+
+  /// Writes result_meta.json and closes all files
+  void finish();
+
+ private:
+  std::vector<ov::Output<const ov::Node>> _output_info;
+  dla_benchmark::InferenceMetaData _metadata;
+  size_t _batch_size;
+  size_t _max_output_file_size;
+
+  std::string _results_bin_file_name;
+  std::ofstream _result_txt_file;
+  std::ofstream _results_boundaries;
+  std::ofstream _result_meta_file;
+
+  // Whether we can dump output tensor in a text file due to unsupported layout. Set during the first batch.
+  bool _can_dump_txt = true;
+  bool _can_dump_layout_info_in_txt = true;
+  uint32_t _current_lines = 1;
+};
+
+/// @brief Passes batches to a consumer in iteration order when the inference requests finish out of order.
+/// A batch that arrives early is deep copied when the caller reuses its tensors for the next inference, otherwise
+/// only its tensor handles are held. With nireq requests in flight at most nireq - 1 batches are held back.
+class OutputReorderBuffer {
+ public:
+  typedef std::function<void(uint32_t batch, const BatchOutputTensors &tensors)> Consumer;
+
+  /// @param copy_early_batches  set when the tensors of a pushed batch are overwritten after push() returns
+  explicit OutputReorderBuffer(Consumer consumer, bool copy_early_batches = true)
+      : _consumer(std::move(consumer)), _copy_early_batches(copy_early_batches) {}
+
+  void push(uint32_t batch, const BatchOutputTensors &tensors);
+
+  /// Number of batches waiting for an earlier batch
+  size_t pending() const { return _pending.size(); }
+
+ private:
+  Consumer _consumer;
+  bool _copy_early_batches;
+  uint32_t _next_batch = 0;
+  std::map<uint32_t, BatchOutputTensors> _pending;
+};
@@ -0,0 +1,207 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: SIMD kernels converting interleaved 8-bit images into normalized planar tensor data.
+//              The instruction set is picked at compile time: AVX2 (with F16C for FP16 output) when the build
+//              targets it, SSE2 on any other x86-64 build, NEON on ARM, scalar code everywhere else.
+
+#include "planar_conversion.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+PlanarConversion::PlanarConversion(size_t num_channels,
+                                   const std::vector<float>& mean_values,
+                                   const std::vector<float>& scale_values,
+                                   bool bgr) {
+  for (size_t c = 0; c < num_channels; c++) {
+    const float scale = c < scale_values.size() ? scale_values[c] : 1.0f;
+    if (scale == 0) {
+      OPENVINO_THROW("Cannot apply scale value of 0");
+    }
+    src_channel.push_back(bgr ? c : (num_channels - c - 1));
+    mean.push_back(c < mean_values.size() ? mean_values[c] : 0.0f);
+    inv_scale.push_back(1.0f / scale);
+  }
+}
+
+namespace {
+
+// Number of pixels each SIMD iteration converts
+constexpr size_t kBlockPixels = 8;
+
+inline void StoreScalar(float* dst, float value) { *dst = value; }
+inline void StoreScalar(ov::float16* dst, float value) { *dst = ov::float16(value); }
+
+#if defined(__AVX2__)
+
+// Loads channel s of 8 consecutive pixels. The gather reads 4 bytes per pixel, the caller makes sure the last
+// 3 bytes past the final pixel are still inside the image.
+inline __m256 LoadBlock(const uint8_t* src, size_t src_channels, size_t s, size_t p) {
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32(static_cast<int>(src_channels)));
+  const __m256i words =
+      _mm256_i32gather_epi32(reinterpret_cast<const int*>(src + p * src_channels + s), offsets, 1);
+  return _mm256_cvtepi32_ps(_mm256_and_si256(words, _mm256_set1_epi32(0xFF)));
+}
+
+inline bool CanLoadBlock(size_t src_channels, size_t s, size_t num_pixels, size_t p) {
+  return (p + kBlockPixels - 1) * src_channels + s + sizeof(int) <= num_pixels * src_channels;
+}
+
+inline __m256 Normalize(__m256 value, float mean, float inv_scale) {
+  return _mm256_mul_ps(_mm256_sub_ps(value, _mm256_set1_ps(mean)), _mm256_set1_ps(inv_scale));
+}
+
+inline void StoreBlock(float* dst, __m256 value) { _mm256_storeu_ps(dst, value); }
+
+inline void StoreBlock(ov::float16* dst, __m256 value) {
+#if defined(__F16C__)
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+  alignas(32) float values[kBlockPixels];
+  _mm256_store_ps(values, value);
+  for (size_t i = 0; i < kBlockPixels; i++) dst[i] = ov::float16(values[i]);
+#endif
+}
+
+#elif defined(__SSE2__)
+
+// Two halves of 4 pixels, SSE2 has no byte shuffles so the strided bytes are collected with scalar loads
+struct Block {
+  __m128 lo;
+  __m128 hi;
+};
+
+inline Block LoadBlock(const uint8_t* src, size_t src_channels, size_t s, size_t p) {
+  const uint8_t* px = src + p * src_channels + s;
+  const size_t n = src_channels;
+  return {_mm_cvtepi32_ps(_mm_setr_epi32(px[0], px[n], px[2 * n], px[3 * n])),
+          _mm_cvtepi32_ps(_mm_setr_epi32(px[4 * n], px[5 * n], px[6 * n], px[7 * n]))};
+}
+
+inline bool CanLoadBlock(size_t, size_t, size_t, size_t) { return true; }
+
+inline Block Normalize(Block value, float mean, float inv_scale) {
+  const __m128 vmean = _mm_set1_ps(mean);
+  const __m128 vinv_scale = _mm_set1_ps(inv_scale);
+  return {_mm_mul_ps(_mm_sub_ps(value.lo, vmean), vinv_scale), _mm_mul_ps(_mm_sub_ps(value.hi, vmean), vinv_scale)};
+}
+
+inline void StoreBlock(float* dst, Block value) {
+  _mm_storeu_ps(dst, value.lo);
+  _mm_storeu_ps(dst + 4, value.hi);
+}
+
+inline void StoreBlock(ov::float16* dst, Block value) {
+#if defined(__F16C__)
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_cvtps_ph(value.lo, _MM_FROUND_TO_NEAREST_INT));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 4), _mm_cvtps_ph(value.hi, _MM_FROUND_TO_NEAREST_INT));
+#else
+  alignas(16) float values[kBlockPixels];
+  _mm_store_ps(values, value.lo);
+  _mm_store_ps(values + 4, value.hi);
+  for (size_t i = 0; i < kBlockPixels; i++) dst[i] = ov::float16(values[i]);
+#endif
+}
+
+#elif defined(__ARM_NEON)
+
+struct Block {
+  float32x4_t lo;
+  float32x4_t hi;
+};
+
+inline Block LoadBlock(const uint8_t* src, size_t src_channels, size_t s, size_t p) {
+  uint8x8_t px;
+  if (src_channels == 3) {
+    // vld3 de-interleaves the RGB triplets of 8 pixels in one instruction
+    px = vld3_u8(src + p * 3).val[s];
+  } else if (src_channels == 1) {
+    px = vld1_u8(src + p);
+  } else {
+    uint8_t bytes[kBlockPixels];
+    for (size_t i = 0; i < kBlockPixels; i++) bytes[i] = src[(p + i) * src_channels + s];
+    px = vld1_u8(bytes);
+  }
+  const uint16x8_t wide = vmovl_u8(px);
+  return {vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide)))};
+}
+
+inline bool CanLoadBlock(size_t, size_t, size_t, size_t) { return true; }
+
+inline Block Normalize(Block value, float mean, float inv_scale) {
+  const float32x4_t vmean = vdupq_n_f32(mean);
+  const float32x4_t vinv_scale = vdupq_n_f32(inv_scale);
+  return {vmulq_f32(vsubq_f32(value.lo, vmean), vinv_scale), vmulq_f32(vsubq_f32(value.hi, vmean), vinv_scale)};
+}
+
+inline void StoreBlock(float* dst, Block value) {
+  vst1q_f32(dst, value.lo);
+  vst1q_f32(dst + 4, value.hi);
+}
+
+inline void StoreBlock(ov::float16* dst, Block value) {
+#if defined(__aarch64__)
+  const float16x8_t half = vcombine_f16(vcvt_f16_f32(value.lo), vcvt_f16_f32(value.hi));
+  vst1q_u16(reinterpret_cast<uint16_t*>(dst), vreinterpretq_u16_f16(half));
+#else
+  float values[kBlockPixels];
+  vst1q_f32(values, value.lo);
+  vst1q_f32(values + 4, value.hi);
+  for (size_t i = 0; i < kBlockPixels; i++) dst[i] = ov::float16(values[i]);
+#endif
+}
+
+#endif
+
+template <typename T>
+void ConvertPlanes(const PlanarConversion& conversion,
+                   const uint8_t* src,
+                   size_t src_channels,
+                   size_t num_pixels,
+                   size_t begin,
+                   size_t end,
+                   T* dst) {
+  for (size_t c = 0; c < conversion.src_channel.size(); c++) {
+    const size_t s = conversion.src_channel[c];
+    const float mean = conversion.mean[c];
+    const float inv_scale = conversion.inv_scale[c];
+    T* plane = dst + c * num_pixels;
+
+    size_t p = begin;
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__ARM_NEON)
+    for (; p + kBlockPixels <= end && CanLoadBlock(src_channels, s, num_pixels, p); p += kBlockPixels) {
+      StoreBlock(plane + p, Normalize(LoadBlock(src, src_channels, s, p), mean, inv_scale));
+    }
+#endif
+    for (; p < end; p++) {
+      StoreScalar(plane + p, (src[p * src_channels + s] - mean) * inv_scale);
+    }
+  }
+}
+
+}  // namespace
+
+void ConvertImageToPlanar(const PlanarConversion& conversion,
+                          const uint8_t* src,
+                          size_t src_channels,
+                          size_t num_pixels,
+                          size_t begin,
+                          size_t end,
+                          float* dst) {
+  ConvertPlanes(conversion, src, src_channels, num_pixels, begin, end, dst);
+}
+
+void ConvertImageToPlanar(const PlanarConversion& conversion,
+                          const uint8_t* src,
+                          size_t src_channels,
+                          size_t num_pixels,
+                          size_t begin,
+                          size_t end,
+                          ov::float16* dst) {
+  ConvertPlanes(conversion, src, src_channels, num_pixels, begin, end, dst);
+}
@@ -0,0 +1,57 @@
+// Copyright (C) 2018-2023 Altera Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Description: Converts interleaved 8-bit images into normalized planar (CHW) FP32 or FP16 tensor data.
+//              Uses SSE2/AVX2(+F16C) on x86 and NEON on ARM when the compiler targets them, scalar code otherwise.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+
+/// @brief Per-plane parameters of ConvertImageToPlanar, computed once per input
+struct PlanarConversion {
+  std::vector<size_t> src_channel;  // source channel of each output plane, this is where the BGR swap happens
+  std::vector<float> mean;          // mean value of each output plane
+  std::vector<float> inv_scale;     // reciprocal of the scale value of each output plane
+
+  /// @param num_channels  number of output planes
+  /// @param mean_values   per plane mean values, missing values are 0
+  /// @param scale_values  per plane scale values, missing values are 1. Throws if one of them is 0.
+  /// @param bgr           if false, plane c is taken from source channel num_channels - 1 - c
+  PlanarConversion(size_t num_channels,
+                   const std::vector<float>& mean_values,
+                   const std::vector<float>& scale_values,
+                   bool bgr);
+};
+
+/**
+ * @brief Writes dst[c * num_pixels + p] = (src[p * src_channels + src_channel[c]] - mean[c]) * inv_scale[c]
+ *        for every output plane c and every pixel p in [begin, end)
+ *
+ * @param conversion    per plane parameters
+ * @param src           interleaved image with src_channels bytes per pixel
+ * @param src_channels  number of interleaved channels of src, may be larger than the number of planes
+ * @param num_pixels    number of pixels in the image, which is the size of one output plane
+ * @param begin         first pixel to convert, lets several threads work on one image
+ * @param end           one past the last pixel to convert
+ * @param dst           first element of the planar output of this image
+ */
+void ConvertImageToPlanar(const PlanarConversion& conversion,
+                          const uint8_t* src,
+                          size_t src_channels,
+                          size_t num_pixels,
+                          size_t begin,
+                          size_t end,
+                          float* dst);
+
+void ConvertImageToPlanar(const PlanarConversion& conversion,
+                          const uint8_t* src,
+                          size_t src_channels,
+                          size_t num_pixels,
+                          size_t begin,
+                          size_t end,
+                          ov::float16* dst);
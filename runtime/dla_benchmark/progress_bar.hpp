@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <samples/console_progress.hpp>
 
@@ -25,6 +26,13 @@ class ProgressBar {
     }
   }
 
+  /// Shows status after the progress from the next update on
+  void setStatus(const std::string& status) {
+    if (_progressEnabled) {
+      _bar->setStatus(status);
+    }
+  }
+
   void finish(size_t num = 0) {
     if (num > 0) {
       addProgress(num);
@@ -5,218 +5,149 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <utility>
 
-class TopResultsAnalyser {
+// Scores images one at a time as their output becomes available. Used by get_top_results and by dla_benchmark,
+// which scores each batch as soon as it completes instead of dumping and re-parsing the outputs of the whole run.
+class TopResultsAccumulator {
  public:
-  static bool get_top_results(const std::string groundtruth_loc, const std::string results_loc, uint32_t batchSize) {
-    // This function loads the output results from a file,
-    // The dla benchmark currently uses the get_top_results(string, vector<float>, uint)
-    // This function is kept as it can be used to assess accuracy post runtime,
-    // although it seems awfully similar to the other version of get_top_results().
-    const std::string accuracy_results_loc = "accuracy_report.txt";
-    std::ofstream accuracy_file(accuracy_results_loc);
-
-    if (!accuracy_file.is_open()) {
+  explicit TopResultsAccumulator(const std::string& groundtruth_loc,
+                                 const std::string& accuracy_results_loc = "accuracy_report.txt")
+      : _groundtruth_loc(groundtruth_loc), _accuracy_file(accuracy_results_loc), _groundtruth_file(groundtruth_loc) {
+    if (!_accuracy_file.is_open()) {
       throw std::invalid_argument("Unable to open accuracy file.");
     }
-
-    std::ifstream groundtruth_file(groundtruth_loc);
-    int groundtruth_lineno = 0;
-
-    if (!groundtruth_file.is_open()) {
+    if (!_groundtruth_file.is_open()) {
       throw std::invalid_argument("Unable to open groundtruth file.");
     }
+  }
 
-    std::ifstream results_file(results_loc);
+  // scores points to the img_output_size outputs of the next image, in the same order as result.txt. This runs on
+  // the submission thread during the measured run, so the per-image lines are only buffered, report() flushes them.
+  void add_image(const float* scores, int img_output_size) {
+    _img_output_size = img_output_size;
+    const int top_n = std::min(5, img_output_size);
+    _accuracy_file << "image " << _num_images << " top 5:\n";
 
-    if (!results_file.is_open()) {
-      throw std::invalid_argument("Unable to open result file.");
+    // Only the top_n best classes get sorted, in O(n log top_n). Ties go to the lower class index, NaN ranks last.
+    const auto score = [scores](int i) {
+      return std::isnan(scores[i]) ? -std::numeric_limits<float>::infinity() : scores[i];
+    };
+    _classes.resize(img_output_size);
+    std::iota(_classes.begin(), _classes.end(), 0);
+    std::partial_sort(_classes.begin(), _classes.begin() + top_n, _classes.end(), [&score](int a, int b) {
+      const float score_a = score(a);
+      const float score_b = score(b);
+      return score_a > score_b || (score_a == score_b && a < b);
+    });
+
+    for (int i = 0; i < top_n; i++) {
+      _accuracy_file << _classes[i] << " : " << scores[_classes[i]] << '\n';
     }
-
-    std::string results_line;
-    std::vector<float> results;
-    while (std::getline(results_file, results_line)) {
-      const float result = std::stof(results_line);
-      results.push_back(result);
+    std::string line;
+    std::getline(_groundtruth_file, line);
+    ++_groundtruth_lineno;
+    int truth;
+    try {
+      truth = std::stoi(line);
+    } catch (const std::invalid_argument& ia) {
+      OPENVINO_THROW("Unable to parse line ", _groundtruth_lineno,
+                      " of the ground truth file ", _groundtruth_loc);
     }
+    _accuracy_file << truth << " : truth\n";
+    _top1_correct_guesses += top_n > 0 && _classes[0] == truth;
 
-    if (results.size() % batchSize != 0) {
-      std::cout << "Results size = " << results.size() << " Batch size = " << batchSize << std::endl;
-      throw std::invalid_argument("Results size is not a multiple of batch size");
-    }
+    // With 5 or fewer classes, the last one does not count towards top-N so the score stays meaningful
+    const auto top_n_end = _classes.begin() + std::max(std::min(top_n, img_output_size - 1), 0);
+    _top5_correct_guesses += std::find(_classes.begin(), top_n_end, truth) != top_n_end;
+    _num_images++;
+  }
 
-    typedef std::pair<uint64_t, float> CatProbPair;
-    const uint64_t img_output_size = results.size() / batchSize;
-    uint32_t top1_correct_guesses = 0;
-    uint32_t top5_correct_guesses = 0;
-    const auto top_n = fmin(5, img_output_size);
-    for (uint32_t img = 0; img < batchSize; img++) {
-      accuracy_file << "image " << img << " top 5:" << std::endl;
-
-      const auto start_addr = img_output_size * img;
-      std::vector<CatProbPair> top5;
-      for (int i = 0; i < top_n; i++) {
-        top5.push_back(std::make_pair(i, results[start_addr + i]));
-      }
-
-      for (uint64_t i = 5; i < img_output_size; i++) {
-        const auto e = results[start_addr + i];
-        auto min_ele = &top5.at(0);
-        for (size_t j = 1; j < top5.size(); j++) {
-          if (top5.at(j).second < min_ele->second) {
-            min_ele = &top5.at(j);
-          }
-        }
-        if (e > min_ele->second) {
-          *min_ele = std::make_pair(i, e);
-        }
-      }
-
-      // sort descending
-      std::sort(
-          top5.begin(), top5.end(), [](const CatProbPair& a, const CatProbPair& b) { return a.second > b.second; });
-      for (const auto& pair : top5) {
-        accuracy_file << pair.first << " : " << pair.second << std::endl;
-      }
-      std::string line;
-      std::getline(groundtruth_file, line);
-      ++groundtruth_lineno;
-      uint64_t truth;
-      try {
-        truth = std::stoi(line);
-      } catch (const std::invalid_argument& ia) {
-        OPENVINO_THROW("Unable to parse line ", groundtruth_lineno,
-                       " of the ground truth file ", groundtruth_loc);
-      }
-      accuracy_file << truth << " : truth" << std::endl;
-      top1_correct_guesses += (top5.at(0).first == truth);
-
-      uint64_t i = 1;
-      for (const auto& guess : top5) {
-        if (guess.first == truth && i < img_output_size) {
-          top5_correct_guesses += 1;
-          break;
-        }
-        i += 1;
-      }
-    }
+  uint32_t num_images() const { return _num_images; }
+
+  // Accuracies of the images scored so far, in percent
+  double top1_accuracy() const { return _num_images ? _top1_correct_guesses * 100.0 / _num_images : 0.0; }
+  double top5_accuracy() const { return _num_images ? _top5_correct_guesses * 100.0 / _num_images : 0.0; }
 
+  // Writes the summary to the accuracy file and stdout
+  bool report() {
     const auto top_n_string = [&](std::ostream& stream, const double correct_guesses, const uint32_t N) {
-      stream << "top" << N << " accuracy: " << (correct_guesses * 100.0) / (batchSize) << " %" << std::endl;
+      stream << "top" << N << " accuracy: " << (correct_guesses * 100.0) / (_num_images) << " %" << std::endl;
     };
 
-    accuracy_file << "====================" << std::endl;
+    _accuracy_file << "====================" << std::endl;
 
-    top_n_string(accuracy_file, top1_correct_guesses, 1);
-    top_n_string(std::cout, top1_correct_guesses, 1);
-    if (2 < img_output_size && img_output_size < 6) {
-      top_n_string(accuracy_file, top5_correct_guesses, img_output_size - 1);
-      top_n_string(std::cout, top5_correct_guesses, img_output_size - 1);
-    } else if (6 <= img_output_size) {
-      top_n_string(accuracy_file, top5_correct_guesses, 5);
-      top_n_string(std::cout, top5_correct_guesses, 5);
+    top_n_string(_accuracy_file, _top1_correct_guesses, 1);
+    top_n_string(std::cout, _top1_correct_guesses, 1);
+    if (2 < _img_output_size && _img_output_size < 6) {
+      top_n_string(_accuracy_file, _top5_correct_guesses, _img_output_size - 1);
+      top_n_string(std::cout, _top5_correct_guesses, _img_output_size - 1);
+    } else if (6 <= _img_output_size) {
+      top_n_string(_accuracy_file, _top5_correct_guesses, 5);
+      top_n_string(std::cout, _top5_correct_guesses, 5);
     }
+    _accuracy_file.flush();
     return true;
   }
 
-  static bool get_top_results(const std::string groundtruth_loc, std::vector<float> results, uint32_t batchSize) {
-    // This function takes the output results directly from runtime in a vector
-    // The dla benchmark currently uses this version of get_top_results
-    const std::string accuracy_results_loc = "accuracy_report.txt";
-    std::ofstream accuracy_file(accuracy_results_loc);
+ private:
+  std::string _groundtruth_loc;
+  std::ofstream _accuracy_file;
+  std::ifstream _groundtruth_file;
+  int _groundtruth_lineno = 0;
+  int _img_output_size = 0;
+  uint32_t _num_images = 0;
+  uint32_t _top1_correct_guesses = 0;
+  uint32_t _top5_correct_guesses = 0;
+  std::vector<int> _classes;  // class indices of the current image, the best ones first
+};
 
-    if (!accuracy_file.is_open()) {
-      throw std::invalid_argument("Unable to open accuracy file.");
-    }
+class TopResultsAnalyser {
+ public:
+  static bool get_top_results(const std::string groundtruth_loc, const std::string results_loc, uint32_t batchSize) {
+    // This function loads the output results from a file, one value per line.
+    // The dla benchmark scores the outputs while they are produced, this function is kept to assess accuracy
+    // post runtime from a result.txt dump.
+    std::ifstream results_file(results_loc);
 
-    std::ifstream groundtruth_file(groundtruth_loc);
-    int groundtruth_lineno = 0;
+    if (!results_file.is_open()) {
+      throw std::invalid_argument("Unable to open result file.");
+    }
 
-    if (!groundtruth_file.is_open()) {
-      throw std::invalid_argument("Unable to open groundtruth file.");
+    std::vector<float> results;
+    float result;
+    while (results_file >> result) {
+      results.push_back(result);
+    }
+    if (!results_file.eof()) {
+      throw std::invalid_argument("Unable to parse value " + std::to_string(results.size() + 1) +
+                                  " of the result file.");
     }
 
+    return get_top_results(groundtruth_loc, std::move(results), batchSize);
+  }
+
+  static bool get_top_results(const std::string groundtruth_loc, std::vector<float> results, uint32_t batchSize) {
+    // This function takes the output results of batchSize images in a vector
     if (results.size() % batchSize != 0) {
       std::cout << "Results size = " << results.size() << " Batch size = " << batchSize << std::endl;
       throw std::invalid_argument("Results size is not a multiple of batch size");
     }
 
-    typedef std::pair<int, float> CatProbPair;
+    TopResultsAccumulator accumulator(groundtruth_loc);
     const int img_output_size = results.size() / batchSize;
-    uint32_t top1_correct_guesses = 0;
-    uint32_t top5_correct_guesses = 0;
-    const auto top_n = fmin(5, img_output_size);
     for (uint32_t img = 0; img < batchSize; img++) {
-      accuracy_file << "image " << img << " top 5:" << std::endl;
-
-      const auto start_addr = img_output_size * img;
-      std::vector<CatProbPair> top5;
-      for (int i = 0; i < top_n; i++) {
-        top5.push_back(std::make_pair(i, results[start_addr + i]));
-      }
-
-      for (int i = 5; i < img_output_size; i++) {
-        const auto e = results[start_addr + i];
-        auto min_ele = &top5.at(0);
-        for (size_t j = 1; j < top5.size(); j++) {
-          if (top5.at(j).second < min_ele->second) {
-            min_ele = &top5.at(j);
-          }
-        }
-        if (e > min_ele->second) {
-          *min_ele = std::make_pair(i, e);
-        }
-      }
-
-      // sort descending
-      std::sort(
-          top5.begin(), top5.end(), [](const CatProbPair& a, const CatProbPair& b) { return a.second > b.second; });
-      for (const auto& pair : top5) {
-        accuracy_file << pair.first << " : " << pair.second << std::endl;
-      }
-      std::string line;
-      std::getline(groundtruth_file, line);
-      ++groundtruth_lineno;
-      int truth;
-      try {
-        truth = std::stoi(line);
-      } catch (const std::invalid_argument& ia) {
-        OPENVINO_THROW("Unable to parse line ", groundtruth_lineno,
-                        " of the ground truth file ", groundtruth_loc);
-      }
-      accuracy_file << truth << " : truth" << std::endl;
-      top1_correct_guesses += top5.at(0).first == truth;
-
-      int i = 1;
-      for (const auto& guess : top5) {
-        if (guess.first == truth && i < img_output_size) {
-          top5_correct_guesses += 1;
-          break;
-        }
-        i += 1;
-      }
+      accumulator.add_image(results.data() + img_output_size * img, img_output_size);
     }
-
-    const auto top_n_string = [&](std::ostream& stream, const double correct_guesses, const uint32_t N) {
-      stream << "top" << N << " accuracy: " << (correct_guesses * 100.0) / (batchSize) << " %" << std::endl;
-    };
-
-    accuracy_file << "====================" << std::endl;
-
-    top_n_string(accuracy_file, top1_correct_guesses, 1);
-    top_n_string(std::cout, top1_correct_guesses, 1);
-    if (2 < img_output_size && img_output_size < 6) {
-      top_n_string(accuracy_file, top5_correct_guesses, img_output_size - 1);
-      top_n_string(std::cout, top5_correct_guesses, img_output_size - 1);
-    } else if (6 <= img_output_size) {
-      top_n_string(accuracy_file, top5_correct_guesses, 5);
-      top_n_string(std::cout, top5_correct_guesses, 5);
-    }
-
-    return true;
+    return accumulator.report();
   }
 };
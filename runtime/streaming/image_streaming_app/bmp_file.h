@@ -35,6 +35,8 @@ class BmpFile {
   BmpFile(const std::string& filename, bool disableExternalLayoutTransform, bool planarBGR);
   std::vector<uint8_t>& GetData() { return _data; }
   uint32_t GetNumPixels() { return (_width * _height); }
+  uint32_t GetWidth() { return _width; }
+  uint32_t GetHeight() { return _height; }
 
  private:
   bool LoadFile(const std::string& filename, bool disableExternalLayoutTransform, bool planarBGR);
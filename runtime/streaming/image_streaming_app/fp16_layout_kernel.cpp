@@ -0,0 +1,169 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#include "fp16_layout_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include "float16.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FP16_LAYOUT_KERNEL_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FP16_LAYOUT_KERNEL_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr uint32_t blockSamples = 8;
+
+// Float16 truncates towards zero. The SIMD paths truncate as well, which only matches Float16 while
+// every sample is below 2^16 in magnitude, where Float16 switches to infinity.
+bool SamplesFitSimd(float shift) {
+  if (!std::isfinite(shift)) return false;
+  float largest = std::max(std::fabs(shift), std::fabs(255.0f + shift));
+  return largest < 65536.0f;
+}
+
+// Converts the samples from first on. The SIMD paths finish their last partial block with it.
+void ConvertScalar(const uint8_t* pPlane,
+                   uint32_t first,
+                   uint32_t count,
+                   float shift,
+                   uint16_t* pDestination,
+                   uint32_t destinationStride) {
+  for (uint32_t i = first; i < count; i++) {
+    pDestination[static_cast<size_t>(i) * destinationStride] = Float16(static_cast<float>(pPlane[i]) + shift);
+  }
+}
+
+inline void StoreBlock(const uint16_t converted[blockSamples], uint16_t* pDestination, uint32_t destinationStride) {
+  for (uint32_t i = 0; i < blockSamples; i++) {
+    pDestination[static_cast<size_t>(i) * destinationStride] = converted[i];
+  }
+}
+
+#ifdef FP16_LAYOUT_KERNEL_X86
+bool CpuHasF16C() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+  return (ecx & bit_F16C) && (ecx & bit_SSE4_1);
+}
+
+__attribute__((target("sse4.1,f16c"))) void ConvertF16C(const uint8_t* pPlane,
+                                                       uint32_t count,
+                                                       float shift,
+                                                       uint16_t* pDestination,
+                                                       uint32_t destinationStride) {
+  alignas(16) uint16_t converted[blockSamples];
+  __m128 shifts = _mm_set1_ps(shift);
+  uint32_t fullBlocksEnd = count - count % blockSamples;
+  for (uint32_t i = 0; i < fullBlocksEnd; i += blockSamples) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pPlane + i));
+    __m128 low = _mm_add_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes)), shifts);
+    __m128 high = _mm_add_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4))), shifts);
+    __m128i halves = _mm_unpacklo_epi64(_mm_cvtps_ph(low, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC),
+                                        _mm_cvtps_ph(high, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    if (destinationStride == 1) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i), halves);
+    } else {
+      _mm_store_si128(reinterpret_cast<__m128i*>(converted), halves);
+      StoreBlock(converted, pDestination + static_cast<size_t>(i) * destinationStride, destinationStride);
+    }
+  }
+  ConvertScalar(pPlane, fullBlocksEnd, count, shift, pDestination, destinationStride);
+}
+#endif
+
+#ifdef FP16_LAYOUT_KERNEL_NEON
+// Truncating FP32 to FP16 conversion of samples below 2^16 in magnitude, done on the bit patterns so that
+// it does not depend on the rounding mode. Normal FP16 results drop the low 13 mantissa bits and rebias
+// the exponent, subnormal ones shift the mantissa with its implicit bit right by 126 - exponent.
+inline uint16x4_t TruncateToFp16(float32x4_t value) {
+  uint32x4_t bits = vreinterpretq_u32_f32(value);
+  uint32x4_t sign = vandq_u32(vshrq_n_u32(bits, 16), vdupq_n_u32(0x8000));
+  uint32x4_t magnitude = vandq_u32(bits, vdupq_n_u32(0x7fffffff));
+  uint32x4_t exponent = vshrq_n_u32(magnitude, 23);
+
+  uint32x4_t normal = vsubq_u32(vshrq_n_u32(magnitude, 13), vdupq_n_u32(112 << 10));
+  uint32x4_t mantissa = vorrq_u32(vandq_u32(magnitude, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x00800000));
+  int32x4_t subnormalShift = vsubq_s32(vreinterpretq_s32_u32(exponent), vdupq_n_s32(126));
+  uint32x4_t subnormal = vshlq_u32(mantissa, subnormalShift);
+
+  uint32x4_t isNormal = vcgeq_u32(exponent, vdupq_n_u32(113));
+  return vmovn_u32(vorrq_u32(vbslq_u32(isNormal, normal, subnormal), sign));
+}
+
+void ConvertNeon(const uint8_t* pPlane,
+                 uint32_t count,
+                 float shift,
+                 uint16_t* pDestination,
+                 uint32_t destinationStride) {
+  uint16_t converted[blockSamples];
+  float32x4_t shifts = vdupq_n_f32(shift);
+  uint32_t fullBlocksEnd = count - count % blockSamples;
+  for (uint32_t i = 0; i < fullBlocksEnd; i += blockSamples) {
+    uint16x8_t samples = vmovl_u8(vld1_u8(pPlane + i));
+    float32x4_t low = vaddq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(samples))), shifts);
+    float32x4_t high = vaddq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(samples))), shifts);
+    uint16x8_t halves = vcombine_u16(TruncateToFp16(low), TruncateToFp16(high));
+    if (destinationStride == 1) {
+      vst1q_u16(pDestination + i, halves);
+    } else {
+      vst1q_u16(converted, halves);
+      StoreBlock(converted, pDestination + static_cast<size_t>(i) * destinationStride, destinationStride);
+    }
+  }
+  ConvertScalar(pPlane, fullBlocksEnd, count, shift, pDestination, destinationStride);
+}
+#endif
+
+}  // namespace
+
+Fp16LayoutKernel::Path Fp16LayoutKernel::SelectPath() {
+#ifdef FP16_LAYOUT_KERNEL_X86
+  static const bool hasF16C = CpuHasF16C();
+  if (hasF16C) return Path::F16C;
+#endif
+#ifdef FP16_LAYOUT_KERNEL_NEON
+  return Path::Neon;
+#endif
+  return Path::Scalar;
+}
+
+void Fp16LayoutKernel::ConvertPlane(const uint8_t* pPlane,
+                                    uint32_t count,
+                                    float shift,
+                                    uint16_t* pDestination,
+                                    uint32_t destinationStride,
+                                    Path path) {
+  if (!SamplesFitSimd(shift)) path = Path::Scalar;
+#ifdef FP16_LAYOUT_KERNEL_X86
+  static const bool hasF16C = CpuHasF16C();
+  if (path == Path::F16C && hasF16C) {
+    ConvertF16C(pPlane, count, shift, pDestination, destinationStride);
+    return;
+  }
+#endif
+#ifdef FP16_LAYOUT_KERNEL_NEON
+  if (path == Path::Neon) {
+    ConvertNeon(pPlane, count, shift, pDestination, destinationStride);
+    return;
+  }
+#endif
+  ConvertScalar(pPlane, 0, count, shift, pDestination, destinationStride);
+}
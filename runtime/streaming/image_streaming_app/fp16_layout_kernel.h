@@ -0,0 +1,39 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Converts a plane of 8 bit samples to FP16 and writes them at a fixed stride, which is how one channel of
+// a planar image lands in the C-vector layout expected by the DLA. Each sample gets the channel's mean
+// shift added and is converted with the same truncating conversion as Float16, in a single pass. The SIMD
+// paths give bit identical results to the scalar path. LayoutPlan calls it once per channel and band of
+// pixels.
+class Fp16LayoutKernel {
+ public:
+  enum class Path { Scalar, F16C, Neon };
+
+  // Fastest path supported by this build and CPU
+  static Path SelectPath();
+
+  // Writes count samples of pPlane to pDestination[0], pDestination[destinationStride], ... A path that is
+  // not supported falls back to the scalar path, as does a shift for which a sample could fall outside the
+  // range where the SIMD conversion matches Float16.
+  static void ConvertPlane(const uint8_t* pPlane,
+                           uint32_t count,
+                           float shift,
+                           uint16_t* pDestination,
+                           uint32_t destinationStride,
+                           Path path = SelectPath());
+};
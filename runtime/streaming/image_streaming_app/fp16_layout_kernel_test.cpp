@@ -0,0 +1,124 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+// Checks that every Fp16LayoutKernel path, and LayoutPlan on top of it, gives the same bits as the
+// original RawImage transform: mean shift and Float16 per sample, then a gather into the C-vector layout
+// with zeroed padding lanes. A path that the build or CPU does not support runs the scalar fallback.
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "float16.h"
+#include "fp16_layout_kernel.h"
+#include "layout_plan.h"
+
+static constexpr uint32_t numChannels = 3;
+
+// The transform as RawImage did it before Fp16LayoutKernel
+static std::vector<uint16_t> Reference(
+    const std::vector<uint8_t>& source, uint32_t width, uint32_t height, uint32_t cVector, const float* shifts) {
+  uint32_t numPixels = width * height;
+  uint32_t numGroups = (numChannels + cVector - 1) / cVector;
+  std::vector<uint16_t> output(static_cast<size_t>(numGroups) * numPixels * cVector, 0);
+  for (uint32_t c = 0; c < numChannels; c++) {
+    for (uint32_t i = 0; i < numPixels; i++) {
+      size_t index = static_cast<size_t>(c / cVector) * numPixels * cVector + static_cast<size_t>(i) * cVector +
+                     c % cVector;
+      output[index] = Float16(static_cast<float>(source[c * numPixels + i]) + shifts[c]);
+    }
+  }
+  return output;
+}
+
+static const char* PathName(Fp16LayoutKernel::Path path) {
+  switch (path) {
+    case Fp16LayoutKernel::Path::Scalar:
+      return "scalar";
+    case Fp16LayoutKernel::Path::F16C:
+      return "F16C";
+    case Fp16LayoutKernel::Path::Neon:
+      return "NEON";
+  }
+  return "?";
+}
+
+int main() {
+  const Fp16LayoutKernel::Path paths[] = {
+      Fp16LayoutKernel::Path::Scalar, Fp16LayoutKernel::Path::F16C, Fp16LayoutKernel::Path::Neon};
+
+  // The last two sets push samples past 2^16, where the SIMD paths fall back to the scalar path
+  const std::vector<std::vector<float>> shiftSets = {{-103.94f, -116.78f, -123.68f},
+                                                     {0.0f, 0.0f, 0.0f},
+                                                     {-103.99997f, -0.5f, 12.25f},
+                                                     {-127.5f, -1e-30f, 3e-6f},
+                                                     {65280.5f, 0.0f, -65535.0f},
+                                                     {70000.0f, 1.0f, -65300.0f}};
+
+  // Odd sizes leave a partial SIMD block at the end of every plane
+  const uint32_t sizes[][2] = {{224, 224}, {13, 7}, {1, 1}};
+
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> byteDistribution(0, 255);
+
+  std::cout << "Selected path: " << PathName(Fp16LayoutKernel::SelectPath()) << "\n";
+
+  uint32_t numChecks = 0;
+  uint32_t numFailures = 0;
+  for (const auto& size : sizes) {
+    uint32_t width = size[0];
+    uint32_t height = size[1];
+    uint32_t numPixels = width * height;
+    std::vector<uint8_t> source(static_cast<size_t>(numChannels) * numPixels);
+    for (auto& sample : source) sample = static_cast<uint8_t>(byteDistribution(generator));
+    // Every sample value at least once
+    for (size_t i = 0; i < source.size() && i < 256; i++) source[i] = static_cast<uint8_t>(i);
+
+    for (const auto& shifts : shiftSets) {
+      for (uint32_t cVector = 3; cVector <= 32; cVector++) {
+        std::vector<uint16_t> expected = Reference(source, width, height, cVector, shifts.data());
+
+        for (auto path : paths) {
+          std::vector<uint16_t> output(expected.size(), 0);
+          for (uint32_t c = 0; c < numChannels; c++) {
+            size_t offset = static_cast<size_t>(c / cVector) * numPixels * cVector + c % cVector;
+            Fp16LayoutKernel::ConvertPlane(
+                &source[c * numPixels], numPixels, shifts[c], &output[offset], cVector, path);
+          }
+          numChecks++;
+          if (output != expected) {
+            numFailures++;
+            std::cout << PathName(path) << " mismatch, " << width << "x" << height << " C-vector " << cVector
+                      << " shifts " << shifts[0] << " " << shifts[1] << " " << shifts[2] << "\n";
+          }
+        }
+
+        // LayoutPlan zeroes the padding lanes itself, start from garbage to check that
+        LayoutPlan::Key key{width, height, numChannels, cVector, LayoutPlan::ElementType::FP16};
+        auto spPlan = LayoutPlan::Get(key);
+        std::vector<uint8_t> planOutput(spPlan->GetOutputSize(), 0xa5);
+        spPlan->Apply(source.data(), shifts.data(), planOutput.data());
+        numChecks++;
+        if ((planOutput.size() != expected.size() * sizeof(uint16_t)) or
+            (std::memcmp(planOutput.data(), expected.data(), planOutput.size()) != 0)) {
+          numFailures++;
+          std::cout << "LayoutPlan mismatch, " << width << "x" << height << " C-vector " << cVector << " shifts "
+                    << shifts[0] << " " << shifts[1] << " " << shifts[2] << "\n";
+        }
+      }
+    }
+  }
+
+  std::cout << numChecks - numFailures << " of " << numChecks << " checks passed\n";
+  return (numFailures == 0) ? 0 : 1;
+}
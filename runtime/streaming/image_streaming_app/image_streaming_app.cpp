@@ -20,6 +20,7 @@
 #include <string>
 #include <thread>
 #include <fcntl.h>
+#include "msgdma_sender.h"
 #include "raw_image.h"
 
 int main(int numParams, char* paramValues[]) {
@@ -49,8 +50,12 @@ ImageStreamingApp::ImageStreamingApp(int numParams, char* paramValues[]) : _comm
   std::string rateStr;
   if (_commandLine.GetOption("rate", rateStr)) _sendRate = std::strtoul(rateStr.c_str(), 0, 0);
 
+  std::string devicePath;
+  if (_commandLine.GetOption("device", devicePath)) _devicePath = devicePath;
+
   _dumpTransformedImages = _commandLine.HaveOption("dump");
   _disableExternalLT = _commandLine.HaveOption("skip_external_transform");
+  _skipReadyWait = _commandLine.HaveOption("skip_ready_wait");
 
   _ltConfiguration._width = GetUintOption("width", 224);
   _ltConfiguration._height = GetUintOption("height", 224);
@@ -73,7 +78,9 @@ void ImageStreamingApp::Run() {
     std::cout << "-images_folder=folder     Location of bitmap files. Defaults to working folder.\n";
     std::cout << "-image=path               Location of a single bitmap file for single inference.\n";
     std::cout << "-send=n                   Number of images to stream. Default is 1 if -image is set, otherwise infinite.\n";
-    std::cout << "-rate=n                   Rate to stream images, in Hz. n is an integer. Default is 30.\n";
+    std::cout << "-rate=n                   Rate to stream images, in Hz. n is an integer. Default is 30, 0 sends as fast as possible.\n";
+    std::cout << "-device=path              Device node to stream to. A FIFO or file can stand in for it. Default is /dev/msgdma_stream0.\n";
+    std::cout << "-skip_ready_wait          Start streaming without waiting for streaming_inference_app to become ready.\n";
     std::cout << "-width=n                  Image width in pixels, default = 224\n";
     std::cout << "-height=n                 Image height in pixels, default = 224\n";
     std::cout << "-c_vector=n               C vector size, default = 32\n";
@@ -99,32 +106,16 @@ void ImageStreamingApp::Run() {
     return;
   }
 
-  if (not WaitForInferenceApp())
+  if (not _skipReadyWait and not WaitForInferenceApp())
     return;
 
-  // Start event signal thread
-  auto sendImageEventThreadCB = [this]() { RunSendImageSignalThread(); };
-  std::thread sendImageEventThread(sendImageEventThreadCB);
-  uint32_t sentCount = 0;
-
-  while (not _shutdownEvent) {
-    // Wait for the send image event
-    _sendNextImageEvent.Wait();
-
-    if (not SendNextImage()) {
-      _shutdownEvent = true;
-      break;
-    }
-    sentCount++;
-
-    if ((_numToSend > 0) and (sentCount >= _numToSend)) {
-      _shutdownEvent = true;
-      break;
-    }
+  MsgDmaSender sender(_devicePath, _images);
+  if (not sender.Open()) {
+    return;
   }
 
-  // Wait for signalling thread to finish
-  sendImageEventThread.join();
+  sender.Run(GetSendPeriodNs(), _numToSend, _shutdownEvent);
+  sender.PrintStatistics();
 }
 
 bool ImageStreamingApp::LoadImageFiles(bool dumpLayoutTransform) {
@@ -174,75 +165,14 @@ bool ImageStreamingApp::LoadImageFiles(bool dumpLayoutTransform) {
   return not _images.empty();
 }
 
-bool ImageStreamingApp::OpenMsgDmaStream() {
-  if (_msgDmaStream) {
-    return true;
+uint64_t ImageStreamingApp::GetSendPeriodNs() {
+  if (_sendRate == 0) {
+    return 0;
   }
-
-  constexpr const char* msgdmaFilename = "/dev/msgdma_stream0";
-  _msgDmaStream = ::fopen(msgdmaFilename, "w+");
-  if (_msgDmaStream == NULL) {
-    std::cout << "Failed to open" << '\n';
-    return false;
-  }
-
-  // Turn off output buffering
-  setvbuf(_msgDmaStream, NULL, _IONBF, 0);
-
-  return true;
-}
-
-void ImageStreamingApp::CloseMsgDmaStream() {
-  if (_msgDmaStream) {
-    ::fclose(_msgDmaStream);
-    _msgDmaStream = nullptr;
-  }
-}
-
-bool ImageStreamingApp::SendNextImage() {
-  size_t nImages = _images.size();
-  if (nImages == 0) {
-    return false;
-  }
-
-  if (not _msgDmaStream) {
-    if (not OpenMsgDmaStream()) {
-      return false;
-    }
-  }
-
-  std::shared_ptr<RawImage> uploadImage = _images[_nextImageIndex];
-
-  // Move to next index for next time
-  _nextImageIndex = (_nextImageIndex + 1) % nImages;
-  _sentCount++;
-
-  char* pBuffer = reinterpret_cast<char*>(uploadImage->GetData());
-  size_t bufferSize = uploadImage->GetSize();
-
-  std::cout << _sentCount << " Send image " << uploadImage->Filename() << " size = " << bufferSize;
-
-  size_t nWritten = ::fwrite(pBuffer, 1, bufferSize, _msgDmaStream);
-  bool ok = (nWritten == bufferSize);
-  if (ok) {
-    std::cout << '\n';
-  } else {
-    std::cout << " failed\n";
-  }
-
-  return ok;
-}
-
-void ImageStreamingApp::RunSendImageSignalThread() {
-  int64_t microSeconds = 1000000 / _sendRate;
   if (_sendRate == 59) {
-    microSeconds = 16683;  // 59.94 Hz
-  }
-
-  while (not _shutdownEvent) {
-    std::this_thread::sleep_for(std::chrono::microseconds(microSeconds));
-    _sendNextImageEvent.Set();
+    return 16683333;  // 59.94 Hz
   }
+  return 1000000000ull / _sendRate;
 }
 
 bool ImageStreamingApp::ProgramLayoutTransform() {
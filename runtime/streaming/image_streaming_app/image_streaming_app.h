@@ -12,39 +12,17 @@
 // License.
 
 #pragma once
-#include <condition_variable>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <string>
 #include <vector>
 #include <semaphore.h>
 #include "ILayoutTransform.h"
 #include "command_line.h"
 
-using namespace std::chrono_literals;
-
 class RawImage;
 
-class Event {
- public:
-  void Wait() {
-    std::unique_lock<std::mutex> lock(_signalMutex);
-    _conditionVariable.wait(lock);
-  }
-
-  void Set() {
-    std::lock_guard<std::mutex> lock(_signalMutex);
-    _conditionVariable.notify_all();
-  }
-
-  bool IsSignalled() {
-    std::unique_lock<std::mutex> lock(_signalMutex);
-    return (_conditionVariable.wait_for(lock, 0ms) != std::cv_status::timeout);
-  }
-
- private:
-  std::mutex _signalMutex;
-  std::condition_variable _conditionVariable;
-};
-
 class ImageStreamingApp {
  public:
   ImageStreamingApp(int numParams, char* paramValues[]);
@@ -52,29 +30,24 @@ class ImageStreamingApp {
 
  private:
   bool ProgramLayoutTransform();
-  bool SendNextImage();
   bool LoadImageFiles(bool dumpLayoutTransform);
-  void RunSendImageSignalThread();
+  uint64_t GetSendPeriodNs();
   static void SigIntHandler(int);
   uint32_t GetUintOption(const char* optionName, uint32_t defaultValue);
   float GetFloatOption(const char* optionName, float defaultValue);
-  bool OpenMsgDmaStream();
-  void CloseMsgDmaStream();
   bool WaitForInferenceApp();
 
   CommandLine _commandLine;
   std::filesystem::path _imageFilesFolder;
   std::string _imageFile;
+  std::string _devicePath = "/dev/msgdma_stream0";
   std::vector<std::shared_ptr<RawImage>> _images;
-  Event _sendNextImageEvent;
   static volatile bool _shutdownEvent;
-  size_t _nextImageIndex = 0;
   uint32_t _numToSend = 0;
   uint32_t _sendRate = 30;
-  uint32_t _sentCount = 0;
   bool _dumpTransformedImages = false;
   bool _runLayoutTransform = false;
   bool _disableExternalLT = false;
-  FILE* _msgDmaStream = nullptr;
+  bool _skipReadyWait = false;
   ILayoutTransform::Configuration _ltConfiguration = {};
 };
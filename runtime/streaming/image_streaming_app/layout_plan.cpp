@@ -0,0 +1,134 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#include "layout_plan.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include "fp16_layout_kernel.h"
+
+// Bands smaller than this are not worth a thread
+static constexpr uint32_t minRowsPerThread = 16;
+
+// Pixels transformed in one go, so that the output lines written for one channel are still cached when the
+// next channel of the same C-vector group is written
+static constexpr size_t pixelsPerTile = 1024;
+
+bool LayoutPlan::Key::operator<(const Key& other) const {
+  return std::tie(_width, _height, _channels, _cVector, _elementType) <
+         std::tie(other._width, other._height, other._channels, other._cVector, other._elementType);
+}
+
+std::shared_ptr<const LayoutPlan> LayoutPlan::Get(const Key& key) {
+  static std::mutex plansMutex;
+  static std::map<Key, std::shared_ptr<const LayoutPlan>> plans;
+
+  std::lock_guard<std::mutex> lock(plansMutex);
+  auto& spPlan = plans[key];
+  if (!spPlan) spPlan.reset(new LayoutPlan(key));
+  return spPlan;
+}
+
+LayoutPlan::LayoutPlan(const Key& key) : _key(key) {
+  if ((key._cVector == 0) or (key._channels == 0)) {
+    throw std::invalid_argument("Layout plan needs at least one channel and a non-zero C vector");
+  }
+
+  _numPixels = static_cast<size_t>(key._width) * key._height;
+  _elementSize = (key._elementType == ElementType::FP16) ? sizeof(uint16_t) : sizeof(float);
+
+  uint32_t numGroups = (key._channels + key._cVector - 1) / key._cVector;
+  size_t groupElements = _numPixels * key._cVector;
+  _outputElements = numGroups * groupElements;
+
+  for (uint32_t c = 0; c < key._channels; c++) {
+    _blocks.push_back({c, c * _numPixels, (c / key._cVector) * groupElements + c % key._cVector});
+  }
+
+  // Only the last group can be partly filled
+  if (key._channels % key._cVector != 0) {
+    _paddedGroupOffsets.push_back((numGroups - 1) * groupElements);
+  }
+}
+
+void LayoutPlan::Apply(const uint8_t* pSource, const float* shifts, uint8_t* pDestination, uint32_t numThreads) const {
+  if (numThreads == 0) numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  numThreads = std::max(std::min(numThreads, _key._height / minRowsPerThread), 1u);
+
+  // Every band writes its own pixels of every group, so the threads never touch the same output
+  uint32_t rowsPerThread = (_key._height + numThreads - 1) / numThreads;
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 1; thread < numThreads; thread++) {
+    uint32_t firstRow = std::min(thread * rowsPerThread, _key._height);
+    uint32_t endRow = std::min(firstRow + rowsPerThread, _key._height);
+    threads.emplace_back(&LayoutPlan::ApplyRows, this, firstRow, endRow, pSource, shifts, pDestination);
+  }
+  ApplyRows(0, std::min(rowsPerThread, _key._height), pSource, shifts, pDestination);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void LayoutPlan::ApplyRows(uint32_t firstRow,
+                           uint32_t endRow,
+                           const uint8_t* pSource,
+                           const float* shifts,
+                           uint8_t* pDestination) const {
+  size_t endPixel = static_cast<size_t>(endRow) * _key._width;
+  for (size_t firstPixel = static_cast<size_t>(firstRow) * _key._width; firstPixel < endPixel;
+       firstPixel += pixelsPerTile) {
+    uint32_t numPixels = static_cast<uint32_t>(std::min(pixelsPerTile, endPixel - firstPixel));
+    if (_key._elementType == ElementType::FP16) {
+      ApplyTile(firstPixel, numPixels, pSource, shifts, reinterpret_cast<uint16_t*>(pDestination));
+    } else {
+      ApplyTile(firstPixel, numPixels, pSource, shifts, reinterpret_cast<float*>(pDestination));
+    }
+  }
+}
+
+void LayoutPlan::ApplyTile(
+    size_t firstPixel, uint32_t numPixels, const uint8_t* pSource, const float* shifts, uint16_t* pDestination) const {
+  uint32_t cVector = _key._cVector;
+  for (size_t groupOffset : _paddedGroupOffsets) {
+    uint16_t* pGroup = pDestination + groupOffset + firstPixel * cVector;
+    std::fill(pGroup, pGroup + static_cast<size_t>(numPixels) * cVector, 0);
+  }
+  for (const Block& block : _blocks) {
+    Fp16LayoutKernel::ConvertPlane(pSource + block._sourceOffset + firstPixel,
+                                   numPixels,
+                                   shifts[block._channel],
+                                   pDestination + block._destinationOffset + firstPixel * cVector,
+                                   cVector);
+  }
+}
+
+void LayoutPlan::ApplyTile(
+    size_t firstPixel, uint32_t numPixels, const uint8_t* pSource, const float* shifts, float* pDestination) const {
+  uint32_t cVector = _key._cVector;
+  for (size_t groupOffset : _paddedGroupOffsets) {
+    float* pGroup = pDestination + groupOffset + firstPixel * cVector;
+    std::fill(pGroup, pGroup + static_cast<size_t>(numPixels) * cVector, 0.0f);
+  }
+  for (const Block& block : _blocks) {
+    const uint8_t* pPlane = pSource + block._sourceOffset + firstPixel;
+    float* pChannel = pDestination + block._destinationOffset + firstPixel * cVector;
+    float shift = shifts[block._channel];
+    for (uint32_t i = 0; i < numPixels; i++) {
+      pChannel[static_cast<size_t>(i) * cVector] = static_cast<float>(pPlane[i]) + shift;
+    }
+  }
+}
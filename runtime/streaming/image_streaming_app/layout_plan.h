@@ -0,0 +1,77 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Precomputed mapping of a planar 8 bit image to the C-vector layout expected by the DLA:
+//
+//   output[(c / cVector) * height * width * cVector + (h * width + w) * cVector + c % cVector]
+//
+// Instead of an index per output element, the plan holds one block per channel, which is copied with the
+// channel's mean shift applied to every cVector-th output element, and the C-vector groups with padding
+// lanes that are zeroed first. Plans are created once per key and shared.
+class LayoutPlan {
+ public:
+  enum class ElementType { FP16, FP32 };
+
+  struct Key {
+    uint32_t _width;
+    uint32_t _height;
+    uint32_t _channels;
+    uint32_t _cVector;
+    ElementType _elementType;
+
+    bool operator<(const Key& other) const;
+  };
+
+  // Returns the plan for key, creating it on first use
+  static std::shared_ptr<const LayoutPlan> Get(const Key& key);
+
+  const Key& GetKey() const { return _key; }
+  size_t GetInputSize() const { return _numPixels * _key._channels; }
+  size_t GetOutputSize() const { return _outputElements * _elementSize; }
+
+  // Transforms GetInputSize() bytes of pSource into GetOutputSize() bytes of pDestination. shifts holds one
+  // mean shift per channel. The rows are split into bands that are transformed on numThreads threads, 0 picks
+  // one per core.
+  void Apply(const uint8_t* pSource, const float* shifts, uint8_t* pDestination, uint32_t numThreads = 0) const;
+
+ private:
+  explicit LayoutPlan(const Key& key);
+  void ApplyRows(uint32_t firstRow,
+                 uint32_t endRow,
+                 const uint8_t* pSource,
+                 const float* shifts,
+                 uint8_t* pDestination) const;
+  void ApplyTile(
+      size_t firstPixel, uint32_t numPixels, const uint8_t* pSource, const float* shifts, uint16_t* pDestination) const;
+  void ApplyTile(
+      size_t firstPixel, uint32_t numPixels, const uint8_t* pSource, const float* shifts, float* pDestination) const;
+
+  struct Block {
+    uint32_t _channel;
+    size_t _sourceOffset;       // first sample of the channel plane
+    size_t _destinationOffset;  // first output element, in elements
+  };
+
+  Key _key;
+  size_t _numPixels;
+  size_t _outputElements;
+  size_t _elementSize;
+  std::vector<Block> _blocks;
+  std::vector<size_t> _paddedGroupOffsets;  // first output element of each C-vector group with padding lanes
+};
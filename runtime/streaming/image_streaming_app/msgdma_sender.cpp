@@ -0,0 +1,210 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#include "msgdma_sender.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include "raw_image.h"
+
+// O_DIRECT transfers need page aligned buffers, so every frame starts on its own page
+static constexpr size_t ringAlignment = 4096;
+static constexpr uint64_t nsPerSecond = 1000000000;
+
+static uint64_t NowNs() {
+  timespec now;
+  ::clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * nsPerSecond + now.tv_nsec;
+}
+
+// Sleeps until the absolute deadline. Returns early only when a signal sets shutdownEvent.
+static void SleepUntil(uint64_t deadlineNs, volatile bool& shutdownEvent) {
+  timespec deadline;
+  deadline.tv_sec = static_cast<time_t>(deadlineNs / nsPerSecond);
+  deadline.tv_nsec = static_cast<long>(deadlineNs % nsPerSecond);
+  while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    if (shutdownEvent) break;
+  }
+}
+
+MsgDmaSender::MsgDmaSender(const std::string& devicePath, const std::vector<std::shared_ptr<RawImage>>& images)
+    : _devicePath(devicePath) {
+  for (const auto& spImage : images) {
+    _frames.push_back({_ringSize, spImage->GetSize(), spImage->Filename()});
+    _ringSize += (spImage->GetSize() + ringAlignment - 1) / ringAlignment * ringAlignment;
+  }
+  if (_ringSize == 0) return;
+
+  void* pRing = ::mmap(nullptr, _ringSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pRing == MAP_FAILED) {
+    std::cout << "Failed to allocate " << _ringSize << " bytes for the frame ring\n";
+    return;
+  }
+  _pRing = static_cast<uint8_t*>(pRing);
+
+  // Keep the frames resident so a send never waits for a page fault
+  if (::mlock(_pRing, _ringSize) != 0) {
+    std::cout << "Could not lock the frame ring in memory (" << std::strerror(errno) << "), continuing unlocked\n";
+  }
+
+  for (size_t i = 0; i < images.size(); i++) {
+    std::memcpy(_pRing + _frames[i]._offset, images[i]->GetData(), _frames[i]._size);
+  }
+}
+
+MsgDmaSender::~MsgDmaSender() {
+  Close();
+  if (_pRing) {
+    ::munmap(_pRing, _ringSize);
+  }
+}
+
+bool MsgDmaSender::Open() {
+  if (_fd >= 0) {
+    return true;
+  }
+
+  if (not _pRing) {
+    std::cout << "No frames to send\n";
+    return false;
+  }
+
+  // Same access as the previous fopen("w+"), so a FIFO or regular file can stand in for the device node.
+  // O_DIRECT would put a FIFO into packet mode, and file systems such as tmpfs refuse it.
+  int flags = O_RDWR | O_CREAT | O_TRUNC;
+  struct stat status;
+  bool isFifo = (::stat(_devicePath.c_str(), &status) == 0) and S_ISFIFO(status.st_mode);
+  if (not isFifo) {
+    _fd = ::open(_devicePath.c_str(), flags | O_DIRECT, 0644);
+    _directIo = (_fd >= 0);
+  }
+  if (_fd < 0) {
+    _fd = ::open(_devicePath.c_str(), flags, 0644);
+  }
+
+  if (_fd < 0) {
+    std::cout << "Failed to open " << _devicePath << ": " << std::strerror(errno) << '\n';
+    return false;
+  }
+
+  return true;
+}
+
+void MsgDmaSender::Close() {
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+}
+
+bool MsgDmaSender::WriteFrame(const Frame& frame) {
+  const uint8_t* pData = _pRing + frame._offset;
+  size_t remaining = frame._size;
+  while (remaining > 0) {
+    ssize_t nWritten = ::write(_fd, pData, remaining);
+    if (nWritten < 0) {
+      if (errno == EINTR) continue;
+
+      // Regular files reject direct transfers that are not a multiple of the block size
+      if ((errno == EINVAL) and _directIo) {
+        ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) & ~O_DIRECT);
+        _directIo = false;
+        continue;
+      }
+      return false;
+    }
+    pData += nWritten;
+    remaining -= nWritten;
+  }
+  return true;
+}
+
+bool MsgDmaSender::Run(uint64_t periodNs, uint32_t numToSend, volatile bool& shutdownEvent) {
+  _statistics = {};
+  if ((_fd < 0) or _frames.empty()) {
+    return false;
+  }
+
+  size_t nextFrame = 0;
+  uint64_t firstStart = 0;
+  uint64_t lastStart = 0;
+  uint64_t totalJitter = 0;
+  uint64_t totalWrite = 0;
+  uint64_t deadline = NowNs();
+  bool ok = true;
+
+  while (not shutdownEvent and ((numToSend == 0) or (_statistics._framesSent < numToSend))) {
+    if (periodNs > 0) {
+      SleepUntil(deadline, shutdownEvent);
+      if (shutdownEvent) break;
+    }
+
+    const Frame& frame = _frames[nextFrame];
+    nextFrame = (nextFrame + 1) % _frames.size();
+
+    uint64_t start = NowNs();
+    ok = WriteFrame(frame);
+    uint64_t end = NowNs();
+    int error = errno;
+
+    std::cout << _statistics._framesSent + 1 << " Send image " << frame._filename << " size = " << frame._size;
+    if (not ok) {
+      std::cout << " failed: " << std::strerror(error) << '\n';
+      break;
+    }
+    std::cout << '\n';
+
+    uint64_t jitter = (periodNs > 0) ? start - deadline : 0;
+    if (_statistics._framesSent == 0) firstStart = start;
+    lastStart = start;
+    totalJitter += jitter;
+    totalWrite += end - start;
+    _statistics._maxJitterUs = std::max(_statistics._maxJitterUs, jitter / 1000.0);
+    _statistics._framesSent++;
+
+    if (periodNs > 0) {
+      deadline += periodNs;
+      if (end > deadline) {
+        _statistics._lateFrames++;
+
+        // Drop the slots that were missed entirely rather than sending a burst to catch up
+        deadline += (end - deadline) / periodNs * periodNs;
+      }
+    }
+  }
+
+  uint32_t framesSent = _statistics._framesSent;
+  if (framesSent > 0) {
+    _statistics._meanJitterUs = totalJitter / 1000.0 / framesSent;
+    _statistics._meanWriteUs = totalWrite / 1000.0 / framesSent;
+  }
+  if ((framesSent > 1) and (lastStart > firstStart)) {
+    _statistics._achievedRate = (framesSent - 1) * static_cast<double>(nsPerSecond) / (lastStart - firstStart);
+  }
+
+  return ok;
+}
+
+void MsgDmaSender::PrintStatistics() const {
+  std::cout << "Sent " << _statistics._framesSent << " images at " << _statistics._achievedRate << " Hz\n";
+  std::cout << "Send jitter: mean " << _statistics._meanJitterUs << " us, max " << _statistics._maxJitterUs
+            << " us\n";
+  std::cout << "Mean write time: " << _statistics._meanWriteUs << " us\n";
+  std::cout << "Late images: " << _statistics._lateFrames << '\n';
+}
@@ -0,0 +1,67 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class RawImage;
+
+// Streams frames to the msgdma device node at a fixed rate. The frames are copied once into a page aligned,
+// locked ring, and each one is sent with a single unbuffered write(), using O_DIRECT where the target
+// supports it. Sends are paced against absolute CLOCK_MONOTONIC deadlines, so scheduling delays of one frame
+// do not shift the ones after it. Any file or FIFO can stand in for the device node.
+class MsgDmaSender {
+ public:
+  struct Statistics {
+    uint32_t _framesSent = 0;
+    uint32_t _lateFrames = 0;    // frames whose write finished after the next deadline
+    double _achievedRate = 0.0;  // frames per second, first to last send
+    double _meanJitterUs = 0.0;  // time from deadline to the start of the write
+    double _maxJitterUs = 0.0;
+    double _meanWriteUs = 0.0;
+  };
+
+  MsgDmaSender(const std::string& devicePath, const std::vector<std::shared_ptr<RawImage>>& images);
+  ~MsgDmaSender();
+
+  bool Open();
+  void Close();
+
+  // Sends numToSend frames, cycling through the ring, or until shutdownEvent is set if numToSend is 0.
+  // periodNs of 0 sends as fast as the device accepts the frames. Returns false if a write fails.
+  bool Run(uint64_t periodNs, uint32_t numToSend, volatile bool& shutdownEvent);
+
+  const Statistics& GetStatistics() const { return _statistics; }
+  void PrintStatistics() const;
+
+ private:
+  struct Frame {
+    size_t _offset;
+    size_t _size;
+    std::string _filename;
+  };
+
+  bool WriteFrame(const Frame& frame);
+
+  std::string _devicePath;
+  std::vector<Frame> _frames;
+  uint8_t* _pRing = nullptr;
+  size_t _ringSize = 0;
+  int _fd = -1;
+  bool _directIo = false;
+  Statistics _statistics;
+};
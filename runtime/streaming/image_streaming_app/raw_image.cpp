@@ -16,13 +16,14 @@
 #include <filesystem>
 #include <fstream>
 
-std::vector<int32_t> RawImage::_indexes;
-
 RawImage::RawImage(std::filesystem::path filePath,
                    bool disableExternalLayoutTransform,
                    bool runLayoutTransform,
                    const ILayoutTransform::Configuration& ltConfiguration)
-    : _filePath(filePath), _disableExternalLayoutTransform(disableExternalLayoutTransform), _ltConfiguration(ltConfiguration) {
+    : _filePath(filePath),
+      _runLayoutTransform(runLayoutTransform),
+      _disableExternalLayoutTransform(disableExternalLayoutTransform),
+      _ltConfiguration(ltConfiguration) {
   std::string extension = filePath.extension();
   std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
   if (extension == ".lt") {
@@ -38,95 +39,55 @@ RawImage::RawImage(std::filesystem::path filePath,
 }
 
 uint8_t* RawImage::GetData() {
-  if (_runLayoutTransform)
+  if (_runLayoutTransform or !_spBmpFile)
     return reinterpret_cast<uint8_t*>(_layoutTransformData.data());
   else
     return _spBmpFile->GetData().data();
 }
 
 size_t RawImage::GetSize() {
-  if (_runLayoutTransform)
+  if (_runLayoutTransform or !_spBmpFile)
     return _layoutTransformData.size() * sizeof(uint16_t);
   else
     return _spBmpFile->GetData().size();
 }
 
-bool RawImage::IsValid()
-{
-    size_t channels = _disableExternalLayoutTransform ? 3 : 4;
-    size_t dlaImageSize = 224 * 224 * channels;
+bool RawImage::IsValid() {
+  // Layout transformed data, either from a .lt file or transformed here, must match the configured shape
+  if (_runLayoutTransform or !_spBmpFile) {
+    auto spPlan = GetLayoutPlan(_ltConfiguration._width, _ltConfiguration._height, _ltConfiguration);
+    return (GetSize() == spPlan->GetOutputSize());
+  }
 
-    return (GetSize() == dlaImageSize);
+  size_t channels = _disableExternalLayoutTransform ? 3 : 4;
+  size_t dlaImageSize = static_cast<size_t>(_ltConfiguration._width) * _ltConfiguration._height * channels;
+  return (GetSize() == dlaImageSize);
 }
 
 std::vector<uint16_t> RawImage::LayoutTransform(uint32_t width,
                                                 uint32_t height,
                                                 const std::vector<uint8_t>& sourceData,
                                                 const ILayoutTransform::Configuration& ltConfiguration) {
-  uint32_t numPixels = width * height;
-  std::vector<uint16_t> layoutTransformData = LayoutTransform(sourceData, numPixels, ltConfiguration);
+  // Subtract the mean values, convert to FP16 and map the data to the layout expected by the DLA in one pass
+  auto spPlan = GetLayoutPlan(width, height, ltConfiguration);
+  if (sourceData.size() < spPlan->GetInputSize()) return {};
+
+  std::vector<uint16_t> layoutTransformData(spPlan->GetOutputSize() / sizeof(uint16_t));
+  const float shifts[3] = {ltConfiguration._blueShift, ltConfiguration._greenShift, ltConfiguration._redShift};
+  spPlan->Apply(sourceData.data(), shifts, reinterpret_cast<uint8_t*>(layoutTransformData.data()));
   return layoutTransformData;
 }
 
 void RawImage::LayoutTransform(const ILayoutTransform::Configuration& ltConfiguration) {
-  const std::vector<uint8_t>& sourceData = _spBmpFile->GetData();
-  uint32_t numPixels = _spBmpFile->GetNumPixels();
-  _layoutTransformData = LayoutTransform(sourceData, numPixels, ltConfiguration);
+  _layoutTransformData =
+      LayoutTransform(_spBmpFile->GetWidth(), _spBmpFile->GetHeight(), _spBmpFile->GetData(), ltConfiguration);
 }
 
-std::vector<uint16_t> RawImage::LayoutTransform(const std::vector<uint8_t>& sourceData,
-                                                uint32_t numPixels,
-                                                const ILayoutTransform::Configuration& ltConfiguration) {
-  if (_indexes.empty()) GenerateLayoutIndexes(ltConfiguration);
-
-  uint32_t numChannels = 3;
-  uint32_t numSamples = numPixels * numChannels;
-
-  std::vector<uint16_t> meanAdjustedData(numSamples);
-  const uint8_t* pSourceData = sourceData.data();
-
-  const uint8_t* pBlueSourcePlane = pSourceData;
-  const uint8_t* pGreenSourcePlane = pBlueSourcePlane + numPixels;
-  const uint8_t* pRedSourcePlane = pGreenSourcePlane + numPixels;
-
-  // First adjust by subtracting the means values
-  std::vector<float> meanAdjustedFloat32(numSamples);
-  float* pBlueFloat32 = &meanAdjustedFloat32[0];
-  float* pGreenFloat32 = pBlueFloat32 + numPixels;
-  float* pRedFloat32 = pGreenFloat32 + numPixels;
-
-  for (uint32_t i = 0; i < numPixels; i++) {
-    *pBlueFloat32++ = static_cast<float>(*pBlueSourcePlane++) + ltConfiguration._blueShift;
-    *pGreenFloat32++ = static_cast<float>(*pGreenSourcePlane++) + ltConfiguration._greenShift;
-    *pRedFloat32++ = static_cast<float>(*pRedSourcePlane++) + ltConfiguration._redShift;
-  }
-
-  pBlueFloat32 = &meanAdjustedFloat32[0];
-  pGreenFloat32 = pBlueFloat32 + numPixels;
-  pRedFloat32 = pGreenFloat32 + numPixels;
-  uint16_t* pBlueDestinationPlane = &meanAdjustedData[0];
-  uint16_t* pGreenDestinationPlane = pBlueDestinationPlane + numPixels;
-  uint16_t* pRedDestinationPlane = pGreenDestinationPlane + numPixels;
-
-  for (uint32_t i = 0; i < numPixels; i++) {
-    *pBlueDestinationPlane++ = Float16(*pBlueFloat32++);
-    *pGreenDestinationPlane++ = Float16(*pGreenFloat32++);
-    *pRedDestinationPlane++ = Float16(*pRedFloat32++);
-  }
-
-  // Now map the data to the layout expected by the DLA
-  size_t nLayoutEntries = _indexes.size();
-  std::vector<uint16_t> layoutTransformData(nLayoutEntries);
-
-  for (size_t outputIndex = 0; outputIndex < nLayoutEntries; outputIndex++) {
-    int32_t inputIndex = _indexes[outputIndex];
-    if (inputIndex >= 0)
-      layoutTransformData[outputIndex] = meanAdjustedData[inputIndex];
-    else
-      layoutTransformData[outputIndex] = 0;
-  }
-
-  return layoutTransformData;
+std::shared_ptr<const LayoutPlan> RawImage::GetLayoutPlan(uint32_t width,
+                                                          uint32_t height,
+                                                          const ILayoutTransform::Configuration& ltConfiguration) {
+  // Planar BGR in, FP16 out
+  return LayoutPlan::Get({width, height, 3, ltConfiguration._cVector, LayoutPlan::ElementType::FP16});
 }
 
 bool RawImage::DumpLayoutTransform() {
@@ -187,42 +148,3 @@ std::vector<uint8_t> RawImage::MakePlanar(uint32_t width, uint32_t height, const
 
   return planarData;
 }
-
-void RawImage::GenerateLayoutIndexes(const ILayoutTransform::Configuration& ltConfiguration) {
-  size_t nEntries = ltConfiguration._width * ltConfiguration._height * ltConfiguration._cVector;
-
-  uint32_t c_vector = ltConfiguration._cVector;
-  uint32_t width_stride = 1;
-  uint32_t height_stride = 1;
-  uint32_t input_width = ltConfiguration._width;
-  uint32_t input_height = ltConfiguration._height;
-  uint32_t input_channels = 3;
-  uint32_t output_width = ltConfiguration._width;
-  uint32_t output_width_banked = ltConfiguration._width;
-  uint32_t output_height = ltConfiguration._height;
-  uint32_t pad_left = 0;
-  uint32_t pad_top = 0;
-
-  _indexes.resize(nEntries, -1);
-
-  for (uint32_t c = 0; c < input_channels; c++) {
-    for (uint32_t h = 0; h < input_height; h++) {
-      for (uint32_t w = 0; w < input_width; w++) {
-        uint32_t output_w = (w + pad_left) / width_stride;
-        uint32_t output_h = (h + pad_top) / height_stride;
-        uint32_t output_d = c * height_stride * width_stride + ((h + pad_top) % height_stride) * width_stride +
-                            (w + pad_left) % width_stride;
-        uint32_t output_d_c_vector = output_d / c_vector;
-        uint32_t cvec = output_d % c_vector;
-        uint32_t inIndex = c * input_height * input_width + h * input_width + w;
-
-        uint32_t outIndex = (output_d_c_vector * output_height * output_width_banked * c_vector) +
-                            (output_h * output_width_banked * c_vector) + (output_w * c_vector) + cvec;
-
-        if ((output_h < output_height) && (output_w < output_width)) {
-          _indexes[outIndex] = static_cast<int32_t>(inIndex);
-        }
-      }
-    }
-  }
-}
@@ -18,7 +18,7 @@
 #include <vector>
 #include "ILayoutTransform.h"
 #include "bmp_file.h"
-#include "float16.h"
+#include "layout_plan.h"
 
 class RawImage {
  public:
@@ -38,16 +38,14 @@ class RawImage {
   bool IsValid();
 
  private:
-  static void GenerateLayoutIndexes(const ILayoutTransform::Configuration& ltConfiguration);
   void LayoutTransform(const ILayoutTransform::Configuration& ltConfiguration);
-  static std::vector<uint16_t> LayoutTransform(const std::vector<uint8_t>& sourceData,
-                                               uint32_t numPixels,
-                                               const ILayoutTransform::Configuration& ltConfiguration);
+  static std::shared_ptr<const LayoutPlan> GetLayoutPlan(uint32_t width,
+                                                         uint32_t height,
+                                                         const ILayoutTransform::Configuration& ltConfiguration);
 
   std::filesystem::path _filePath;
   std::shared_ptr<BmpFile> _spBmpFile;
   std::vector<uint16_t> _layoutTransformData;
-  static std::vector<int32_t> _indexes;
   bool _runLayoutTransform = false;
   bool _disableExternalLayoutTransform = false;
   ILayoutTransform::Configuration _ltConfiguration;
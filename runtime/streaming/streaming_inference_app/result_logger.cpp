@@ -0,0 +1,189 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#include "result_logger.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std::chrono_literals;
+
+ResultLogger::ResultLogger(const std::vector<std::string>& classNames,
+                           std::ostream& resultsStream,
+                           uint32_t numFileResults)
+    : _classNames(classNames), _resultsStream(resultsStream), _numFileResults(numFileResults) {}
+
+ResultLogger::~ResultLogger() { Stop(); }
+
+ResultLogger::Ring* ResultLogger::AddProducer() {
+  _rings.push_back(std::make_unique<Ring>());
+  return _rings.back().get();
+}
+
+void ResultLogger::Start() {
+  _stop = false;
+  _thread = std::thread([this]() { Run(); });
+}
+
+void ResultLogger::Stop() {
+  if (not _thread.joinable()) return;
+
+  _stop = true;
+  _thread.join();
+}
+
+void ResultLogger::CountDropped(uint64_t sequence) {
+  _numDropped++;
+  if (sequence <= _numFileResults) _numFileResultsDropped++;
+}
+
+void ResultLogger::Run() {
+  while (true) {
+    // Read the flag first, so that everything pushed before Stop is written out
+    bool stopping = _stop;
+    bool drained = Drain();
+
+    auto now = std::chrono::steady_clock::now();
+    if ((_window._numResults > 0) and ((now - _window._start >= 1s) or stopping)) {
+      std::ostringstream consoleText;
+      ReportWindow(now, consoleText);
+      std::cout << consoleText.str() << std::flush;
+    }
+
+    if (stopping) break;
+    if (not drained) std::this_thread::sleep_for(1ms);
+  }
+}
+
+/**
+ * Writes out every record in the rings
+ *
+ * The record with the lowest sequence across the rings is written first. The sequence is taken before the push,
+ * so a record can still be overtaken by a later one from another ring and the output is only close to completion
+ * order. The results file capture therefore ends once every sequence up to _numFileResults has been written or
+ * dropped, not at the first later sequence.
+ *
+ * @returns true if there was at least one record
+ */
+bool ResultLogger::Drain() {
+  std::ostringstream consoleText;
+  std::ostringstream fileText;
+  consoleText << std::fixed << std::setprecision(1);
+  fileText << std::fixed << std::setprecision(1);
+  bool drained = false;
+
+  while (true) {
+    Ring* pOldestRing = nullptr;
+    const Record* pOldest = nullptr;
+    for (auto& spRing : _rings) {
+      const Record* pRecord = spRing->Peek();
+      if (pRecord and (not pOldest or (pRecord->_sequence < pOldest->_sequence))) {
+        pOldestRing = spRing.get();
+        pOldest = pRecord;
+      }
+    }
+    if (not pOldest) break;
+
+    if ((_window._numResults > 0) and (pOldest->_completionTime - _window._start >= 1s)) {
+      ReportWindow(pOldest->_completionTime, consoleText);
+    }
+    Write(*pOldest, consoleText, fileText);
+    pOldestRing->Pop();
+    drained = true;
+  }
+
+  // A dropped record is counted after its sequence was taken, so this is checked even when nothing was drained
+  bool flushFile = false;
+  if ((not _fileCaptureDone) and (_numFileResultsWritten + _numFileResultsDropped >= _numFileResults)) {
+    fileText << "End of results capture\n";
+    _fileCaptureDone = true;
+    flushFile = true;
+  }
+
+  if (drained) {
+    std::cout << consoleText.str();
+  }
+  std::string writeFileString = fileText.str();
+  if (not writeFileString.empty()) {
+    _resultsStream << writeFileString;
+    if (flushFile) {
+      _resultsStream << std::endl;
+    }
+  }
+
+  return drained;
+}
+
+/**
+ * Formats one result
+ *
+ * The top score goes to the console, and the top k scores of the first _numFileResults results go to the
+ * results file.
+ */
+void ResultLogger::Write(const Record& record, std::ostream& consoleText, std::ostream& fileText) {
+  if (_window._numResults == 0) _window._start = record._completionTime;
+  _window._numResults++;
+  _window._totalRequestNs += record._requestNs;
+  _window._maxRequestNs = std::max(_window._maxRequestNs, record._requestNs);
+  _window._totalCallbackNs += record._callbackNs;
+  _window._maxCallbackNs = std::max(_window._maxCallbackNs, record._callbackNs);
+
+  if (record._sequence <= _numFileResults) _numFileResultsWritten++;
+
+  if (record._numTop == 0) return;
+
+  consoleText << record._sequence << " - " << ClassName(record._classIndexes[0])
+              << ", score = " << record._scores[0] * 100.0f << '\n';
+
+  if (record._sequence > _numFileResults) return;
+
+  fileText << "Result: image[" << record._sequence << "]\n";
+  for (uint32_t i = 0; i < record._numTop; i++) {
+    fileText << (i + 1) << ". " << ClassName(record._classIndexes[i]) << ", score = " << record._scores[i] * 100.0f
+             << '\n';
+  }
+  fileText << '\n';
+}
+
+void ResultLogger::ReportWindow(std::chrono::steady_clock::time_point endTime, std::ostream& consoleText) {
+  double seconds = std::chrono::duration<double>(endTime - _window._start).count();
+  uint32_t numResults = _window._numResults;
+  uint32_t numDropped = _numDropped;
+
+  std::ios_base::fmtflags flags = consoleText.flags();
+  std::streamsize precision = consoleText.precision();
+  consoleText << std::fixed << std::setprecision(1);
+  if (seconds > 0.0) {
+    consoleText << "Inference rate = " << numResults / seconds << " per second";
+  } else {
+    consoleText << "Inference rate = -";
+  }
+  consoleText << ", request time mean " << _window._totalRequestNs / 1e6 / numResults << " ms max "
+              << _window._maxRequestNs / 1e6 << " ms, callback mean " << _window._totalCallbackNs / 1e3 / numResults
+              << " us max " << _window._maxCallbackNs / 1e3 << " us";
+  if (numDropped != _numReportedDropped) {
+    consoleText << ", " << numDropped - _numReportedDropped << " results not logged";
+    _numReportedDropped = numDropped;
+  }
+  consoleText << '\n';
+  consoleText.flags(flags);
+  consoleText.precision(precision);
+
+  _window = Window();
+}
+
+const std::string& ResultLogger::ClassName(uint32_t classIndex) {
+  static const std::string unknownClass = "Unknown class";
+  return (classIndex < _classNames.size()) ? _classNames[classIndex] : unknownClass;
+}
@@ -0,0 +1,93 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spsc_ring.h"
+
+/**
+ * Formats and writes inference results on a background thread
+ *
+ * Each inference request pushes a fixed size record into its own SpscRing, so the completion callback only
+ * does the top-k selection and a copy. The logger thread prints the top result of every inference to the
+ * console, writes the top k of the first numFileResults inferences to the results stream, and prints the
+ * throughput and latency once per second.
+ */
+class ResultLogger {
+ public:
+  static constexpr uint32_t maxTopK = 10;
+
+  struct Record {
+    uint64_t _sequence;
+    std::chrono::steady_clock::time_point _completionTime;
+    uint64_t _requestNs;   // start_async to completion
+    uint64_t _callbackNs;  // completion callback up to the push
+    uint32_t _numTop;
+    uint32_t _classIndexes[maxTopK];
+    float _scores[maxTopK];
+  };
+
+  using Ring = SpscRing<Record, 256>;
+
+  ResultLogger(const std::vector<std::string>& classNames, std::ostream& resultsStream, uint32_t numFileResults);
+  ~ResultLogger();
+
+  // Adds a ring for one producer. Must be called before Start.
+  Ring* AddProducer();
+  void Start();
+
+  // Writes out everything already pushed, then stops the thread
+  void Stop();
+
+  uint64_t NextSequence() { return _nextSequence++; }
+
+  // Counts a record that was not pushed because its ring was full
+  void CountDropped(uint64_t sequence);
+
+ private:
+  struct Window {
+    std::chrono::steady_clock::time_point _start;
+    uint32_t _numResults = 0;
+    uint64_t _totalRequestNs = 0;
+    uint64_t _maxRequestNs = 0;
+    uint64_t _totalCallbackNs = 0;
+    uint64_t _maxCallbackNs = 0;
+  };
+
+  void Run();
+  bool Drain();
+  void Write(const Record& record, std::ostream& consoleText, std::ostream& fileText);
+  void ReportWindow(std::chrono::steady_clock::time_point endTime, std::ostream& consoleText);
+  const std::string& ClassName(uint32_t classIndex);
+
+  const std::vector<std::string>& _classNames;
+  std::ostream& _resultsStream;
+  uint32_t _numFileResults;
+  std::vector<std::unique_ptr<Ring>> _rings;
+  std::thread _thread;
+  std::atomic<bool> _stop{false};
+  std::atomic<uint64_t> _nextSequence{1};
+  std::atomic<uint32_t> _numDropped{0};
+  std::atomic<uint32_t> _numFileResultsDropped{0};  // Dropped records with a sequence up to _numFileResults
+  uint32_t _numReportedDropped = 0;
+  uint32_t _numFileResultsWritten = 0;
+  bool _fileCaptureDone = false;
+  Window _window;
+};
@@ -0,0 +1,53 @@
+// Copyright 2023 Altera Corporation.
+//
+// This software and the related documents are Altera copyrighted materials,
+// and your use of them is governed by the express license under which they
+// were provided to you ("License"). Unless the License provides otherwise,
+// you may not use, modify, copy, publish, distribute, disclose or transmit
+// this software or the related documents without Altera's prior written
+// permission.
+//
+// This software and the related documents are provided as is, with no express
+// or implied warranties, other than those that are expressly stated in the
+// License.
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Fixed size, lock-free ring for exactly one producer thread and one consumer thread
+ *
+ * The producer never blocks or makes a system call; TryPush fails when the ring is full.
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+  static_assert((Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+ public:
+  // Producer side
+  bool TryPush(const T& item) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == Capacity) return false;
+
+    _items[head & (Capacity - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side, returns the oldest item or nullptr if the ring is empty
+  const T* Peek() const {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+    return &_items[tail & (Capacity - 1)];
+  }
+
+  // Consumer side, releases the item returned by Peek
+  void Pop() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+ private:
+  std::array<T, Capacity> _items;
+  alignas(64) std::atomic<size_t> _head{0};
+  alignas(64) std::atomic<size_t> _tail{0};
+};
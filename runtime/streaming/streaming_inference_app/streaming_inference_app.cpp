@@ -28,7 +28,9 @@ using namespace std::chrono_literals;
 std::ofstream StreamingInferenceApp::_resultsStream("results.txt");
 std::mutex StreamingInferenceApp::_signalMutex;
 std::condition_variable StreamingInferenceApp::_signalConditionVariable;
-std::chrono::time_point<std::chrono::system_clock> StreamingInferenceApp::_startTime;
+
+// The top k results of this many inferences are saved to results.txt
+static constexpr uint32_t numFileResults = 1000;
 
 int main(int numParams, char* paramValues[]) {
   StreamingInferenceApp app(numParams, paramValues);
@@ -81,6 +83,15 @@ void StreamingInferenceApp::Run() {
     return Usage();
   }
 
+  std::string topK;
+  if (_commandLine.GetOption("top_k", topK)) {
+    _topK = std::strtoul(topK.c_str(), nullptr, 0);
+    if ((_topK == 0) or (_topK > ResultLogger::maxTopK)) {
+      std::cout << "-top_k must be between 1 and " << ResultLogger::maxTopK << '\n';
+      return;
+    }
+  }
+
   std::filesystem::path architectureFilename = arch;
   std::filesystem::path compiledModelFilename = model;
 
@@ -118,11 +129,16 @@ void StreamingInferenceApp::Run() {
   const std::string cancelSemaphoreName = importedNetwork.get_property(DLIAPlugin::properties::cancel_semaphore_name.name()).as<std::string>();
   _cancelSemaphoreName = cancelSemaphoreName;
 
+  // Results are formatted and written on the logger's own thread, away from the completion callbacks
+  _spResultLogger = std::make_shared<ResultLogger>(_imageNetClasses, _resultsStream, numFileResults);
+
   for (uint32_t i = 0; i < numStreamingInferenceRequests; i++) {
     auto spInferenceData = std::make_shared<SingleInferenceData>(this, importedNetwork, i);
     _inferences.push_back(spInferenceData);
   }
 
+  _spResultLogger->Start();
+
   // Start the inference requests. Streaming inferences will reschedule
   // themselves when complete
   for (auto& inference : _inferences) {
@@ -149,6 +165,7 @@ void StreamingInferenceApp::Run() {
   }
 
   _inferences.clear();
+  _spResultLogger->Stop();
 }
 
 
@@ -173,11 +190,13 @@ void StreamingInferenceApp::SetReadyForImageStreamSemaphore() {
  */
 void StreamingInferenceApp::Usage() {
   std::cout << "Usage:\n";
-  std::cout << "\tstreaming_inference_app -model=<model> -arch=<arch> -device=<device>\n\n";
+  std::cout << "\tstreaming_inference_app -model=<model> -arch=<arch> -device=<device> [-top_k=<k>]\n\n";
   std::cout << "Where:\n";
   std::cout << "\t<model>    is the compiled model binary file, eg /home/root/resnet-50-tf/RN50_Performance_no_folding.bin\n";
   std::cout << "\t<arch>     is the architecture file, eg /home/root/resnet-50-tf/A10_Performance.arch\n";
   std::cout << "\t<device>   is the OpenVINO device ID, eg HETERO:FPGA or HETERO:FPGA,CPU\n";
+  std::cout << "\t<k>        is the number of top scores saved to results.txt for each image, 1 to "
+            << ResultLogger::maxTopK << ", default 5\n";
 }
 
 
@@ -200,7 +219,6 @@ bool StreamingInferenceApp::CheckFileExists(const std::filesystem::path& filenam
 ////////////
 
 std::atomic<uint32_t> SingleInferenceData::_atomic{0};
-uint32_t SingleInferenceData::_numResults = 0;
 
 SingleInferenceData::SingleInferenceData(StreamingInferenceApp* pApp,
                                          ov::CompiledModel& importedNetwork,
@@ -212,6 +230,8 @@ SingleInferenceData::SingleInferenceData(StreamingInferenceApp* pApp,
   std::string outputName = spOutputInfo.get_node()->get_friendly_name();
 
   _spOutputTensor = CreateOutputTensor(spOutputInfo);
+  _results.resize(_spOutputTensor->get_size());
+  _pResultRing = pApp->_spResultLogger->AddProducer();
 
   // Create an inference request and set its completion callback
   _inferenceRequest = importedNetwork.create_infer_request();
@@ -241,6 +261,7 @@ std::shared_ptr<ov::Tensor> SingleInferenceData::CreateOutputTensor(
 
 void SingleInferenceData::StartAsync() {
   _inferenceCount = _atomic++;
+  _requestStartTime = std::chrono::steady_clock::now();
   _inferenceRequest.start_async();
 }
 
@@ -249,50 +270,22 @@ void SingleInferenceData::Wait() { _inferenceRequest.wait(); }
 void SingleInferenceData::Cancel() { _inferenceRequest.cancel(); }
 
 
-/**
- * Stores the results of an inference
- *
- * The index corresponds to the category of the image, and the score is
- * the confidence level of the image.
- */
-class ResultItem {
- public:
-  uint32_t _index;
-  float _score;
-  bool operator<(const ResultItem& other) { return (_score > other._score); }
-};
-
-
 /**
  * Called when inference request has completed
  *
  * The inference results are floating point numbers consisting of the score for each category.
- * The scores are then sorted and the highest is written to the console. The top 5 scores of the
- * first 1000 images are saved to results.txt.
+ * The top k scores are selected and pushed to the result logger, which writes the highest to the
+ * console and saves the top k scores of the first 1000 images to results.txt. Nothing here blocks,
+ * so a slow console can't hold up the next inference.
  *
  * Set as a callback in SingleInferenceData()
  */
 void SingleInferenceData::ProcessResult() {
+  auto callbackTime = std::chrono::steady_clock::now();
   if (_pApp and _pApp->IsCancelling()) {
     return;
   }
 
-  // Increment the number of inference results that have returned thus far
-  _numResults++;
-
-  // If this is the first returned inference, store the current time to calculate the inference rate
-  if (_numResults == 1) {
-    StreamingInferenceApp::_startTime = std::chrono::system_clock::now();
-  } else if (_numResults == 101) {
-    // The inference rate is calculated afer 100 results have been received
-    auto endTime = std::chrono::system_clock::now();
-    auto duration = endTime - StreamingInferenceApp::_startTime;
-    double durationMS = (double)std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    double durationSecondsOne = durationMS / 100000.0;
-    double rate = 1.0 / durationSecondsOne;
-    std::cout << "Inference rate = " << rate << '\n';
-  }
-
   // Create a float pointer to the returned data
   size_t outputSize = _spOutputTensor->get_size();
   float* pOutputData = _spOutputTensor->data<float>();
@@ -300,55 +293,33 @@ void SingleInferenceData::ProcessResult() {
     return;
   }
 
-  // Store each score as a ResultItem
-  std::vector<ResultItem> results;
+  // Store each score as a ResultItem and move the top k to the front, highest first
   for (size_t i = 0; i < outputSize; i++) {
-    results.push_back({(uint32_t)i, pOutputData[i]});
+    _results[i] = {(uint32_t)i, pOutputData[i]};
   }
-
-  // Sort the scores and set up the output streams
-  std::sort(results.begin(), results.end());
-  std::stringstream fileString;
-  std::stringstream outString;
-  bool flushFile = false;
-
-  // Store the top 5 results of the first 1000 images to be written to a file
-  if (_numResults <= 1000) {
-    fileString << "Result: image[" << _numResults << "]\n";
-    fileString << std::fixed << std::setprecision(1);
-
-    for (size_t i = 0; i < 5; i++) {
-      std::string className = _pApp->_imageNetClasses[results[i]._index];
-      float score = results[i]._score * 100.0f;
-      fileString << (i + 1) << ". " << className << ", score = " << score << '\n';
-    }
-
-    fileString << '\n';
+  uint32_t numTop = static_cast<uint32_t>(std::min<size_t>(_pApp->_topK, outputSize));
+  if (numTop > 0) {
+    std::nth_element(_results.begin(), _results.begin() + (numTop - 1), _results.end());
+    std::sort(_results.begin(), _results.begin() + numTop);
   }
 
-  if (_numResults == 1001) {
-    fileString << "End of results capture\n";
-    flushFile = true;
+  ResultLogger::Record record;
+  record._sequence = _pApp->_spResultLogger->NextSequence();
+  record._completionTime = callbackTime;
+  record._requestNs = std::chrono::duration_cast<std::chrono::nanoseconds>(callbackTime - _requestStartTime).count();
+  record._numTop = numTop;
+  for (uint32_t i = 0; i < numTop; i++) {
+    record._classIndexes[i] = _results[i]._index;
+    record._scores[i] = _results[i]._score;
   }
+  record._callbackNs =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - callbackTime).count();
 
-  // Store the top score to write to the console
-  outString << std::fixed << std::setprecision(1);
-  std::string className = _pApp->_imageNetClasses[results[0]._index];
-  float score = results[0]._score * 100.0f;
-  outString << _numResults << " - " << className << ", score = " << score << '\n';
-
-  // Write the results to the file
-  std::string writeFileString = fileString.str();
-  if (not writeFileString.empty()) {
-    StreamingInferenceApp::_resultsStream << writeFileString;
-    if (flushFile) {
-      StreamingInferenceApp::_resultsStream << std::endl;
-    }
+  // If the logger has fallen behind, the result is counted but not logged
+  if (not _pResultRing->TryPush(record)) {
+    _pApp->_spResultLogger->CountDropped(record._sequence);
   }
 
-  // Write the top score to the console
-  std::cout << outString.str();
-
   // Start again
   StartAsync();
 }
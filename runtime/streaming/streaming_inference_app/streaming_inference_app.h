@@ -14,9 +14,11 @@
 #pragma once
 #include <semaphore.h>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <filesystem>
 #include "command_line.h"
+#include "result_logger.h"
 #include "openvino/runtime/core.hpp"
 
 class SingleInferenceData;
@@ -34,7 +36,6 @@ class StreamingInferenceApp {
 
   static std::mutex _signalMutex;
   static std::condition_variable _signalConditionVariable;
-  static std::chrono::time_point<std::chrono::system_clock> _startTime;
   static std::ofstream _resultsStream;
 
  private:
@@ -50,6 +51,21 @@ class StreamingInferenceApp {
   sem_t* _pReadyForImageStreamSemaphore = nullptr;
   std::string _cancelSemaphoreName;
   std::vector<std::string> _imageNetClasses;
+  std::shared_ptr<ResultLogger> _spResultLogger;
+  uint32_t _topK = 5;
+};
+
+/**
+ * Stores the results of an inference
+ *
+ * The index corresponds to the category of the image, and the score is
+ * the confidence level of the image.
+ */
+class ResultItem {
+ public:
+  uint32_t _index;
+  float _score;
+  bool operator<(const ResultItem& other) const { return (_score > other._score); }
 };
 
 class SingleInferenceData {
@@ -69,6 +85,8 @@ class SingleInferenceData {
   ov::InferRequest _inferenceRequest;
   uint32_t _index;
   uint32_t _inferenceCount;
-  static uint32_t _numResults;
+  std::vector<ResultItem> _results;
+  ResultLogger::Ring* _pResultRing;
+  std::chrono::steady_clock::time_point _requestStartTime;
   static std::atomic<uint32_t> _atomic;
 };